@@ -3,10 +3,13 @@ import pandas as pd
 import polars as pl
 import numpy as np
 import time
+from read_binary_trace import read_events
+from read_trajectory import is_trajectory, read_positions
 
-def get_reception_rate(events, positions):
+def get_reception_rate(events, positions, sampled=True):
     event_times = events['timestamp'].unique()
-    positions = positions.groupby('nodeId').apply(lambda group: pl.concat([group, pl.DataFrame(event_times)], how="diagonal").sort('timestamp').interpolate())
+    if sampled:
+        positions = positions.groupby('nodeId').apply(lambda group: pl.concat([group, pl.DataFrame(event_times)], how="diagonal").sort('timestamp').interpolate())
     positions = positions.filter(~pl.col('pos_x').is_null() & pl.col('timestamp').is_in(event_times))
     events = events.join(positions, how='inner', on=['nodeId','timestamp'])
     sent_events = events.filter(pl.col('eventType') == "PktSent")
@@ -34,10 +37,11 @@ def get_reception_rate(events, positions):
 
     return (reception_rates, pos_x, pos_y)
 
-def get_peak_aoi_by_distance(events, positions):
+def get_peak_aoi_by_distance(events, positions, sampled=True):
     events = events[events['timestamp'] >= 5.0]
     event_times = events.loc[:,['timestamp']].drop_duplicates()
-    positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: pd.concat([group, event_times]).sort_values('timestamp').reset_index(drop=True).interpolate())
+    if sampled:
+        positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: pd.concat([group, event_times]).sort_values('timestamp').reset_index(drop=True).interpolate())
     events = pd.merge(events, positions, how='inner', on=['nodeId','timestamp'])
     send_events = events.query('eventType == "PktSent"')
     nodeIds = np.sort(events['nodeId'].unique())
@@ -64,14 +68,22 @@ def get_peak_aoi_by_distance(events, positions):
 
 def main(v, event_log, position_log):
 
-    events = pd.read_csv(f'./res/v{v}/{event_log}.csv')
-    positions = pd.read_csv(f'./res/v{v}/{position_log}.csv')
+    events = read_events(f'./res/v{v}/{event_log}')
+    # Trajectory logs give the exact positions at the event times, sampled course logs are interpolated
+    sampled = not is_trajectory(f'./res/v{v}/{position_log}.csv')
+    positions = read_positions(f'./res/v{v}/{position_log}.csv', events['timestamp'].unique())
 
-    (peak_aoi, enhanced_events) = get_peak_aoi_by_distance(events, positions)
+    (peak_aoi, enhanced_events) = get_peak_aoi_by_distance(events, positions, sampled)
 
-    events = pl.read_csv(f'./res/v{v}/{event_log}.csv')
-    positions = pl.read_csv(f'./res/v{v}/{position_log}.csv', dtypes = [pl.Float64, pl.Int64, pl.Float32, pl.Float32, pl.Float32])
-    (reception_rates, pos_x, pos_y) = get_reception_rate(events, positions)
+    events = pl.from_pandas(events)
+    positions = pl.from_pandas(positions.loc[:, ['timestamp', 'nodeId', 'pos_x', 'pos_y', 'pos_z']]).with_columns([
+        pl.col('timestamp').cast(pl.Float64),
+        pl.col('nodeId').cast(pl.Int64),
+        pl.col('pos_x').cast(pl.Float32),
+        pl.col('pos_y').cast(pl.Float32),
+        pl.col('pos_z').cast(pl.Float32),
+    ])
+    (reception_rates, pos_x, pos_y) = get_reception_rate(events, positions, sampled)
     loss_rate = pd.DataFrame({
         'pos_x': pos_x,
         'pos_y': pos_y,
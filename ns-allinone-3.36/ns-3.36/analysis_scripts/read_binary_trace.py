@@ -0,0 +1,84 @@
+import sys, os
+import mmap
+import numpy as np
+import pandas as pd
+import time
+
+# Reader for the binary columnar event traces written by scratch/BinaryTraceLogger.h
+
+MAGIC = b'FLDTRC01'
+EVENT_TYPES = ['PktRcvd', 'PktSent', 'PktFwd']
+
+
+def _align(offset):
+    return (offset + 7) // 8 * 8
+
+
+def load_trace(path):
+    """Memory-map a binary trace and return a dict of numpy arrays, one per column."""
+    with open(path, 'rb') as f:
+        buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+    if buf[:8] != MAGIC:
+        raise ValueError(f'{path} is not a binary event trace')
+    schema_length = int(np.frombuffer(buf, dtype=np.uint32, count=1, offset=8)[0])
+    schema = buf[12:12 + schema_length].decode()
+    columns = [(name, np.dtype(dtype)) for name, dtype in (c.split(':') for c in schema.split(','))]
+
+    blocks = {name: [] for name, _ in columns}
+    offset = _align(12 + schema_length)
+    while offset < len(buf):
+        num_rows = int(np.frombuffer(buf, dtype=np.uint32, count=1, offset=offset)[0])
+        offset += 8
+        for name, dtype in columns:
+            # Views into the mapped file, nothing is copied until the blocks are joined
+            blocks[name].append(np.frombuffer(buf, dtype=dtype, count=num_rows, offset=offset))
+            offset += num_rows * dtype.itemsize
+        offset = _align(offset)
+
+    data = {}
+    for name, dtype in columns:
+        if len(blocks[name]) == 1:
+            data[name] = blocks[name][0]
+        elif len(blocks[name]) == 0:
+            data[name] = np.empty(0, dtype=dtype)
+        else:
+            data[name] = np.concatenate(blocks[name])
+    return data
+
+
+def to_dataframe(data):
+    """Convert a loaded trace to a DataFrame with the columns of the CSV event logs."""
+    return pd.DataFrame({
+        'timestamp': data['timestamp'] / 1e9,
+        'nodeId': data['nodeId'].astype(np.int64),
+        'seqNo': pd.Series(data['src']).astype(str) + '-' + pd.Series(data['seq']).astype(str),
+        'eventType': np.array(EVENT_TYPES)[data['eventType']],
+        'src': data['src'].astype(np.int64),
+        'lastHop': data['lastHop'].astype(np.int64),
+        'delay': data['delay'],
+        'numHops': data['numHops'].astype(np.int64),
+    })
+
+
+def read_events(path_without_extension):
+    """Read an event log, preferring the binary trace over the CSV one."""
+    if os.path.isfile(f'{path_without_extension}.bin'):
+        return to_dataframe(load_trace(f'{path_without_extension}.bin'))
+    return pd.read_csv(f'{path_without_extension}.csv')
+
+
+if __name__ == "__main__":
+    # Usage python3 read_binary_trace.py <trace.bin> <out.csv|out.npz>
+    start_time = time.time()
+    trace_file = sys.argv[1]
+    out_file = sys.argv[2]
+
+    data = load_trace(trace_file)
+    if out_file.endswith('.npz'):
+        np.savez_compressed(out_file, **data)
+    else:
+        to_dataframe(data).to_csv(out_file, index=False)
+
+    duration = time.time() - start_time
+    print(f'Converted {len(data["timestamp"])} events. Duration: {duration}')
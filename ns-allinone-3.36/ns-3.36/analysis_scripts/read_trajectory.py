@@ -0,0 +1,65 @@
+import sys
+import numpy as np
+import pandas as pd
+import time
+
+# Reader for the piecewise-linear trajectories written by scratch/TrajectoryLogger.h
+
+
+def is_trajectory(path):
+    """Whether a course log holds trajectory segments rather than position samples."""
+    with open(path) as f:
+        return 'vel_x' in f.readline().split(',')
+
+
+def load_trajectory(path):
+    """Load the segments of a trajectory file, sorted by node and start time."""
+    segments = pd.read_csv(path, dtype={'timestamp_ns': np.int64, 'nodeId': np.int64})
+    # A stable sort keeps the last of the rows of a node with equal timestamps last
+    return segments.sort_values(['nodeId', 'timestamp_ns'], kind='stable').reset_index(drop=True)
+
+
+def positions_at(segments, timestamps):
+    """Positions of every node at the given times (s), with the columns of the sampled course logs.
+
+    Times before the first segment of a node have no position and are left out.
+    """
+    times_ns = np.round(np.asarray(timestamps, dtype=np.float64) * 1e9).astype(np.int64)
+    frames = []
+    for node_id, group in segments.groupby('nodeId', sort=False):
+        start = group['timestamp_ns'].to_numpy()
+        # Index of the last segment starting at or before each time
+        index = np.searchsorted(start, times_ns, side='right') - 1
+        valid = index >= 0
+        index = index[valid]
+        elapsed = (times_ns[valid] - start[index]) / 1e9
+        frame = {'timestamp': np.asarray(timestamps, dtype=np.float64)[valid], 'nodeId': node_id}
+        for axis in ('x', 'y', 'z'):
+            frame[f'pos_{axis}'] = group[f'pos_{axis}'].to_numpy()[index] + group[f'vel_{axis}'].to_numpy()[index] * elapsed
+        frames.append(pd.DataFrame(frame))
+    if not frames:
+        return pd.DataFrame(columns=['timestamp', 'nodeId', 'pos_x', 'pos_y', 'pos_z'])
+    return pd.concat(frames, ignore_index=True)
+
+
+def read_positions(path, timestamps):
+    """Positions of every node at the given times, from a trajectory or a sampled course log."""
+    if is_trajectory(path):
+        return positions_at(load_trajectory(path), timestamps)
+    return pd.read_csv(path)
+
+
+if __name__ == "__main__":
+    # Usage python3 read_trajectory.py <course.csv> <out.csv> <interval s>
+    start_time = time.time()
+    course_file = sys.argv[1]
+    out_file = sys.argv[2]
+    interval = float(sys.argv[3])
+
+    segments = load_trajectory(course_file)
+    end = segments['timestamp_ns'].max() / 1e9
+    positions = positions_at(segments, np.arange(0, end + interval, interval))
+    positions.to_csv(out_file, index=False)
+
+    duration = time.time() - start_time
+    print(f'Sampled {len(segments)} segments. Duration: {duration}')
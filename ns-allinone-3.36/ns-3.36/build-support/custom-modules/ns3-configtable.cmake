@@ -131,6 +131,9 @@ macro(write_configtable)
   string(APPEND out "Emulation FdNetDevice         : ")
   check_on_or_off("${ENABLE_EMU}" "${ENABLE_EMUNETDEV}")
 
+  string(APPEND out "EventPool event allocation    : ")
+  check_on_or_off("${NS3_EVENT_POOL}" "${NS3_EVENT_POOL}")
+
   string(APPEND out "Examples                      : ")
   check_on_or_off("${ENABLE_EXAMPLES}" "${ENABLE_EXAMPLES}")
 
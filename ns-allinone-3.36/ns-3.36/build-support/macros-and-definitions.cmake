@@ -508,6 +508,10 @@ macro(process_options)
     add_definitions(-DENABLE_DES_METRICS)
   endif()
 
+  if(${NS3_EVENT_POOL})
+    add_definitions(-DENABLE_EVENT_POOL)
+  endif()
+
   if(${NS3_SANITIZE} AND ${NS3_SANITIZE_MEMORY})
     message(
       FATAL_ERROR
@@ -1,3 +1,4 @@
+import sys
 import numpy as np
 import pandas as pd
 import marshal, json
@@ -13,6 +14,9 @@ from IPython.display import set_matplotlib_formats
 from IPython.display import Image
 import matplotlib_inline.backend_inline
 
+sys.path.append('../analysis_scripts')
+from read_trajectory import is_trajectory, read_positions
+
 matplotlib_inline.backend_inline.set_matplotlib_formats('svg')
 plt.rcParams.update({
     'font.family': 'serif',
@@ -35,10 +39,15 @@ p = 50
 q = 200
 r = 0
 
-def get_peak_aoi_by_distance(events, positions):
+def load_positions(path, events):
+    # Trajectory logs give the exact positions at the event times, sampled course logs are interpolated
+    return read_positions(path, events['timestamp'].unique()), not is_trajectory(path)
+
+def get_peak_aoi_by_distance(events, positions, sampled=True):
     events = events[events['timestamp'] >= 5.0]
-    event_times = events.loc[:,['timestamp']].drop_duplicates()
-    positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: pd.concat([group, event_times]).sort_values('timestamp').reset_index(drop=True).interpolate())
+    if sampled:
+        event_times = events.loc[:,['timestamp']].drop_duplicates()
+        positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: pd.concat([group, event_times]).sort_values('timestamp').reset_index(drop=True).interpolate())
     events = pd.merge(events, positions, how='inner', on=['nodeId','timestamp'])
     send_events = events.query('eventType == "PktSent"')
     nodeIds = np.sort(events['nodeId'].unique())
@@ -64,18 +73,18 @@ def get_peak_aoi_by_distance(events, positions):
     return peak_aoi
 
 rdf_events = pd.read_csv(f'../res/v{v}/rdf_n{n}_i{i_rdf}_q{q}_r{r}.csv')
-rdf_positions = pd.read_csv(f'../res/v{v}/course_rdf_n{n}_i{i_rdf}_q{q}_r{r}.csv')
+(rdf_positions, rdf_sampled) = load_positions(f'../res/v{v}/course_rdf_n{n}_i{i_rdf}_q{q}_r{r}.csv', rdf_events)
 sf_events = pd.read_csv(f'../res/v{v}/sf_n{n}_i{i_sf}_p{p}_r{r}.csv')
-sf_positions = pd.read_csv(f'../res/v{v}/course_sf_n{n}_i{i_sf}_p{p}_r{r}.csv')
+(sf_positions, sf_sampled) = load_positions(f'../res/v{v}/course_sf_n{n}_i{i_sf}_p{p}_r{r}.csv', sf_events)
 cbf_events = pd.read_csv(f'../res/v{v}/rdf_n{n}_i{i_cbf}_q0_r{r}.csv')
-cbf_positions = pd.read_csv(f'../res/v{v}/course_rdf_n{n}_i{i_cbf}_q0_r{r}.csv')
+(cbf_positions, cbf_sampled) = load_positions(f'../res/v{v}/course_rdf_n{n}_i{i_cbf}_q0_r{r}.csv', cbf_events)
 pf_events = pd.read_csv(f'../res/v{v}/sf_n{n}_i{i_pf}_p100_r{r}.csv')
-pf_positions = pd.read_csv(f'../res/v{v}/course_sf_n{n}_i{i_pf}_p100_r{r}.csv')
+(pf_positions, pf_sampled) = load_positions(f'../res/v{v}/course_sf_n{n}_i{i_pf}_p100_r{r}.csv', pf_events)
 
-peak_aoi_rdf = get_peak_aoi_by_distance(rdf_events, rdf_positions)
-peak_aoi_sf = get_peak_aoi_by_distance(sf_events, sf_positions)
-peak_aoi_cbf = get_peak_aoi_by_distance(cbf_events, cbf_positions)
-peak_aoi_pf = get_peak_aoi_by_distance(pf_events, pf_positions)
+peak_aoi_rdf = get_peak_aoi_by_distance(rdf_events, rdf_positions, rdf_sampled)
+peak_aoi_sf = get_peak_aoi_by_distance(sf_events, sf_positions, sf_sampled)
+peak_aoi_cbf = get_peak_aoi_by_distance(cbf_events, cbf_positions, cbf_sampled)
+peak_aoi_pf = get_peak_aoi_by_distance(pf_events, pf_positions, pf_sampled)
 
 peak_aoi_rdf.to_csv(f'../res/v{v}_parsed/peak_aoi_rdf.csv')
 peak_aoi_cbf.to_csv(f'../res/v{v}_parsed/peak_aoi_cbf.csv')
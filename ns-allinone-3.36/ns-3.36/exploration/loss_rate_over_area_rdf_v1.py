@@ -1,3 +1,4 @@
+import sys
 import numpy as np
 import pandas as pd
 import marshal, json
@@ -13,6 +14,9 @@ from IPython.display import set_matplotlib_formats
 from IPython.display import Image
 import matplotlib_inline.backend_inline
 
+sys.path.append('../analysis_scripts')
+from read_trajectory import is_trajectory, read_positions
+
 matplotlib_inline.backend_inline.set_matplotlib_formats('svg')
 plt.rcParams.update({
     'font.family': 'serif',
@@ -43,7 +47,7 @@ def get_num_possible_receivers(row, positions):
     # print(row['num_receivers'] / (len(valid_positions) -1) ,len(positions), len(positions_now), row['num_receivers'], len(valid_positions) -1, row['seqNo'])
     return len(valid_positions)
 
-def get_augmented_events(nodeId, events, positions):
+def get_augmented_events(nodeId, events, positions, sampled=True):
     events = events[events['timestamp'] >= 5.0]
     events = events.query(f'nodeId == {nodeId} | src == {nodeId}')
 
@@ -54,8 +58,9 @@ def get_augmented_events(nodeId, events, positions):
     # positions = pd.concat([positions, event_positions]).sort_values('timestamp').reset_index(drop=True).drop_duplicates()
     # positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: group.interpolate())
     
-    event_times = events.loc[:,['timestamp']].drop_duplicates()
-    positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: pd.concat([group, event_times]).sort_values('timestamp').reset_index(drop=True).interpolate())
+    if sampled:
+        event_times = events.loc[:,['timestamp']].drop_duplicates()
+        positions = positions.groupby('nodeId', group_keys=False).apply(lambda group: pd.concat([group, event_times]).sort_values('timestamp').reset_index(drop=True).interpolate())
     
     if len(events) * len(positions) == 0:
         return pd.DataFrame([])
@@ -74,10 +79,13 @@ def get_augmented_events(nodeId, events, positions):
 parsed_sent_events = pd.DataFrame([])
 for r in range(10):
     rdf_events = pd.read_csv(f'../res/v{v}/rdf_n{n}_i{i_rdf}_q{q}_r{r}.csv')
-    rdf_positions = pd.read_csv(f'../res/v{v}/course_rdf_n{n}_i{i_rdf}_q{q}_r{r}.csv')
+    # Trajectory logs give the exact positions at the event times, sampled course logs are interpolated
+    course_file = f'../res/v{v}/course_rdf_n{n}_i{i_rdf}_q{q}_r{r}.csv'
+    rdf_sampled = not is_trajectory(course_file)
+    rdf_positions = read_positions(course_file, rdf_events['timestamp'].unique())
 
     for i in range(1, n):
-        parsed_sent_events = pd.concat([parsed_sent_events, get_augmented_events(i, rdf_events.copy(), rdf_positions.copy())])
+        parsed_sent_events = pd.concat([parsed_sent_events, get_augmented_events(i, rdf_events.copy(), rdf_positions.copy(), rdf_sampled)])
         print(r, i, len(parsed_sent_events))
 
     parsed_sent_events.to_csv(f'../res/v{v}_parsed/rdf_n{n}_i{i_rdf}_q{q}.csv')
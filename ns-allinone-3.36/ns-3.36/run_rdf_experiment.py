@@ -21,7 +21,24 @@ def get_params(run_idx = 0):
         return None
     return params[run_idx]
 
+def write_grid(file_name):
+    # Writes all parameter points for scratch/rdf-sweep.cc
+    with open(file_name, 'w') as f:
+        f.write('run,numNodes,interval,q\n')
+        run_idx = 0
+        while True:
+            params = get_params(run_idx)
+            if params == None:
+                break
+            f.write(f"{params['run']},{params['num_nodes']},{params['send_interval']},{params['q']}\n")
+            run_idx += 1
+
 if __name__ == '__main__':
+    if sys.argv[1] == 'grid':
+        # Usage python3 run_rdf_experiment.py grid <grid.csv>
+        write_grid(sys.argv[2])
+        sys.exit(0)
+
     run_command = 'rate-decay-flooding' 
     run_idx = int(sys.argv[1])
     offset = int(sys.argv[2])
@@ -0,0 +1,156 @@
+#ifndef BINARYTRACELOGGER_H
+#define BINARYTRACELOGGER_H
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace std;
+
+/*
+ * Buffered writer for packet event traces in a binary columnar format.
+ *
+ * Events are collected in memory and written in blocks of blockSize rows.
+ * Every block stores its columns one after the other, so a reader can map
+ * the file and view each column of a block as a typed array without parsing.
+ * analysis_scripts/read_binary_trace.py loads and converts these files.
+ *
+ * Layout (native byte order, all sections 8 byte aligned):
+ *   file header:  char magic[8] = "FLDTRC01", uint32 schemaLength, char schema[schemaLength], padding
+ *   block:        uint32 numRows, uint32 reserved, then one array of numRows values per column
+ * The schema is a comma separated list of name:type pairs in column order,
+ * with types in numpy notation (i8, f8, u4, u1).
+ */
+class BinaryTraceLogger {
+public:
+  enum EventType : uint8_t {
+    PKT_RCVD = 0,
+    PKT_SENT = 1,
+    PKT_FWD = 2
+  };
+
+  BinaryTraceLogger (uint32_t blockSize = 65536);
+
+  BinaryTraceLogger (std::string file, uint32_t blockSize = 65536);
+
+  ~BinaryTraceLogger ();
+
+  void SetFile(std::string file);
+
+  void CreateEntry (uint32_t nodeId, uint32_t src, uint32_t seq, EventType eventType, uint32_t lastHop, double delay, uint32_t numHops);
+
+  void Flush ();
+
+private:
+  template <typename T>
+  void WriteColumn (const std::vector<T> &column);
+
+  void WritePadding ();
+
+  std::ofstream outputFile;
+
+  uint32_t blockSize;
+  uint64_t bytesWritten = 0;
+
+  // Columns of the current block, widest types first to keep them aligned
+  std::vector<int64_t> timestamp; // ns
+  std::vector<double> delay;      // ms, -1 for sent packets
+  std::vector<uint32_t> nodeId;
+  std::vector<uint32_t> src;
+  std::vector<uint32_t> seq;
+  std::vector<uint32_t> lastHop;
+  std::vector<uint32_t> numHops;
+  std::vector<uint8_t> eventType;
+};
+
+BinaryTraceLogger::BinaryTraceLogger (uint32_t blockSize) : outputFile(), blockSize(blockSize) {
+};
+
+BinaryTraceLogger::BinaryTraceLogger (std::string file, uint32_t blockSize) : outputFile(), blockSize(blockSize) {
+  SetFile(file);
+};
+
+BinaryTraceLogger::~BinaryTraceLogger () {
+  Flush();
+}
+
+void BinaryTraceLogger::SetFile(std::string file) {
+  outputFile.open(file, std::ios::binary);
+  bytesWritten = 0;
+
+  const std::string schema = "timestamp:i8,delay:f8,nodeId:u4,src:u4,seq:u4,lastHop:u4,numHops:u4,eventType:u1";
+  uint32_t schemaLength = schema.size();
+  outputFile.write("FLDTRC01", 8);
+  outputFile.write(reinterpret_cast<const char *>(&schemaLength), sizeof(schemaLength));
+  outputFile.write(schema.data(), schemaLength);
+  bytesWritten += 8 + sizeof(schemaLength) + schemaLength;
+  WritePadding();
+
+  timestamp.reserve(blockSize);
+  delay.reserve(blockSize);
+  nodeId.reserve(blockSize);
+  src.reserve(blockSize);
+  seq.reserve(blockSize);
+  lastHop.reserve(blockSize);
+  numHops.reserve(blockSize);
+  eventType.reserve(blockSize);
+}
+
+void BinaryTraceLogger::CreateEntry (uint32_t nodeId, uint32_t src, uint32_t seq, EventType eventType, uint32_t lastHop, double delay, uint32_t numHops){
+  this->timestamp.push_back(ns3::Simulator::Now().GetNanoSeconds());
+  this->delay.push_back(delay);
+  this->nodeId.push_back(nodeId);
+  this->src.push_back(src);
+  this->seq.push_back(seq);
+  this->lastHop.push_back(lastHop);
+  this->numHops.push_back(numHops);
+  this->eventType.push_back(eventType);
+  if (this->timestamp.size() >= blockSize) {
+    Flush();
+  }
+}
+
+void BinaryTraceLogger::Flush () {
+  if (!outputFile.is_open() || timestamp.empty()) {
+    return;
+  }
+  uint32_t blockHeader[2] = {static_cast<uint32_t>(timestamp.size()), 0};
+  outputFile.write(reinterpret_cast<const char *>(blockHeader), sizeof(blockHeader));
+  bytesWritten += sizeof(blockHeader);
+  WriteColumn(timestamp);
+  WriteColumn(delay);
+  WriteColumn(nodeId);
+  WriteColumn(src);
+  WriteColumn(seq);
+  WriteColumn(lastHop);
+  WriteColumn(numHops);
+  WriteColumn(eventType);
+  WritePadding();
+  outputFile.flush();
+
+  timestamp.clear();
+  delay.clear();
+  nodeId.clear();
+  src.clear();
+  seq.clear();
+  lastHop.clear();
+  numHops.clear();
+  eventType.clear();
+}
+
+template <typename T>
+void BinaryTraceLogger::WriteColumn (const std::vector<T> &column) {
+  outputFile.write(reinterpret_cast<const char *>(column.data()), column.size() * sizeof(T));
+  bytesWritten += column.size() * sizeof(T);
+}
+
+void BinaryTraceLogger::WritePadding () {
+  static const char zeros[8] = {0};
+  uint32_t padding = (8 - bytesWritten % 8) % 8;
+  outputFile.write(zeros, padding);
+  bytesWritten += padding;
+}
+
+#endif
@@ -64,7 +64,7 @@ void CsvLogger::CreateEntry (uint32_t node_id, string seqNo, string eventType, s
              << src << ","
              << lastHop << ","
              << delay << ","
-             << numHops << std::endl;
+             << numHops << "\n";
 }
 
 void CsvLogger::CreateCourse(uint32_t node_id, ns3::Ptr<const ns3::MobilityModel> mobility) {
@@ -82,7 +82,7 @@ void CsvLogger::CreateCourse(uint32_t node_id, ns3::Ptr<const ns3::MobilityModel
              << node_id << ","
              << pos.x << ","
              << pos.y << ","
-             << pos.z << std::endl;
+             << pos.z << "\n";
 }
 
 
@@ -4,6 +4,7 @@
 #include <fstream>
 
 #include "ns3/core-module.h"
+#include "ns3/flooding-stats.h"
 
 using namespace std;
 
@@ -20,6 +21,8 @@ public:
 
   void CreateEntry (double pd, double pe500);
   void CreateEntry (double pd, double pe500, double sumSent, double sumRcvd, double sumFwd);
+  void CreateEntry (double pd, double pe500, double sumSent, double sumRcvd, double sumFwd, std::string stopReason);
+  void CreateEntry (const ns3::FloodingStatsSnapshot &snapshot);
 
 private:
   std::ofstream outputFile;
@@ -72,4 +75,58 @@ void KpiLogger::CreateEntry (double pd, double pe500, double sumSent, double sum
              << sumFwd << std::endl;
 }
 
+void KpiLogger::CreateEntry (double pd, double pe500, double sumSent, double sumRcvd, double sumFwd, std::string stopReason){
+  if (createHeader) {
+    createHeader = false;
+    outputFile << "timestamp" << ","
+               << "pd" << ","
+               << "pe500" << ","
+               << "sumSent" << ","
+               << "sumRcvd" << ","
+               << "sumFwd" << ","
+               << "stopReason" << std::endl;
+  }
+  outputFile << std::to_string(ns3::Simulator::Now().GetSeconds()) << ","
+             << pd << ","
+             << pe500 << ","
+             << sumSent << ","
+             << sumRcvd << ","
+             << sumFwd << ","
+             << stopReason << std::endl;
+}
+
+void KpiLogger::CreateEntry (const ns3::FloodingStatsSnapshot &snapshot){
+  if (createHeader) {
+    createHeader = false;
+    outputFile << "timestamp" << ","
+               << "pd" << ","
+               << "pe500" << ","
+               << "sumSent" << ","
+               << "sumRcvd" << ","
+               << "sumFwd" << ","
+               << "meanAoi" << ","
+               << "windowPd" << ","
+               << "windowPe500" << ","
+               << "windowUpdates" << ","
+               << "windowSent" << ","
+               << "windowRcvd" << ","
+               << "windowFwd" << ","
+               << "windowMeanAoi" << std::endl;
+  }
+  outputFile << std::to_string(snapshot.time.GetSeconds()) << ","
+             << snapshot.pd << ","
+             << snapshot.pe500 << ","
+             << snapshot.sent << ","
+             << snapshot.received << ","
+             << snapshot.forwarded << ","
+             << snapshot.meanAoi << ","
+             << snapshot.windowPd << ","
+             << snapshot.windowPe500 << ","
+             << snapshot.windowUpdates << ","
+             << snapshot.windowSent << ","
+             << snapshot.windowReceived << ","
+             << snapshot.windowForwarded << ","
+             << snapshot.windowMeanAoi << "\n";
+}
+
 #endif
@@ -0,0 +1,306 @@
+#ifndef RDFSCENARIO_H
+#define RDFSCENARIO_H
+
+#include "ns3/core-module.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/wifi-standards.h"
+#include "ns3/rectangle.h"
+#include "ns3/flooding-helper.h"
+#include "ns3/rate-decay-flooding-application.h"
+#include "ns3/flooding-stats.h"
+#include "ns3/flooding-convergence-monitor.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/yans-wifi-remote-channel.h"
+#include <mpi.h>
+#endif
+
+using namespace ns3;
+using namespace std;
+
+/*
+ * Rate decay flooding scenario shared by rate-decay-flooding and rdf-sweep.
+ *
+ * BuildRdfScenario sets up the nodes, the 802.11p channel, mobility and the
+ * applications, which publish their counters into the returned stats block.
+ * CollectRdfKpis turns the stats block into the KPIs written to the
+ * kpi_rdf_*.csv files. With a convergenceThreshold, MonitorRdfConvergence
+ * stops the run as soon as pd and pe500 have converged.
+ *
+ * Under MPI, every rank builds all nodes and simulates the applications of
+ * the nodes starting in its strip of the area, see GetRdfRank. The 802.11p
+ * channel forwards the transmissions near the strip borders to the
+ * neighbouring ranks, and CollectRdfKpis sums the KPIs of all ranks.
+ */
+struct RdfScenarioParams {
+  int numNodes = 10;
+  double interval = 1;       // seconds
+  double decayFactor = 1.0;
+  uint32_t seed = 0;
+  double size = 0;           // side length of the area in m
+  double simTime = 180;      // seconds
+  double speedMin = -1.0;
+  double speedMax = -1.0;
+  uint32_t packetSize = 100; // bytes
+  double kpiInterval = 0;    // seconds between KPI snapshots, 0 disables them
+  double statsResetTime = 5; // seconds, the counters of the warm-up before are dropped
+  double convergenceThreshold = 0; // relative CI half-width to stop at, 0 disables early termination
+};
+
+struct RdfKpis {
+  double pd = 0;
+  double pe500 = 0;
+  double sumSent = 0;
+  double sumRcvd = 0;
+  double sumFwd = 0;
+  string stopReason = "simTime";
+  double stopTime = 0;       // seconds
+};
+
+bool IsRdfDistributed()
+{
+#ifdef NS3_MPI
+  return MpiInterface::IsEnabled() && MpiInterface::GetSize() > 1;
+#else
+  return false;
+#endif
+}
+
+// Rank owning a node that starts at pos: the area is cut into one strip per rank along x
+uint32_t GetRdfRank(const Vector &pos, const RdfScenarioParams &params)
+{
+#ifdef NS3_MPI
+  if (IsRdfDistributed())
+  {
+    uint32_t ranks = MpiInterface::GetSize();
+    double width = params.size / ranks;
+    uint32_t rank = width > 0 ? static_cast<uint32_t>(std::max(pos.x, 0.0) / width) : 0;
+    return std::min(rank, ranks - 1);
+  }
+#endif
+  return 0;
+}
+
+bool IsRdfLocal(Ptr<Node> node)
+{
+#ifdef NS3_MPI
+  if (IsRdfDistributed())
+  {
+    return node->GetSystemId() == MpiInterface::GetSystemId();
+  }
+#endif
+  return true;
+}
+
+Ptr<PositionAllocator> CreateRdfPositionAllocator(const RdfScenarioParams &params)
+{
+  ObjectFactory pos;
+  pos.SetTypeId("ns3::RandomRectanglePositionAllocator");
+  pos.Set("X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + to_string(params.size) + "]"));
+  pos.Set("Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + to_string(params.size) + "]"));
+
+  return pos.Create()->GetObject<PositionAllocator>();
+}
+
+// Seconds between two KPI snapshots; the convergence monitor needs them, one per second unless asked otherwise
+double GetRdfKpiInterval(const RdfScenarioParams &params)
+{
+  if (params.convergenceThreshold > 0 && params.kpiInterval <= 0)
+  {
+    return 1;
+  }
+  return params.kpiInterval;
+}
+
+void ResetRdfStats(Ptr<RateDecayFloodingApp> app)
+{
+  app->ResetStats();
+}
+
+Ptr<FloodingStats> BuildRdfScenario(NodeContainer &c, const RdfScenarioParams &params)
+{
+  ns3::SeedManager::SetSeed(params.seed + 10);
+
+  // Convert to time object
+  Time interPacketInterval = Seconds(params.interval);
+
+  Ptr<PositionAllocator> posAlloc;
+  if (IsRdfDistributed())
+  {
+    // The owner of a node is fixed when it is created, so draw the start positions first
+    Ptr<PositionAllocator> random = CreateRdfPositionAllocator(params);
+    Ptr<ListPositionAllocator> list = CreateObject<ListPositionAllocator>();
+    for (int i = 0; i < params.numNodes; i++)
+    {
+      Vector start = random->GetNext();
+      list->Add(start);
+      c.Add(CreateObject<Node>(GetRdfRank(start, params)));
+    }
+    posAlloc = list;
+  }
+  else
+  {
+    c.Create(params.numNodes);
+  }
+
+  // The below set of helpers will help us to put together the wifi NICs we want
+  WifiHelper wifi;
+
+  string phyMode = "OfdmRate3MbpsBW10MHz"; // OfdmRate3MbpsBW10MHz
+  wifi.SetStandard(WIFI_STANDARD_80211p);
+
+  // Fix non-unicast data rate to be the same as that of unicast
+  Config::SetDefault("ns3::WifiRemoteStationManager::NonUnicastMode", StringValue(phyMode));
+
+  YansWifiPhyHelper wifiPhy;
+  wifiPhy.Set("RxGain", DoubleValue(0));
+  wifiPhy.Set("RxSensitivity", DoubleValue(-85));
+  wifiPhy.Set("ChannelWidth", UintegerValue(10));
+  wifiPhy.Set("TxPowerStart", DoubleValue(20));
+  wifiPhy.Set("TxPowerEnd", DoubleValue(20));
+  // ns-3 supports RadioTap and Prism tracing extensions for 802.11b
+  // wifiPhy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
+
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.90e9));
+  Ptr<YansWifiChannel> channel = wifiChannel.Create();
+#ifdef NS3_MPI
+  if (IsRdfDistributed())
+  {
+    Ptr<YansWifiRemoteChannel> remote = CreateObject<YansWifiRemoteChannel>();
+    PointerValue loss;
+    PointerValue delay;
+    channel->GetAttribute("PropagationLossModel", loss);
+    channel->GetAttribute("PropagationDelayModel", delay);
+    remote->SetAttribute("PropagationLossModel", loss);
+    remote->SetAttribute("PropagationDelayModel", delay);
+    channel = remote;
+  }
+#endif
+  wifiPhy.SetChannel(channel);
+
+  // Add a mac and disable rate control
+  WifiMacHelper wifiMac;
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager", "DataMode", StringValue(phyMode), "ControlMode", StringValue(phyMode));
+  // Set it to adhoc mode
+  wifiMac.SetType("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, c);
+
+  if (!posAlloc)
+  {
+    posAlloc = CreateRdfPositionAllocator(params);
+  }
+
+  MobilityHelper mobility;
+
+  mobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
+                            "Bounds", RectangleValue(Rectangle(0, params.size, 0, params.size)),
+                            "Speed", StringValue("ns3::UniformRandomVariable[Min=" + to_string(params.speedMin) + "|Max=" + to_string(params.speedMax) + "]"),
+                            "Pause", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+  mobility.SetPositionAllocator(posAlloc);
+  mobility.Install(c);
+
+  InternetStackHelper internet;
+  internet.Install(c);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase("10.1.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer i = ipv4.Assign(devices);
+
+  RateDecayFloodingAppHelper client(3000, interPacketInterval, Seconds(0.01), params.packetSize, 509.003, params.decayFactor);
+
+  Ptr<UniformRandomVariable> startTimeRNG = CreateObject<UniformRandomVariable>();
+
+  Ptr<FloodingStats> stats = CreateObject<FloodingStats>();
+  stats->SetAttribute("SnapshotInterval", TimeValue(Seconds(GetRdfKpiInterval(params))));
+
+  for (int i = 0; i < params.numNodes; i++)
+  {
+    Time start = Seconds(startTimeRNG->GetValue(0.0, 5.0));
+    if (!IsRdfLocal(c.Get(i)))
+    {
+      // Simulated by another rank, but counted in the pd of every rank
+      stats->AddNode(c.Get(i)->GetId());
+      continue;
+    }
+    ApplicationContainer apps = client.Install(c.Get(i));
+    apps.Start(start);
+    Ptr<RateDecayFloodingApp> app = c.Get(i)->GetApplication(0)->GetObject<RateDecayFloodingApp>();
+    app->SetStats(stats);
+    Simulator::ScheduleWithContext(c.Get(i)->GetId(), Seconds(params.statsResetTime), &ResetRdfStats, app);
+  }
+
+  stats->Initialize();
+  return stats;
+}
+
+Ptr<FloodingConvergenceMonitor> MonitorRdfConvergence(Ptr<FloodingStats> stats, const RdfScenarioParams &params)
+{
+  if (params.convergenceThreshold <= 0)
+  {
+    return 0;
+  }
+  // Each rank would stop on its own share of the KPIs
+  NS_ABORT_MSG_IF(IsRdfDistributed(), "convergenceThreshold cannot be used in a distributed run");
+  Ptr<FloodingConvergenceMonitor> monitor = CreateObject<FloodingConvergenceMonitor>();
+  monitor->SetAttribute("Threshold", DoubleValue(params.convergenceThreshold));
+  // The first window that starts after the stats reset ends one interval later
+  monitor->SetAttribute("StartTime", TimeValue(Seconds(params.statsResetTime + GetRdfKpiInterval(params))));
+  monitor->Monitor(stats);
+  return monitor;
+}
+
+RdfKpis CollectRdfKpis(Ptr<FloodingStats> stats, Ptr<FloodingConvergenceMonitor> monitor = 0)
+{
+  FloodingStatsSnapshot totals = stats->GetTotals();
+
+  RdfKpis kpis;
+  kpis.pd = totals.pd;
+  kpis.pe500 = totals.pe500;
+  kpis.sumSent = totals.sent;
+  kpis.sumRcvd = totals.received;
+  kpis.sumFwd = totals.forwarded;
+  kpis.stopTime = Simulator::Now().GetSeconds();
+#ifdef NS3_MPI
+  if (IsRdfDistributed())
+  {
+    // The counters of a node are only set on its rank, and pd is already
+    // normalised by the number of nodes of the whole scenario
+    double local[6] = {totals.pd, totals.pe500 * totals.updates, static_cast<double>(totals.updates),
+                       kpis.sumSent, kpis.sumRcvd, kpis.sumFwd};
+    double global[6];
+    MPI_Allreduce(local, global, 6, MPI_DOUBLE, MPI_SUM, MpiInterface::GetCommunicator());
+    kpis.pd = global[0];
+    kpis.pe500 = global[2] > 0 ? global[1] / global[2] : 0;
+    kpis.sumSent = global[3];
+    kpis.sumRcvd = global[4];
+    kpis.sumFwd = global[5];
+  }
+#endif
+  if (monitor)
+  {
+    kpis.stopReason = monitor->GetStopReason();
+  }
+  return kpis;
+}
+
+RdfKpis RunRdfScenario(const RdfScenarioParams &params)
+{
+  NodeContainer c;
+  Ptr<FloodingStats> stats = BuildRdfScenario(c, params);
+  Ptr<FloodingConvergenceMonitor> monitor = MonitorRdfConvergence(stats, params);
+
+  Simulator::Stop(Seconds(params.simTime));
+  Simulator::Run();
+
+  RdfKpis kpis = CollectRdfKpis(stats, monitor);
+  Simulator::Destroy();
+  return kpis;
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef TRAJECTORYLOGGER_H
+#define TRAJECTORYLOGGER_H
+
+#include <fstream>
+#include <limits>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-model.h"
+
+using namespace std;
+
+/*
+ * Writes node trajectories as piecewise-linear segments.
+ *
+ * A row is written when a node is tracked and on every CourseChange of its
+ * mobility model. It holds the time, the position and the velocity from then
+ * on, so the position of a node at time t is pos + vel * (t - timestamp) of
+ * its last row at or before t. Rows of a node with equal timestamps replace
+ * each other. This is exact for the models moving at piecewise-constant
+ * velocity (RandomDirection2d, RandomWaypoint, ConstantVelocity, ...), which
+ * notify every change of velocity; the values are written with full
+ * precision. analysis_scripts/read_trajectory.py reconstructs the positions.
+ *
+ * Columns: timestamp_ns,nodeId,pos_x,pos_y,pos_z,vel_x,vel_y,vel_z
+ */
+class TrajectoryLogger {
+public:
+  TrajectoryLogger ();
+
+  TrajectoryLogger (std::string file);
+
+  ~TrajectoryLogger ();
+
+  void SetFile(std::string file);
+
+  // Write the current segment of the node and every following one
+  void Track(uint32_t nodeId, ns3::Ptr<ns3::MobilityModel> mobility);
+
+  uint64_t GetSegmentCount () const;
+
+private:
+  void CourseChange(uint32_t nodeId, ns3::Ptr<const ns3::MobilityModel> mobility);
+
+  std::ofstream outputFile;
+
+  uint64_t segments = 0;
+};
+
+TrajectoryLogger::TrajectoryLogger () : outputFile() {
+};
+
+TrajectoryLogger::TrajectoryLogger (std::string file) : outputFile() {
+  SetFile(file);
+};
+
+TrajectoryLogger::~TrajectoryLogger () {
+  //outputFile.close();
+}
+
+void TrajectoryLogger::SetFile(std::string file) {
+  outputFile.open(file);
+  outputFile.precision(std::numeric_limits<double>::max_digits10);
+  outputFile << "timestamp_ns" << ","
+             << "nodeId" << ","
+             << "pos_x" << ","
+             << "pos_y" << ","
+             << "pos_z" << ","
+             << "vel_x" << ","
+             << "vel_y" << ","
+             << "vel_z" << std::endl;
+}
+
+void TrajectoryLogger::Track(uint32_t nodeId, ns3::Ptr<ns3::MobilityModel> mobility) {
+  CourseChange(nodeId, mobility);
+  mobility->TraceConnectWithoutContext("CourseChange", ns3::MakeCallback(&TrajectoryLogger::CourseChange, this).Bind(nodeId));
+}
+
+uint64_t TrajectoryLogger::GetSegmentCount () const {
+  return segments;
+}
+
+void TrajectoryLogger::CourseChange(uint32_t nodeId, ns3::Ptr<const ns3::MobilityModel> mobility) {
+  ns3::Vector pos = mobility->GetPosition();
+  ns3::Vector vel = mobility->GetVelocity();
+  outputFile << ns3::Simulator::Now().GetNanoSeconds() << ","
+             << nodeId << ","
+             << pos.x << ","
+             << pos.y << ","
+             << pos.z << ","
+             << vel.x << ","
+             << vel.y << ","
+             << vel.z << "\n";
+  segments++;
+}
+
+
+#endif
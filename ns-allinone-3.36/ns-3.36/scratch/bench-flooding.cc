@@ -0,0 +1,776 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+#include "ns3/command-line.h"
+#include "ns3/event-pool.h"
+#include "ns3/packet.h"
+#include "ns3/scheduler.h"
+#include "ns3/flooding-duplicate-cache.h"
+#include "ns3/flooding-source-table.h"
+#include "ns3/contention-based-flooding-header.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/ofdm-phy.h"
+#include "ns3/ofdm-ppdu.h"
+#include "ns3/wifi-psdu.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/building.h"
+#include "ns3/building-list.h"
+#include "RdfScenario.h"
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE("BenchFlooding");
+
+/*
+ * Benchmarks of the code paths the flooding simulations spend their time in.
+ *
+ * For every node count, a forked process runs
+ *  - dedup:     the duplicate check of HandleRead, one lookup and one insert per received packet
+ *  - sources:   the per-source state of RateDecayFloodingApp::HandleRead in a FloodingSourceTable
+ *               and in the std::map/std::set it replaced, and the live heap bytes a node needs
+ *               once it heard of every source, for both and for the two duplicate caches;
+ *               swarmMb is the total of the table and the duplicate caches over all nodes
+ *  - header:    ContentionBasedFloodingHeader added to and removed from a packet, and
+ *               the airtime of a flood in which every node transmits the packet once
+ *  - header-compact: same, with the compact header format
+ *  - scheduler-*: hold model on every scheduler with a pending event population that grows with the nodes
+ *  - scheduler-burst-*: same, with most events inserted as reception bursts just after the current time
+ *  - snir:      InterferenceHelper SNIR of a frame overlapping with the transmissions of a tenth of the nodes
+ *  - fanout:    YansWifiChannel::Send fan-out of a broadcast storm, every node sends one frame
+ *  - los:       line of sight of random links between UAVs over a city, through the
+ *               BuildingList grid index; los-linear tests every building instead
+ *  - scenario:  the rate decay flooding scenario of rdf-sweep (12 nodes/km^2, 22.2-33.3 m/s)
+ * and reports wall time, events/s, wall time per simulated second, peak RSS and
+ * heap allocations per operation or transmitted packet. Allocations and the
+ * live heap bytes are counted by replacing the global operator new and delete
+ * of this program. The random streams are seeded, so every run executes the
+ * same events. The scenario also reports the
+ * share of its events whose memory came from the EventPool free lists, which
+ * is zero unless the tree is configured with NS3_EVENT_POOL
+ * (--enable-event-pool) and --eventPool is not turned off.
+ *
+ * The results are written as benchmark,nodes,metric,value rows. With
+ * --baseline, every metric is compared against a file written by an earlier
+ * run. Channel modes can be selected with the usual attribute syntax, e.g.
+ * --ns3::YansWifiChannel::SharedPpduEnabled=true. The buildings of the los
+ * benchmark are read from --city, one xMin,xMax,yMin,yMax,zMin,zMax box per
+ * line; without it, a 4 km x 4 km grid of 2500 blocks is generated.
+ *
+ * Usage: ./ns3 run "bench-flooding --nodes=100,400,800 --out=bench.csv --baseline=bench_base.csv"
+ */
+
+static uint64_t g_allocations = 0;
+static int64_t g_heapBytes = 0;
+
+// The replacements below must not be inlined into their callers, or GCC
+// reports the free() of memory from operator new as a mismatch
+__attribute__((noinline)) void *operator new(size_t size)
+{
+  g_allocations++;
+  void *p = malloc(size ? size : 1);
+  if (!p)
+  {
+    throw bad_alloc();
+  }
+  g_heapBytes += malloc_usable_size(p);
+  return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept
+{
+  g_heapBytes -= malloc_usable_size(p);
+  free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept
+{
+  g_heapBytes -= malloc_usable_size(p);
+  free(p);
+}
+
+struct BenchResult {
+  string benchmark;
+  uint32_t nodes;
+  string metric;
+  double value;
+};
+
+class Stopwatch
+{
+public:
+  Stopwatch()
+      : m_start(chrono::steady_clock::now()),
+        m_allocations(g_allocations)
+  {
+  }
+
+  double GetSeconds() const
+  {
+    return chrono::duration<double>(chrono::steady_clock::now() - m_start).count();
+  }
+
+  uint64_t GetAllocations() const
+  {
+    return g_allocations - m_allocations;
+  }
+
+private:
+  chrono::steady_clock::time_point m_start;
+  uint64_t m_allocations;
+};
+
+void BenchDedup(uint32_t nodes, uint32_t n, vector<BenchResult> &results)
+{
+  // A node receives the packets of all sources in sequence order, each twice
+  FloodingDuplicateCache cache;
+  uint32_t duplicates = 0;
+  Stopwatch watch;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    uint32_t packet = i / 2;
+    uint32_t src = packet % nodes;
+    uint32_t seq = packet / nodes;
+    uint64_t key = FloodingDuplicateCache::MakeKey(src, seq);
+    if (cache.Contains(key) || !cache.Insert(key))
+    {
+      duplicates++;
+    }
+  }
+  double seconds = watch.GetSeconds();
+  results.push_back({"dedup", nodes, "nsPerOp", seconds * 1e9 / n});
+  results.push_back({"dedup", nodes, "allocsPerOp", double(watch.GetAllocations()) / n});
+  NS_LOG_DEBUG(duplicates << " duplicates");
+}
+
+// State per source of RateDecayFloodingApp before the FloodingSourceTable
+struct SourceMaps
+{
+  map<uint32_t, Time> lastForwarded;
+  map<uint32_t, Ptr<Packet>> packetsToForward;
+  map<uint32_t, Time> lastReceived;
+  set<uint32_t> seenNodes;
+};
+
+void BenchSources(uint32_t nodes, uint32_t n, vector<BenchResult> &results)
+{
+  // A node receives n packets of random sources and updates their state as
+  // RateDecayFloodingApp::HandleRead does
+  Ptr<Packet> packet = Create<Packet>(100);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+  random->SetStream(1);
+  vector<uint32_t> sources(n);
+  for (uint32_t &src : sources)
+  {
+    src = random->GetInteger(0, nodes - 1);
+  }
+
+  FloodingSourceTable table;
+  uint32_t updates = 0;
+  uint32_t forwards = 0;
+  Stopwatch watch;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    uint32_t src = sources[i];
+    Time now = NanoSeconds(i);
+    Time last;
+    table.MarkSeen(src);
+    if (table.GetLastReceived(src, last))
+    {
+      updates++;
+    }
+    table.SetLastReceived(src, now);
+    Time rdfDelay;
+    if (table.GetLastForwarded(src, last))
+    {
+      rdfDelay = last - now;
+    }
+    table.SetPacket(src, packet);
+    table.SetLastForwarded(src, now + rdfDelay);
+    // Forward looks the packet up when its timer fires
+    if (table.GetPacket(src))
+    {
+      forwards++;
+    }
+  }
+  double seconds = watch.GetSeconds();
+
+  SourceMaps maps;
+  Stopwatch mapWatch;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    uint32_t src = sources[i];
+    Time now = NanoSeconds(i);
+    maps.seenNodes.insert(src);
+    if (maps.lastReceived.count(src) > 0)
+    {
+      updates++;
+    }
+    maps.lastReceived[src] = now;
+    Time rdfDelay;
+    if (maps.lastForwarded.find(src) != maps.lastForwarded.end())
+    {
+      rdfDelay = maps.lastForwarded[src] - now;
+    }
+    maps.packetsToForward[src] = packet;
+    maps.lastForwarded[src] = now + rdfDelay;
+    if (maps.packetsToForward[src])
+    {
+      forwards++;
+    }
+  }
+  double mapSeconds = mapWatch.GetSeconds();
+  results.push_back({"sources", nodes, "nsPerOp", seconds * 1e9 / n});
+  results.push_back({"sources", nodes, "nsPerOp-map", mapSeconds * 1e9 / n});
+  NS_LOG_DEBUG(updates << " updates, " << forwards << " forwards");
+
+  // Live heap bytes of a node that heard of every source
+  int64_t before = g_heapBytes;
+  FloodingSourceTable fullTable;
+  for (uint32_t src = 0; src < nodes; src++)
+  {
+    fullTable.MarkSeen(src);
+    fullTable.SetLastReceived(src, Seconds(0));
+    fullTable.SetLastForwarded(src, Seconds(0));
+    fullTable.SetPacket(src, packet);
+  }
+  double tableBytes = g_heapBytes - before;
+  before = g_heapBytes;
+  SourceMaps fullMaps;
+  for (uint32_t src = 0; src < nodes; src++)
+  {
+    fullMaps.seenNodes.insert(src);
+    fullMaps.lastReceived[src] = Seconds(0);
+    fullMaps.lastForwarded[src] = Seconds(0);
+    fullMaps.packetsToForward[src] = packet;
+  }
+  double mapBytes = g_heapBytes - before;
+  before = g_heapBytes;
+  FloodingDuplicateCache seen;
+  FloodingDuplicateCache twiceSeen;
+  for (uint32_t src = 0; src < nodes; src++)
+  {
+    seen.Insert(FloodingDuplicateCache::MakeKey(src, 0));
+    twiceSeen.Insert(FloodingDuplicateCache::MakeKey(src, 0));
+  }
+  double dedupBytes = g_heapBytes - before;
+  results.push_back({"sources", nodes, "tableBytesPerNode", tableBytes});
+  results.push_back({"sources", nodes, "mapBytesPerNode", mapBytes});
+  results.push_back({"sources", nodes, "dedupBytesPerNode", dedupBytes});
+  results.push_back({"sources", nodes, "swarmMb", nodes * (tableBytes + dedupBytes) / (1024.0 * 1024.0)});
+}
+
+void BenchHeader(bool compact, uint32_t nodes, uint32_t n, vector<BenchResult> &results)
+{
+  ContentionBasedFloodingHeader header;
+  header.SetCompact(compact);
+  header.SetSrc(nodes - 1);
+  header.SetLastHop(nodes / 2);
+  header.SetSeq(1000);
+  header.SetNumHops(3);
+  header.SetStartPos(Vector(100, 200, 0));
+  header.SetLastPos(Vector(300, 400, 0));
+  uint64_t hops = 0;
+  Stopwatch watch;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    Ptr<Packet> packet = Create<Packet>(100);
+    packet->AddHeader(header);
+    ContentionBasedFloodingHeader received;
+    received.SetCompact(compact);
+    packet->RemoveHeader(received);
+    hops += received.GetNumHops();
+  }
+  double seconds = watch.GetSeconds();
+
+  // 100 byte payload behind UDP (8), IPv4 (20), LLC/SNAP (8), MAC header (24) and FCS (4)
+  // at the 3 Mbit/s rate of the scenarios
+  WifiTxVector txVector;
+  txVector.SetMode(OfdmPhy::GetOfdmRate3MbpsBW10MHz());
+  txVector.SetChannelWidth(10);
+  uint32_t frameSize = 100 + header.GetSerializedSize() + 8 + 20 + 8 + 24 + 4;
+  Time airtime = WifiPhy::CalculateTxDuration(frameSize, txVector, WIFI_PHY_BAND_5GHZ);
+
+  string name = compact ? "header-compact" : "header";
+  results.push_back({name, nodes, "nsPerOp", seconds * 1e9 / n});
+  results.push_back({name, nodes, "allocsPerOp", double(watch.GetAllocations()) / n});
+  results.push_back({name, nodes, "headerBytes", double(header.GetSerializedSize())});
+  results.push_back({name, nodes, "airtimeMsPerFlood", airtime.GetSeconds() * 1e3 * nodes});
+  NS_LOG_DEBUG(hops << " hops");
+}
+
+void BenchScheduler(const string &type, bool burst, uint32_t nodes, uint32_t n, vector<BenchResult> &results)
+{
+  // Hold model: every removed event is replaced by one within the next
+  // millisecond, like the backoffs of a flooding round. In burst mode,
+  // three out of four replacements are receptions 1 to 1.1 us after the
+  // removed event, with many equal timestamps, and the others are jittered
+  // forwarding events up to 1 ms later.
+  ObjectFactory factory;
+  factory.SetTypeId("ns3::" + type);
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+  Ptr<UniformRandomVariable> delay = CreateObject<UniformRandomVariable>();
+  delay->SetStream(1);
+  auto nextDelay = [&]()
+  {
+    if (burst && delay->GetInteger(0, 3) != 0)
+    {
+      return uint64_t(1000 + delay->GetInteger(0, 100));
+    }
+    return uint64_t(delay->GetInteger(0, 1000000));
+  };
+  uint32_t population = nodes * 50;
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  for (uint32_t i = 0; i < population; i++)
+  {
+    Scheduler::Event event;
+    event.impl = 0;
+    event.key.m_ts = delay->GetInteger(0, 1000000);
+    event.key.m_uid = uid++;
+    event.key.m_context = i % nodes;
+    scheduler->Insert(event);
+  }
+  Stopwatch watch;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    Scheduler::Event next = scheduler->RemoveNext();
+    now = next.key.m_ts;
+    Scheduler::Event event;
+    event.impl = 0;
+    event.key.m_ts = now + nextDelay();
+    event.key.m_uid = uid++;
+    event.key.m_context = next.key.m_context;
+    scheduler->Insert(event);
+  }
+  double seconds = watch.GetSeconds();
+  string name = string(burst ? "scheduler-burst-" : "scheduler-") + type;
+  results.push_back({name, nodes, "nsPerOp", seconds * 1e9 / n});
+  results.push_back({name, nodes, "allocsPerOp", double(watch.GetAllocations()) / n});
+  while (!scheduler->IsEmpty())
+  {
+    scheduler->RemoveNext();
+  }
+}
+
+void BenchSnir(uint32_t nodes, uint32_t n, vector<BenchResult> &results)
+{
+  InterferenceHelper interference;
+  interference.SetNoiseFigure(DbToRatio(7));
+  Ptr<NistErrorRateModel> errorRateModel = CreateObject<NistErrorRateModel>();
+  interference.SetErrorRateModel(errorRateModel);
+  WifiSpectrumBand band = make_pair(0, 0);
+  interference.AddBand(band);
+
+  WifiTxVector txVector;
+  txVector.SetMode(OfdmPhy::GetOfdmRate3MbpsBW10MHz());
+  txVector.SetChannelWidth(10);
+  WifiMacHeader macHeader(WIFI_MAC_DATA);
+  Ptr<WifiPsdu> psdu = Create<WifiPsdu>(Create<Packet>(100), macHeader);
+  Ptr<WifiPpdu> ppdu = Create<OfdmPpdu>(psdu, txVector, WIFI_PHY_BAND_5GHZ, 0);
+
+  // A reception during which a tenth of the nodes start to transmit,
+  // evaluated at its end like the PHY does
+  RxPowerWattPerChannelBand rxPower;
+  rxPower.insert({band, DbmToW(-70)});
+  Ptr<Event> event;
+  Simulator::Schedule(Seconds(0), [&]()
+                      {
+                        event = interference.Add(ppdu, txVector, MicroSeconds(400), rxPower);
+                        interference.NotifyRxStart(); });
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+  random->SetStream(2);
+  uint32_t interferers = max<uint32_t>(nodes / 10, 1);
+  for (uint32_t i = 0; i < interferers; i++)
+  {
+    double powerDbm = random->GetValue(-95, -75);
+    Time duration = MicroSeconds(random->GetInteger(100, 600));
+    Simulator::Schedule(MicroSeconds(random->GetInteger(1, 399)), [&interference, band, powerDbm, duration]()
+                        {
+                          RxPowerWattPerChannelBand foreignPower;
+                          foreignPower.insert({band, DbmToW(powerDbm)});
+                          interference.AddForeignSignal(duration, foreignPower); });
+  }
+
+  double sum = 0;
+  double seconds = 0;
+  uint64_t allocations = 0;
+  // The payload error rate, with the analytical and the tabulated chunk success rates
+  pair<Time, Time> payload = make_pair(Seconds(0), MicroSeconds(400) - WifiPhy::CalculatePhyPreambleAndHeaderDuration(txVector));
+  double perSum[2] = {0, 0};
+  double perSeconds[2] = {0, 0};
+  Simulator::Schedule(MicroSeconds(400), [&]()
+                      {
+                        Stopwatch watch;
+                        for (uint32_t i = 0; i < n; i++)
+                        {
+                          sum += interference.CalculateSnr(event, 10, 1, band);
+                        }
+                        seconds = watch.GetSeconds();
+                        allocations = watch.GetAllocations();
+                        for (bool tabulated : {false, true})
+                        {
+                          errorRateModel->SetAttribute("Tabulated", BooleanValue(tabulated));
+                          // The tables are filled on the first use
+                          interference.CalculatePayloadSnrPer(event, 10, band, SU_STA_ID, payload);
+                          Stopwatch perWatch;
+                          for (uint32_t i = 0; i < n; i++)
+                          {
+                            perSum[tabulated] += interference.CalculatePayloadSnrPer(event, 10, band, SU_STA_ID, payload).per;
+                          }
+                          perSeconds[tabulated] = perWatch.GetSeconds();
+                        } });
+  Simulator::Run();
+  Simulator::Destroy();
+  results.push_back({"snir", nodes, "nsPerOp", seconds * 1e9 / n});
+  results.push_back({"snir", nodes, "allocsPerOp", double(allocations) / n});
+  results.push_back({"per", nodes, "nsPerOp", perSeconds[0] * 1e9 / n});
+  results.push_back({"per-tabulated", nodes, "nsPerOp", perSeconds[1] * 1e9 / n});
+  NS_LOG_DEBUG(sum / n << " mean SNR, " << perSum[0] / n << " PER, " << perSum[1] / n << " tabulated PER");
+}
+
+vector<Box> LoadCity(const string &file)
+{
+  vector<Box> city;
+  ifstream input(file);
+  NS_ABORT_MSG_UNLESS(input.is_open(), "Cannot open city file " << file);
+  string line;
+  while (getline(input, line))
+  {
+    if (line.empty() || line[0] == '#' || isalpha(line[0]))
+    {
+      continue;
+    }
+    replace(line.begin(), line.end(), ',', ' ');
+    stringstream fields(line);
+    Box box;
+    fields >> box.xMin >> box.xMax >> box.yMin >> box.yMax >> box.zMin >> box.zMax;
+    NS_ABORT_MSG_IF(fields.fail(), "Malformed building in " << file << ": " << line);
+    city.push_back(box);
+  }
+  return city;
+}
+
+vector<Box> GenerateCity()
+{
+  // 60 m blocks separated by 20 m streets, 10 to 60 m high
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+  random->SetStream(3);
+  vector<Box> city;
+  for (uint32_t i = 0; i < 50; i++)
+  {
+    for (uint32_t j = 0; j < 50; j++)
+    {
+      city.push_back(Box(i * 80.0, i * 80.0 + 60, j * 80.0, j * 80.0 + 60, 0, random->GetValue(10, 60)));
+    }
+  }
+  return city;
+}
+
+void BenchLos(uint32_t nodes, uint32_t n, const string &cityFile, vector<BenchResult> &results)
+{
+  vector<Box> city = cityFile.empty() ? GenerateCity() : LoadCity(cityFile);
+  NS_ABORT_MSG_IF(city.empty(), "No building in the city");
+  Box area = city.front();
+  for (const Box &box : city)
+  {
+    Ptr<Building> building = CreateObject<Building>();
+    building->SetBoundaries(box);
+    area = Box(min(area.xMin, box.xMin), max(area.xMax, box.xMax), min(area.yMin, box.yMin), max(area.yMax, box.yMax), 0, 0);
+  }
+
+  // UAVs flying between 10 and 120 m over the city, every query is a link between two of them
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+  random->SetStream(4);
+  vector<Vector> positions;
+  for (uint32_t i = 0; i < nodes; i++)
+  {
+    positions.push_back(Vector(random->GetValue(area.xMin, area.xMax), random->GetValue(area.yMin, area.yMax), random->GetValue(10, 120)));
+  }
+  vector<pair<uint32_t, uint32_t>> links;
+  for (uint32_t i = 0; i < 4096; i++)
+  {
+    links.push_back({random->GetInteger(0, nodes - 1), random->GetInteger(0, nodes - 1)});
+  }
+
+  // Build the index outside of the measurement
+  BuildingList::IsIntersect(positions[0], positions[0]);
+  uint64_t blocked = 0;
+  Stopwatch watch;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    const pair<uint32_t, uint32_t> &link = links[i % links.size()];
+    blocked += BuildingList::IsIntersect(positions[link.first], positions[link.second]);
+  }
+  double seconds = watch.GetSeconds();
+  results.push_back({"los", nodes, "nsPerOp", seconds * 1e9 / n});
+  results.push_back({"los", nodes, "blockedShare", double(blocked) / n});
+  results.push_back({"los", nodes, "buildings", double(city.size())});
+
+  // Every building is tested, a hundredth of the queries is enough
+  uint32_t linearN = max(n / 100, 1u);
+  Stopwatch linearWatch;
+  for (uint32_t i = 0; i < linearN; i++)
+  {
+    const pair<uint32_t, uint32_t> &link = links[i % links.size()];
+    for (BuildingList::Iterator bit = BuildingList::Begin(); bit != BuildingList::End(); ++bit)
+    {
+      if ((*bit)->IsIntersect(positions[link.first], positions[link.second]))
+      {
+        break;
+      }
+    }
+  }
+  results.push_back({"los-linear", nodes, "nsPerOp", linearWatch.GetSeconds() * 1e9 / linearN});
+  Simulator::Destroy();
+}
+
+void BenchFanout(uint32_t nodes, vector<BenchResult> &results)
+{
+  // The PHY and channel of the flooding scenario on 300 m x 300 m, every
+  // node in range of every other one, each node broadcasts one frame
+  ns3::SeedManager::SetSeed(11);
+  NodeContainer c;
+  c.Create(nodes);
+
+  WifiHelper wifi;
+  wifi.SetStandard(WIFI_STANDARD_80211p);
+  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager", "DataMode", StringValue("OfdmRate3MbpsBW10MHz"), "ControlMode", StringValue("OfdmRate3MbpsBW10MHz"));
+  YansWifiPhyHelper wifiPhy;
+  wifiPhy.Set("RxSensitivity", DoubleValue(-85));
+  wifiPhy.Set("ChannelWidth", UintegerValue(10));
+  wifiPhy.Set("TxPowerStart", DoubleValue(20));
+  wifiPhy.Set("TxPowerEnd", DoubleValue(20));
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.90e9));
+  Ptr<YansWifiChannel> channel = wifiChannel.Create();
+  wifiPhy.SetChannel(channel);
+  WifiMacHelper wifiMac;
+  wifiMac.SetType("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, c);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator("ns3::RandomRectanglePositionAllocator",
+                                "X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=300.0]"),
+                                "Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=300.0]"));
+  mobility.Install(c);
+
+  for (uint32_t i = 0; i < nodes; i++)
+  {
+    Ptr<NetDevice> device = devices.Get(i);
+    Simulator::Schedule(MicroSeconds(200 * i), [device]()
+                        { device->Send(Create<Packet>(100), device->GetBroadcast(), 0x0800); });
+  }
+  Simulator::Stop(MicroSeconds(200 * nodes) + MilliSeconds(10));
+
+  Stopwatch watch;
+  Simulator::Run();
+  double seconds = watch.GetSeconds();
+  uint64_t events = Simulator::GetEventCount();
+  results.push_back({"fanout", nodes, "wallMs", seconds * 1e3});
+  results.push_back({"fanout", nodes, "eventsPerSec", events / seconds});
+  results.push_back({"fanout", nodes, "eventsPerTx", double(events) / nodes});
+  results.push_back({"fanout", nodes, "ppduCopiesPerTx", double(channel->GetPpduCopies()) / nodes});
+  results.push_back({"fanout", nodes, "allocsPerTx", double(watch.GetAllocations()) / nodes});
+  Simulator::Destroy();
+}
+
+void BenchScenario(uint32_t nodes, double simTime, vector<BenchResult> &results)
+{
+  RdfScenarioParams params;
+  params.numNodes = nodes;
+  params.seed = 1;
+  params.size = sqrt(nodes / 12.0) * 1000;
+  params.simTime = simTime;
+  params.speedMin = 22.2;
+  params.speedMax = 33.3;
+
+  NodeContainer c;
+  Ptr<FloodingStats> stats = BuildRdfScenario(c, params);
+  Simulator::Stop(Seconds(simTime));
+  EventPool::ResetStats();
+  Stopwatch watch;
+  Simulator::Run();
+  double seconds = watch.GetSeconds();
+  uint64_t allocations = watch.GetAllocations();
+  EventPoolStats pool = EventPool::GetStats();
+  RdfKpis kpis = CollectRdfKpis(stats);
+  double packets = kpis.sumSent + kpis.sumFwd;
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  results.push_back({"scenario", nodes, "wallMs", seconds * 1e3});
+  results.push_back({"scenario", nodes, "wallMsPerSimSec", seconds * 1e3 / simTime});
+  results.push_back({"scenario", nodes, "eventsPerSec", Simulator::GetEventCount() / seconds});
+  results.push_back({"scenario", nodes, "allocsPerPacket", packets > 0 ? allocations / packets : 0});
+  results.push_back({"scenario", nodes, "peakRssMb", usage.ru_maxrss / 1024.0});
+  results.push_back({"scenario", nodes, "eventsFromPoolPct", pool.allocations > 0 ? 100.0 * pool.reused / pool.allocations : 0});
+  Simulator::Destroy();
+}
+
+void RunWorker(uint32_t nodes, uint32_t n, double simTime, const string &cityFile, int fd)
+{
+  vector<BenchResult> results;
+  BenchDedup(nodes, n, results);
+  BenchHeader(false, nodes, n, results);
+  BenchHeader(true, nodes, n, results);
+  for (const string type : {"MapScheduler", "HeapScheduler", "CalendarScheduler", "PriorityQueueScheduler", "DaryHeapScheduler"})
+  {
+    BenchScheduler(type, false, nodes, n, results);
+    BenchScheduler(type, true, nodes, n, results);
+  }
+  // ListScheduler inserts in linear time, a hundredth of the operations is enough
+  BenchScheduler("ListScheduler", true, nodes, max(n / 100, 1u), results);
+  BenchSnir(nodes, n, results);
+  BenchFanout(nodes, results);
+  // After a Simulator::Run, which stops the tracking of every Time object
+  // for a change of resolution, so that the bytes are those of the columns
+  BenchSources(nodes, n, results);
+  BenchLos(nodes, n, cityFile, results);
+  // Last, so that the peak RSS is the one of the full scenario
+  BenchScenario(nodes, simTime, results);
+
+  stringstream rows;
+  rows.precision(10);
+  for (const BenchResult &result : results)
+  {
+    rows << result.benchmark << "," << result.nodes << "," << result.metric << "," << result.value << "\n";
+  }
+  string data = rows.str();
+  size_t written = 0;
+  while (written < data.size())
+  {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n <= 0)
+    {
+      break;
+    }
+    written += n;
+  }
+  close(fd);
+  _exit(written == data.size() ? 0 : 1);
+}
+
+map<string, double> ReadResults(const string &file)
+{
+  map<string, double> values;
+  ifstream input(file);
+  string line;
+  getline(input, line);
+  while (getline(input, line))
+  {
+    size_t comma = line.rfind(',');
+    if (comma != string::npos)
+    {
+      values[line.substr(0, comma)] = stod(line.substr(comma + 1));
+    }
+  }
+  return values;
+}
+
+int main(int argc, char *argv[])
+{
+  string nodeList = "100,400,800";
+  uint32_t n = 1000000;
+  double simTime = 10;
+  string outFile = "bench_flooding.csv";
+  string baselineFile = "";
+  bool eventPool = EventPool::IsEnabled();
+  string cityFile = "";
+
+  CommandLine cmd(__FILE__);
+  cmd.AddValue("nodes", "comma separated node counts", nodeList);
+  cmd.AddValue("n", "iterations of the dedup, sources, header, scheduler and snir benchmarks", n);
+  cmd.AddValue("simTime", "simulated seconds of the flooding scenario", simTime);
+  cmd.AddValue("out", "CSV file the results are written to", outFile);
+  cmd.AddValue("baseline", "CSV file of an earlier run to compare against", baselineFile);
+  cmd.AddValue("eventPool", "reuse the memory of the events through the EventPool free lists", eventPool);
+  cmd.AddValue("city", "CSV file of the buildings of the los benchmark, one xMin,xMax,yMin,yMax,zMin,zMax box per line", cityFile);
+  cmd.Parse(argc, argv);
+  EventPool::SetEnabled(eventPool);
+
+  vector<uint32_t> nodeCounts;
+  stringstream ss(nodeList);
+  string field;
+  while (getline(ss, field, ','))
+  {
+    nodeCounts.push_back(stoul(field));
+  }
+
+  string rows;
+  for (uint32_t nodes : nodeCounts)
+  {
+    // One process per node count, so that the peak RSS is not inherited
+    int fds[2];
+    NS_ABORT_MSG_IF(pipe(fds) != 0, "pipe() failed");
+    pid_t pid = fork();
+    NS_ABORT_MSG_IF(pid < 0, "fork() failed");
+    if (pid == 0)
+    {
+      close(fds[0]);
+      RunWorker(nodes, n, simTime, cityFile, fds[1]);
+    }
+    close(fds[1]);
+    string data;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fds[0], buffer, sizeof(buffer))) > 0)
+    {
+      data.append(buffer, count);
+    }
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    NS_ABORT_MSG_UNLESS(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Benchmark of " << nodes << " nodes failed with status " << status);
+    rows += data;
+  }
+
+  ofstream output(outFile);
+  NS_ABORT_MSG_UNLESS(output.is_open(), "Cannot open output file " << outFile);
+  output << "benchmark,nodes,metric,value\n"
+         << rows;
+  output.close();
+
+  // Results go to stdout, NS_LOG is compiled out of optimized builds
+  map<string, double> baseline;
+  if (!baselineFile.empty())
+  {
+    baseline = ReadResults(baselineFile);
+  }
+  map<string, double> current = ReadResults(outFile);
+  stringstream table(rows);
+  string line;
+  while (getline(table, line))
+  {
+    size_t comma = line.rfind(',');
+    string key = line.substr(0, comma);
+    cout << key << " " << current[key];
+    auto it = baseline.find(key);
+    if (it != baseline.end() && it->second != 0)
+    {
+      cout << " (" << showpos << (current[key] / it->second - 1) * 100 << noshowpos << "% vs baseline)";
+    }
+    cout << endl;
+  }
+  return 0;
+}
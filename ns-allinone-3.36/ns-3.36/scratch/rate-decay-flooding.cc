@@ -21,7 +21,10 @@
 #include "ns3/contention-based-flooding-header.h"
 #include "ns3/rate-decay-flooding-application.h"
 #include "CsvLogger.h"
+#include "BinaryTraceLogger.h"
+#include "TrajectoryLogger.h"
 #include "KpiLogger.h"
+#include "RdfScenario.h"
 
 using namespace ns3;
 using namespace std;
@@ -30,67 +33,50 @@ using namespace std::string_literals;
 NS_LOG_COMPONENT_DEFINE("RDF");
 
 CsvLogger resLogger = CsvLogger();
-CsvLogger courseLogger = CsvLogger();
+BinaryTraceLogger binResLogger = BinaryTraceLogger();
+bool binaryTrace = true;
+bool compactHeader = false;
+TrajectoryLogger courseLogger = TrajectoryLogger();
 KpiLogger kpiLogger = KpiLogger();
+KpiLogger kpiSeriesLogger = KpiLogger();
 
-void CourseChange(Ptr<const MobilityModel> mobility, uint32_t nodeId)
-{
-  courseLogger.CreateCourse(nodeId, mobility);
-  Simulator::Schedule(Seconds(0.1), &CourseChange, mobility, nodeId);
-}
-
-void OnPacketReceive(std::string context, Ptr<const Packet> pkt, uint32_t nodeId)
+void LogEvent(Ptr<const Packet> pkt, uint32_t nodeId, BinaryTraceLogger::EventType type)
 {
   ContentionBasedFloodingHeader header;
+  header.SetCompact(compactHeader);
   pkt->PeekHeader(header);
 
-  double current = Simulator::Now().GetSeconds();
-  double sent = header.GetTs().GetSeconds();
-  double delay = (current - sent) * 1000;
+  double delay = -1;
+  if (type != BinaryTraceLogger::PKT_SENT)
+  {
+    delay = (Simulator::Now() - header.GetTs()).GetSeconds() * 1000;
+  }
 
-  uint32_t src = header.GetSrc();
-  uint32_t lastHop = header.GetLastHop();
-  uint32_t numHops = header.GetNumHops();
+  if (binaryTrace)
+  {
+    binResLogger.CreateEntry(nodeId, header.GetSrc(), header.GetSeq(), type, header.GetLastHop(), delay, header.GetNumHops());
+    return;
+  }
 
-  string seqNo = to_string(src) + "-" + to_string(header.GetSeq());
+  string seqNo = to_string(header.GetSrc()) + "-" + to_string(header.GetSeq());
+  string eventType = type == BinaryTraceLogger::PKT_RCVD ? "PktRcvd" : type == BinaryTraceLogger::PKT_SENT ? "PktSent" : "PktFwd";
+  string delayStr = type == BinaryTraceLogger::PKT_SENT ? "-1" : to_string(delay);
+  resLogger.CreateEntry(nodeId, seqNo, eventType, to_string(header.GetSrc()), to_string(header.GetLastHop()), delayStr, to_string(header.GetNumHops()));
+}
 
-  string type = "PktRcvd";
-  resLogger.CreateEntry(nodeId, seqNo, type, to_string(src), to_string(lastHop), to_string(delay), to_string(numHops));
-  // uint32_t node_id, string eventType, string src, string lastHop, string delay, string numHops
+void OnPacketReceive(std::string context, Ptr<const Packet> pkt, uint32_t nodeId)
+{
+  LogEvent(pkt, nodeId, BinaryTraceLogger::PKT_RCVD);
 }
 
 void OnPacketSent(std::string context, Ptr<const Packet> pkt, uint32_t nodeId)
 {
-  ContentionBasedFloodingHeader header;
-  pkt->PeekHeader(header);
-
-  uint32_t src = header.GetSrc();
-  uint32_t lastHop = header.GetLastHop();
-  uint32_t numHops = header.GetNumHops();
-
-  string seqNo = to_string(src) + "-" + to_string(header.GetSeq());
-
-  string type = "PktSent";
-  resLogger.CreateEntry(nodeId, seqNo, type, to_string(src), to_string(lastHop), "-1", to_string(numHops));
+  LogEvent(pkt, nodeId, BinaryTraceLogger::PKT_SENT);
 }
 
 void OnPacketForward(std::string context, Ptr<const Packet> pkt, uint32_t nodeId)
 {
-  ContentionBasedFloodingHeader header;
-  pkt->PeekHeader(header);
-
-  double current = Simulator::Now().GetSeconds();
-  double sent = header.GetTs().GetSeconds();
-  double delay = (current - sent) * 1000;
-
-  uint32_t src = header.GetSrc();
-  uint32_t lastHop = header.GetLastHop();
-  uint32_t numHops = header.GetNumHops();
-
-  string seqNo = to_string(src) + "-" + to_string(header.GetSeq());
-
-  string type = "PktFwd";
-  resLogger.CreateEntry(nodeId, seqNo, type, to_string(src), to_string(lastHop), to_string(delay), to_string(numHops));
+  LogEvent(pkt, nodeId, BinaryTraceLogger::PKT_FWD);
 }
 
 void LogProgress()
@@ -99,165 +85,123 @@ void LogProgress()
   Simulator::Schedule(Seconds(5), &LogProgress);
 }
 
-void GetKPIs(NodeContainer c, int numNodes)
+void OnKpiSnapshot(const FloodingStatsSnapshot &snapshot)
 {
-
-  double sumNodesSeen = 0;
-  double sumInTime = 0;
-  double sumLate = 0;
-
-  double sumSent = 0;
-  double sumRcvd = 0;
-  double sumFwd = 0;
-  for (int i = 0; i < numNodes; i++)
-  {
-    auto rdfApp = c.Get(i)->GetApplication(0)->GetObject<RateDecayFloodingApp>();
-    sumNodesSeen += rdfApp->GetNumSeenNodes();
-    sumInTime += rdfApp->GetNumUpdatesReceivedInTime();
-    sumLate += rdfApp->GetNumUpdatesReceivedLate();
-
-    sumSent += rdfApp->GetNumSent();
-    sumRcvd += rdfApp->GetNumRcvd();
-    sumFwd += rdfApp->GetNumFwd();
-  }
-
-  double pd = sumNodesSeen / (numNodes * (numNodes - 1));
-  double pe500 = sumLate / (sumInTime + sumLate);
-  kpiLogger.CreateEntry(pd, pe500, sumSent, sumRcvd, sumFwd);
-  NS_LOG_UNCOND(Simulator::Now().As(Time::S) << " P_D = " << pd << ", P_EX = " << pe500);
+  kpiSeriesLogger.CreateEntry(snapshot);
 }
 
-void ResetStats(Ptr<RateDecayFloodingApp> app)
+void GetKPIs(Ptr<FloodingStats> stats, Ptr<FloodingConvergenceMonitor> monitor)
 {
-  app->ResetStats();
+  RdfKpis kpis = CollectRdfKpis(stats, monitor);
+  kpiLogger.CreateEntry(kpis.pd, kpis.pe500, kpis.sumSent, kpis.sumRcvd, kpis.sumFwd, kpis.stopReason);
+  NS_LOG_UNCOND(Simulator::Now().As(Time::S) << " P_D = " << kpis.pd << ", P_EX = " << kpis.pe500);
 }
 
 int main(int argc, char *argv[])
 {
   NS_LOG_UNCOND("START");
-  double simTime = 180;      // seconds
-  uint32_t packetSize = 100; // bytes
-  uint32_t seed = 0;
-  int numNodes = 10;
+  RdfScenarioParams params;
   int version = 12;
-  double interval = 1; // seconds
-  double decayFactor = 1.0;
-  double size = 0;
-  double speedMin = -1.0;
-  double speedMax = -1.0;
   bool tracing = false;
+  string traceFormat = "csv";
 
   CommandLine cmd(__FILE__);
-  cmd.AddValue("packetSize", "size of application packet sent", packetSize);
-  cmd.AddValue("interval", "interval (seconds) between packets", interval);
-  cmd.AddValue("seed", "seed", seed);
-  cmd.AddValue("numNodes", "numNodes", numNodes);
-  cmd.AddValue("size", "size", size);
-  cmd.AddValue("decayFactor", "decayFactor", decayFactor);
+  cmd.AddValue("packetSize", "size of application packet sent", params.packetSize);
+  cmd.AddValue("interval", "interval (seconds) between packets", params.interval);
+  cmd.AddValue("seed", "seed", params.seed);
+  cmd.AddValue("numNodes", "numNodes", params.numNodes);
+  cmd.AddValue("size", "size", params.size);
+  cmd.AddValue("decayFactor", "decayFactor", params.decayFactor);
   cmd.AddValue("v", "v", version);
-  cmd.AddValue("simTime", "simTime", simTime);
-  cmd.AddValue("speedMax", "speedMax", speedMax);
-  cmd.AddValue("speedMin", "speedMin", speedMin);
+  cmd.AddValue("simTime", "simTime", params.simTime);
+  cmd.AddValue("speedMax", "speedMax", params.speedMax);
+  cmd.AddValue("speedMin", "speedMin", params.speedMin);
   cmd.AddValue("tracing", "tracing", tracing);
+  cmd.AddValue("compactHeader", "use the compact format of the flooding header", compactHeader);
+  cmd.AddValue("traceFormat", "format of the packet event trace (csv or bin)", traceFormat);
+  cmd.AddValue("kpiInterval", "seconds between two rows of the KPI time series, 0 disables it", params.kpiInterval);
+  cmd.AddValue("convergenceThreshold", "stop once the relative CI half-width of pd and pe500 is below this, 0 runs for simTime", params.convergenceThreshold);
+#ifdef NS3_MPI
+  bool distributed = false;
+  cmd.AddValue("distributed", "split the area over the MPI ranks, run with mpirun", distributed);
+#endif
   cmd.Parse(argc, argv);
 
-  kpiLogger.SetFile("res/v" + to_string(version) + "/kpi_rdf_n" + to_string(numNodes) + "_i" + to_string(int(interval * 1000)) + "_q" + to_string(int(decayFactor * 100)) + "_r" + to_string(seed) + ".csv");
+  // Traces are written per rank, the KPIs of all ranks only by the first one
+  string rankSuffix;
+  bool kpiWriter = true;
+#ifdef NS3_MPI
+  if (distributed)
+  {
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(&argc, &argv);
+    rankSuffix = "_rank" + to_string(MpiInterface::GetSystemId());
+    kpiWriter = MpiInterface::GetSystemId() == 0;
+  }
+#endif
 
-  if (tracing)
+  string runName = "rdf_n" + to_string(params.numNodes) + "_i" + to_string(int(params.interval * 1000)) + "_q" + to_string(int(params.decayFactor * 100)) + "_r" + to_string(params.seed);
+  if (kpiWriter)
   {
-    resLogger.SetFile("res/v" + to_string(version) + "/rdf_n" + to_string(numNodes) + "_i" + to_string(int(interval * 1000)) + "_q" + to_string(int(decayFactor * 100)) + "_r" + to_string(seed) + ".csv");
-    courseLogger.SetFile("res/v" + to_string(version) + "/course_rdf_n" + to_string(numNodes) + "_i" + to_string(int(interval * 1000)) + "_q" + to_string(int(decayFactor * 100)) + "_r" + to_string(seed) + ".csv");
+    kpiLogger.SetFile("res/v" + to_string(version) + "/kpi_" + runName + ".csv");
   }
-  ns3::SeedManager::SetSeed(seed + 10);
 
-  // Convert to time object
-  Time interPacketInterval = Seconds(interval);
+  NS_ABORT_MSG_IF(traceFormat != "csv" && traceFormat != "bin", "Unknown trace format " << traceFormat << ", use csv or bin");
+  if (tracing)
+  {
+    binaryTrace = traceFormat == "bin";
+    string eventFile = "res/v" + to_string(version) + "/" + runName + rankSuffix;
+    if (binaryTrace)
+    {
+      binResLogger.SetFile(eventFile + ".bin");
+    }
+    else
+    {
+      resLogger.SetFile(eventFile + ".csv");
+    }
+    courseLogger.SetFile("res/v" + to_string(version) + "/course_" + runName + rankSuffix + ".csv");
+  }
 
+  Config::SetDefault("ns3::RateDecayFloodingApp::CompactHeader", BooleanValue(compactHeader));
   NodeContainer c;
-  c.Create(numNodes);
-
-  // The below set of helpers will help us to put together the wifi NICs we want
-  WifiHelper wifi;
-
-  string phyMode = "OfdmRate3MbpsBW10MHz"; // OfdmRate3MbpsBW10MHz
-  wifi.SetStandard(WIFI_STANDARD_80211p);
-
-  // Fix non-unicast data rate to be the same as that of unicast
-  Config::SetDefault("ns3::WifiRemoteStationManager::NonUnicastMode", StringValue(phyMode));
-
-  YansWifiPhyHelper wifiPhy;
-  wifiPhy.Set("RxGain", DoubleValue(0));
-  wifiPhy.Set("RxSensitivity", DoubleValue(-85));
-  wifiPhy.Set("ChannelWidth", UintegerValue(10));
-  wifiPhy.Set("TxPowerStart", DoubleValue(20));
-  wifiPhy.Set("TxPowerEnd", DoubleValue(20));
-  // ns-3 supports RadioTap and Prism tracing extensions for 802.11b
-  // wifiPhy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
-
-  YansWifiChannelHelper wifiChannel;
-  wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-  wifiChannel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.90e9));
-  wifiPhy.SetChannel(wifiChannel.Create());
-
-  // Add a mac and disable rate control
-  WifiMacHelper wifiMac;
-  wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager", "DataMode", StringValue(phyMode), "ControlMode", StringValue(phyMode));
-  // Set it to adhoc mode
-  wifiMac.SetType("ns3::AdhocWifiMac");
-  NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, c);
+  Ptr<FloodingStats> stats = BuildRdfScenario(c, params);
+  Ptr<FloodingConvergenceMonitor> monitor = MonitorRdfConvergence(stats, params);
 
-  ObjectFactory pos;
-  pos.SetTypeId("ns3::RandomRectanglePositionAllocator");
-  pos.Set("X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + to_string(size) + "]"));
-  pos.Set("Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + to_string(size) + "]"));
-
-  Ptr<PositionAllocator> posAlloc = pos.Create()->GetObject<PositionAllocator>();
-
-  MobilityHelper mobility;
-
-  mobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
-                            "Bounds", RectangleValue(Rectangle(0, size, 0, size)),
-                            "Speed", StringValue("ns3::UniformRandomVariable[Min=" + to_string(speedMin) + "|Max=" + to_string(speedMax) + "]"),
-                            "Pause", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
-
-  mobility.SetPositionAllocator(posAlloc);
-  mobility.Install(c);
-
-  InternetStackHelper internet;
-  internet.Install(c);
-
-  Ipv4AddressHelper ipv4;
-  NS_LOG_INFO("Assign IP Addresses.");
-  ipv4.SetBase("10.1.0.0", "255.255.0.0");
-  Ipv4InterfaceContainer i = ipv4.Assign(devices);
-
-  RateDecayFloodingAppHelper client(3000, interPacketInterval, Seconds(0.01), packetSize, 509.003, decayFactor);
-
-  Ptr<UniformRandomVariable> startTimeRNG = CreateObject<UniformRandomVariable>();
-
-  for (int i = 0; i < numNodes; i++)
+  if (params.kpiInterval > 0)
   {
-    ApplicationContainer apps = client.Install(c.Get(i));
-    apps.Start(Seconds(startTimeRNG->GetValue(0.0, 5.0))); //
-    Simulator::ScheduleWithContext(c.Get(i)->GetId(), Seconds(5.0), &ResetStats, c.Get(i)->GetApplication(0)->GetObject<RateDecayFloodingApp>());
-    if(tracing){
-      Simulator::ScheduleWithContext(c.Get(i)->GetId(), Seconds(0), &CourseChange, c.Get(i)->GetObject<MobilityModel>(), c.Get(i)->GetId());
-    }
+    kpiSeriesLogger.SetFile("res/v" + to_string(version) + "/kpi_ts_" + runName + rankSuffix + ".csv");
+    stats->TraceConnectWithoutContext("Snapshot", MakeCallback(&OnKpiSnapshot));
   }
 
   if (tracing)
   {
+    for (uint32_t i = 0; i < c.GetN(); i++)
+    {
+      if (!IsRdfLocal(c.Get(i)))
+      {
+        continue;
+      }
+      courseLogger.Track(c.Get(i)->GetId(), c.Get(i)->GetObject<MobilityModel>());
+    }
+    // Only the nodes simulated by this rank have an application
     Config::Connect("/NodeList/*/ApplicationList/0/$ns3::RateDecayFloodingApp/Rx", MakeCallback(&OnPacketReceive));
     Config::Connect("/NodeList/*/ApplicationList/0/$ns3::RateDecayFloodingApp/Tx", MakeCallback(&OnPacketSent));
     Config::Connect("/NodeList/*/ApplicationList/0/$ns3::RateDecayFloodingApp/Fwd", MakeCallback(&OnPacketForward));
   }
 
-  Simulator::Stop(Seconds(simTime));
+  Simulator::Stop(Seconds(params.simTime));
   Simulator::Run();
 
-  GetKPIs(c, numNodes);
+  GetKPIs(stats, monitor);
+  binResLogger.Flush();
 
   Simulator::Destroy();
+#ifdef NS3_MPI
+  if (distributed)
+  {
+    MpiInterface::Disable();
+  }
+#endif
   NS_LOG_UNCOND("END");
 
   return 0;
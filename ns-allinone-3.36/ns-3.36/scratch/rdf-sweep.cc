@@ -0,0 +1,264 @@
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+#include "ns3/command-line.h"
+#include "RdfScenario.h"
+
+using namespace ns3;
+using namespace std;
+
+NS_LOG_COMPONENT_DEFINE("RdfSweep");
+
+/*
+ * Runs a whole rate decay flooding parameter sweep from one process.
+ *
+ * The grid file is a CSV file with the header run,numNodes,interval,q and
+ * optionally size,simTime. Missing sizes and simulation times are derived
+ * like in run_rdf_experiment.py. Every point runs in a forked worker, so the
+ * simulator singleton, the node list and the random streams of one run never
+ * leak into another, while type registration and library loading happen only
+ * once. Results are appended to a single KPI table as soon as a worker
+ * finishes; points already in the table are skipped, so a sweep can be
+ * resumed. Interval and decay factor are stored in ms and percent, like in the
+ * kpi_rdf_* file names. With --convergenceThreshold, points stop early once
+ * their KPIs converged; stopReason and stopTime record when and why.
+ *
+ * Usage: ./ns3 run "rdf-sweep --grid=grid.csv --out=res/v43/kpi_rdf.csv --workers=8"
+ */
+
+struct SweepPoint {
+  RdfScenarioParams params;
+  string key;
+};
+
+string MakeKey(int run, int numNodes, double interval, double q)
+{
+  // Same rounding as the file names of the single runs
+  return to_string(run) + "," + to_string(numNodes) + "," + to_string(int(round(interval * 1000))) + "," + to_string(int(round(q * 100)));
+}
+
+vector<string> SplitLine(const string &line)
+{
+  vector<string> fields;
+  stringstream ss(line);
+  string field;
+  while (getline(ss, field, ','))
+  {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+vector<SweepPoint> ReadGrid(const string &file, double density, double warmup, double speedMin, double speedMax)
+{
+  ifstream input(file);
+  NS_ABORT_MSG_UNLESS(input.is_open(), "Cannot open grid file " << file);
+
+  string line;
+  getline(input, line);
+  vector<string> header = SplitLine(line);
+  map<string, size_t> column;
+  for (size_t i = 0; i < header.size(); i++)
+  {
+    column[header[i]] = i;
+  }
+  for (const string name : {"run", "numNodes", "interval", "q"})
+  {
+    NS_ABORT_MSG_UNLESS(column.count(name), "Grid file " << file << " has no column " << name);
+  }
+
+  vector<SweepPoint> points;
+  while (getline(input, line))
+  {
+    if (line.empty())
+    {
+      continue;
+    }
+    vector<string> fields = SplitLine(line);
+    NS_ABORT_MSG_UNLESS(fields.size() == header.size(), "Malformed grid line: " << line);
+
+    SweepPoint point;
+    point.params.seed = stoul(fields[column["run"]]);
+    point.params.numNodes = stoi(fields[column["numNodes"]]);
+    point.params.interval = stod(fields[column["interval"]]);
+    point.params.decayFactor = stod(fields[column["q"]]);
+    point.params.speedMin = speedMin;
+    point.params.speedMax = speedMax;
+    point.params.size = column.count("size") ? stod(fields[column["size"]]) : sqrt(point.params.numNodes / density) * 1000;
+    point.params.simTime = column.count("simTime") ? stod(fields[column["simTime"]]) : point.params.size / speedMax + warmup;
+    point.key = MakeKey(point.params.seed, point.params.numNodes, point.params.interval, point.params.decayFactor);
+    points.push_back(point);
+  }
+  return points;
+}
+
+set<string> ReadFinishedPoints(const string &file)
+{
+  set<string> finished;
+  ifstream input(file);
+  string line;
+  if (!getline(input, line))
+  {
+    return finished;
+  }
+  while (getline(input, line))
+  {
+    vector<string> fields = SplitLine(line);
+    if (fields.size() >= 4)
+    {
+      finished.insert(fields[0] + "," + fields[1] + "," + fields[2] + "," + fields[3]);
+    }
+  }
+  return finished;
+}
+
+void RunWorker(const SweepPoint &point, int fd)
+{
+  RdfKpis kpis = RunRdfScenario(point.params);
+
+  stringstream row;
+  row.precision(10);
+  row << point.key << ","
+      << point.params.size << ","
+      << point.params.simTime << ","
+      << kpis.pd << ","
+      << kpis.pe500 << ","
+      << kpis.sumSent << ","
+      << kpis.sumRcvd << ","
+      << kpis.sumFwd << ","
+      << kpis.stopReason << ","
+      << kpis.stopTime << "\n";
+  string data = row.str();
+  // A row is far below PIPE_BUF, so the write is atomic
+  ssize_t written = write(fd, data.data(), data.size());
+  close(fd);
+  _exit(written == ssize_t(data.size()) ? 0 : 1);
+}
+
+int main(int argc, char *argv[])
+{
+  string gridFile = "grid.csv";
+  string outFile = "kpi_rdf.csv";
+  uint32_t workers = 1;
+  double density = 12;
+  double warmup = 5;
+  double speedMin = 22.2;
+  double speedMax = 33.3;
+  double convergenceThreshold = 0;
+
+  CommandLine cmd(__FILE__);
+  cmd.AddValue("grid", "CSV file with the parameter points (run,numNodes,interval,q[,size,simTime])", gridFile);
+  cmd.AddValue("out", "CSV file the KPIs of all points are appended to", outFile);
+  cmd.AddValue("workers", "number of simulations run in parallel", workers);
+  cmd.AddValue("density", "nodes per km^2, used when the grid has no size column", density);
+  cmd.AddValue("warmup", "seconds added to the derived simTime", warmup);
+  cmd.AddValue("speedMin", "speedMin", speedMin);
+  cmd.AddValue("speedMax", "speedMax", speedMax);
+  cmd.AddValue("convergenceThreshold", "stop a point once the relative CI half-width of pd and pe500 is below this, 0 runs for simTime", convergenceThreshold);
+  cmd.Parse(argc, argv);
+
+  NS_ABORT_MSG_IF(workers == 0, "At least one worker is needed");
+
+  vector<SweepPoint> points = ReadGrid(gridFile, density, warmup, speedMin, speedMax);
+  for (SweepPoint &point : points)
+  {
+    point.params.convergenceThreshold = convergenceThreshold;
+  }
+  set<string> finished = ReadFinishedPoints(outFile);
+
+  bool createHeader = finished.empty();
+  ofstream output(outFile, ios::app);
+  NS_ABORT_MSG_UNLESS(output.is_open(), "Cannot open output file " << outFile);
+  if (createHeader)
+  {
+    output << "run,numNodes,intervalMs,decayFactorPct,size,simTime,pd,pe500,sumSent,sumRcvd,sumFwd,stopReason,stopTime" << endl;
+  }
+
+  vector<const SweepPoint *> pending;
+  for (const SweepPoint &point : points)
+  {
+    if (!finished.count(point.key))
+    {
+      pending.push_back(&point);
+    }
+  }
+  // Progress goes to stdout, NS_LOG is compiled out of optimized builds
+  cout << "Running " << pending.size() << " of " << points.size() << " points on " << workers << " workers" << endl;
+
+  // Worker pid -> (point, read end of its result pipe)
+  map<pid_t, pair<const SweepPoint *, int>> running;
+  size_t next = 0;
+  size_t done = 0;
+  size_t failed = 0;
+  while (next < pending.size() || !running.empty())
+  {
+    while (next < pending.size() && running.size() < workers)
+    {
+      int fds[2];
+      NS_ABORT_MSG_IF(pipe(fds) != 0, "pipe() failed");
+      const SweepPoint *point = pending[next++];
+      pid_t pid = fork();
+      NS_ABORT_MSG_IF(pid < 0, "fork() failed");
+      if (pid == 0)
+      {
+        close(fds[0]);
+        RunWorker(*point, fds[1]);
+      }
+      close(fds[1]);
+      running[pid] = make_pair(point, fds[0]);
+    }
+
+    int status;
+    pid_t pid;
+    do
+    {
+      pid = waitpid(-1, &status, 0);
+    } while (pid < 0 && errno == EINTR);
+    NS_ABORT_MSG_IF(pid < 0, "waitpid() failed: " << strerror(errno));
+    auto it = running.find(pid);
+    if (it == running.end())
+    {
+      // Not one of the workers, e.g. a child of a library
+      continue;
+    }
+
+    const SweepPoint *point = it->second.first;
+    int fd = it->second.second;
+    running.erase(it);
+
+    string row;
+    char buffer[512];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+      row.append(buffer, n);
+    }
+    close(fd);
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && !row.empty())
+    {
+      output << row << flush;
+      done++;
+    }
+    else
+    {
+      failed++;
+      cerr << "Point " << point->key << " failed with status " << status << endl;
+    }
+    cout << done + failed << "/" << pending.size() << " " << point->key << endl;
+  }
+
+  cout << "END " << done << " done, " << failed << " failed" << endl;
+  return failed == 0 ? 0 : 1;
+}
@@ -79,6 +79,25 @@ PureFloodingAppHelper::InstallPriv (Ptr<Node> node) const
   return app;
 }
 
+int64_t
+PureFloodingAppHelper::AssignStreams (NodeContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = (*i);
+      for (uint32_t j = 0; j < node->GetNApplications (); j++)
+        {
+          Ptr<PureFloodingApp> app = DynamicCast<PureFloodingApp> (node->GetApplication (j));
+          if (app)
+            {
+              currentStream += app->AssignStreams (currentStream);
+            }
+        }
+    }
+  return (currentStream - stream);
+}
+
 ContentionBasedFloodingAppHelper::ContentionBasedFloodingAppHelper (uint16_t port, Time sendInterval, Time forwardingJitter, uint32_t packetSize, double maxDistance)
 {
   m_factory.SetTypeId (ContentionBasedFloodingApp::GetTypeId ());
@@ -81,6 +81,19 @@ public:
    */
   ApplicationContainer Install (NodeContainer c) const;
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by the PureFloodingApp of each node.  Return the number of streams
+   * that have been assigned.  The Install() method should have previously
+   * been called by the user.
+   *
+   * \param c NodeContainer of the set of nodes for which the PureFloodingApp
+   *          should be modified to use a fixed stream
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (NodeContainer c, int64_t stream);
+
 private:
   /**
    * Install an ns3::UdpEchoServer on the node configured with all the
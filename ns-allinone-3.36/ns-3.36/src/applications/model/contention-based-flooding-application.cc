@@ -29,6 +29,8 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/vector.h"
 #include "ns3/mobility-module.h"
 
 #include "contention-based-flooding-application.h"
@@ -69,6 +71,26 @@ namespace ns3
                                               DoubleValue(500.0),
                                               MakeDoubleAccessor(&ContentionBasedFloodingApp::m_maxDistance),
                                               MakeDoubleChecker<double>(0.0))
+                                .AddAttribute("DuplicateWindowSize", "Number of sequence numbers per source tracked for duplicate detection (multiple of 64)",
+                                              UintegerValue(256),
+                                              MakeUintegerAccessor(&ContentionBasedFloodingApp::m_duplicateWindowSize),
+                                              MakeUintegerChecker<uint32_t>(64))
+                                .AddAttribute("DuplicateMaxAge", "Time after which a silent source is removed from the duplicate detection",
+                                              TimeValue(Seconds(60)),
+                                              MakeTimeAccessor(&ContentionBasedFloodingApp::m_duplicateMaxAge),
+                                              MakeTimeChecker())
+                                .AddAttribute("PositionCacheEnabled", "If true, the own position is read from the NodePositionCache instead of the aggregated mobility model",
+                                              BooleanValue(false),
+                                              MakeBooleanAccessor(&ContentionBasedFloodingApp::m_positionCacheEnabled),
+                                              MakeBooleanChecker())
+                                .AddAttribute("CompactHeader", "If true, packets carry the compact format of the ContentionBasedFloodingHeader (all nodes must agree)",
+                                              BooleanValue(false),
+                                              MakeBooleanAccessor(&ContentionBasedFloodingApp::m_compactHeader),
+                                              MakeBooleanChecker())
+                                .AddAttribute("CompactHeaderOrigin", "Origin of the 16-bit positions of the compact header",
+                                              VectorValue(Vector(0, 0, 0)),
+                                              MakeVectorAccessor(&ContentionBasedFloodingApp::m_compactHeaderOrigin),
+                                              MakeVectorChecker())
                                 .AddTraceSource("Rx", "A packet has been received",
                                                 MakeTraceSourceAccessor(&ContentionBasedFloodingApp::m_rxTrace),
                                                 "ns3::Packet::TracedCallback")
@@ -100,6 +122,7 @@ namespace ns3
     ContentionBasedFloodingApp::DoDispose(void)
     {
         NS_LOG_FUNCTION(this);
+        m_stats = 0;
         Application::DoDispose();
     }
 
@@ -108,6 +131,11 @@ namespace ns3
     {
         NS_LOG_FUNCTION(this);
 
+        m_seenPackets.SetWindowSize(m_duplicateWindowSize);
+        m_seenPackets.SetMaxAge(m_duplicateMaxAge);
+        m_twiceSeenPackets.SetWindowSize(m_duplicateWindowSize);
+        m_twiceSeenPackets.SetMaxAge(m_duplicateMaxAge);
+
         if (m_socket == 0)
         {
             TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
@@ -159,12 +187,16 @@ namespace ns3
         m_sendEvent = Simulator::Schedule(dt, &ContentionBasedFloodingApp::Send, this);
     }
 
-    void ContentionBasedFloodingApp::Forward(Ptr<Packet> packet, string pkt_id)
+    void ContentionBasedFloodingApp::Forward(Ptr<Packet> packet, uint64_t pktKey)
     {
-        if (std::find(twiceSeenSeqNos.begin(), twiceSeenSeqNos.end(), pkt_id) == twiceSeenSeqNos.end())
+        if (!m_twiceSeenPackets.Contains(pktKey))
         {
             m_socket->Send(packet);
             m_fwdTrace(packet, GetNode()->GetId());
+            if (m_stats)
+            {
+                m_stats->NotifyForwarded(GetNode()->GetId());
+            }
         }
     }
 
@@ -180,9 +212,10 @@ namespace ns3
         Ptr<Packet> p = Create<Packet>(m_dataSize);
         uint32_t nodeId = GetNode()->GetId();
 
-        Vector nodePos = GetNode()->GetObject<MobilityModel>()->GetPosition();
+        Vector nodePos = GetOwnPosition();
 
         ContentionBasedFloodingHeader header;
+        header.SetCompact(m_compactHeader, m_compactHeaderOrigin);
         header.SetSeq(this->seqNo++);
         header.SetSrc(nodeId);
         header.SetLastHop(nodeId);
@@ -190,11 +223,24 @@ namespace ns3
         header.SetStartPos(nodePos);
         p->AddHeader(header);
         m_txTrace(p, GetNode()->GetId());
+        if (m_stats)
+        {
+            m_stats->NotifySent(nodeId);
+        }
         m_socket->Send(p);
         ScheduleTransmit(m_sendInterval);
 
-        string pkt_id = to_string(GetNode()->GetId()) + "-" + to_string(header.GetSeq());
-        seenSeqNos.push_back(pkt_id);
+        m_seenPackets.Insert(FloodingDuplicateCache::MakeKey(nodeId, header.GetSeq()));
+    }
+
+    Vector
+    ContentionBasedFloodingApp::GetOwnPosition(void) const
+    {
+        if (m_positionCacheEnabled)
+        {
+            return NodePositionCache::Get()->GetPosition(GetNode()->GetId());
+        }
+        return GetNode()->GetObject<MobilityModel>()->GetPosition();
     }
 
     void
@@ -208,27 +254,45 @@ namespace ns3
         while ((packet = socket->RecvFrom(from)))
         {
             socket->GetSockName(localAddress);
-            Ptr<Packet> packetCopy = packet->Copy();
-            packetCopy->RemoveAllPacketTags();
-            packetCopy->RemoveAllByteTags();
             ContentionBasedFloodingHeader header;
-            packetCopy->RemoveHeader(header);
+            header.SetCompact(m_compactHeader, m_compactHeaderOrigin);
+            uint32_t headerSize = packet->PeekHeader(header);
 
-            Vector nodePos = GetNode()->GetObject<MobilityModel>()->GetPosition();
-            double dist_sender = CalculateDistance(header.GetStartPos(), nodePos);
-            double dist_sender_lastHop = CalculateDistance(header.GetStartPos(), header.GetLastPos());
-            double advance = dist_sender - dist_sender_lastHop;
+            // Duplicates are counted before the packet is copied
+            uint64_t pktKey = FloodingDuplicateCache::MakeKey(header.GetSrc(), header.GetSeq());
 
-            header.SetNumHops(header.GetNumHops() + 1);
-            header.SetLastHop(GetNode()->GetId());
-            header.SetLastPos(nodePos);
+            if (m_seenPackets.Insert(pktKey))
+            {
+                Vector nodePos = GetOwnPosition();
+                double dist_sender = CalculateDistance(header.GetStartPos(), nodePos);
+                double dist_sender_lastHop = CalculateDistance(header.GetStartPos(), header.GetLastPos());
+                double advance = dist_sender - dist_sender_lastHop;
 
-            packetCopy->AddHeader(header);
+                header.SetNumHops(header.GetNumHops() + 1);
+                header.SetLastHop(GetNode()->GetId());
+                header.SetLastPos(nodePos);
 
-            string pkt_id = to_string(header.GetSrc()) + "-" + to_string(header.GetSeq());
+                Ptr<Packet> packetCopy = packet->Copy();
+                packetCopy->RemoveAllPacketTags();
+                packetCopy->RemoveAllByteTags();
+                packetCopy->PatchHeader(header, headerSize);
 
-            if (std::find(seenSeqNos.begin(), seenSeqNos.end(), pkt_id) == seenSeqNos.end())
-            {
+                if (m_stats)
+                {
+                    uint32_t src = header.GetSrc();
+                    if (m_sources.MarkSeen(src))
+                    {
+                        m_stats->NotifySeenNode(GetNode()->GetId());
+                    }
+                    Time lastReceived;
+                    if (m_sources.GetLastReceived(src, lastReceived) && dist_sender <= m_maxDistance)
+                    {
+                        Time aoi = Simulator::Now() - lastReceived;
+                        m_stats->NotifyUpdate(GetNode()->GetId(), aoi, aoi > m_aoiThreshold);
+                    }
+                    m_sources.SetLastReceived(src, header.GetTs());
+                    m_stats->NotifyReceived(GetNode()->GetId());
+                }
                 m_rxTrace(packet, GetNode()->GetId());
                 m_rxTraceWithAddresses(packet, from, localAddress);
                 double scale = (1.0 - (advance / m_maxDistance));
@@ -239,17 +303,19 @@ namespace ns3
                 }
 
                 Time delay = m_forwardingJitter * scale;
-                Simulator::Schedule(delay, &ContentionBasedFloodingApp::Forward, this, packetCopy, pkt_id);
-                seenSeqNos.push_back(pkt_id);
+                Simulator::Schedule(delay, &ContentionBasedFloodingApp::Forward, this, packetCopy, pktKey);
             }
             else
             {
-                if (std::find(twiceSeenSeqNos.begin(), twiceSeenSeqNos.end(), pkt_id) == twiceSeenSeqNos.end())
-                {
-                    twiceSeenSeqNos.push_back(pkt_id);
-                }
+                m_twiceSeenPackets.Insert(pktKey);
             }
         }
     }
 
+    void ContentionBasedFloodingApp::SetStats(Ptr<FloodingStats> stats)
+    {
+        m_stats = stats;
+        m_stats->AddNode(GetNode()->GetId());
+    }
+
 } // Namespace ns3
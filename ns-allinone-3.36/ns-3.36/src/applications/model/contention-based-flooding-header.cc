@@ -3,6 +3,8 @@
 #include "ns3/header.h"
 #include "ns3/simulator.h"
 #include "contention-based-flooding-header.h"
+#include <algorithm>
+#include <cmath>
 
 namespace ns3
 {
@@ -79,6 +81,17 @@ namespace ns3
         return seq;
     }
 
+    void ContentionBasedFloodingHeader::SetCompact(bool compact, Vector origin)
+    {
+        this->compact = compact;
+        this->origin = origin;
+    }
+
+    bool ContentionBasedFloodingHeader::IsCompact(void) const
+    {
+        return compact;
+    }
+
     Time ContentionBasedFloodingHeader::GetTs(void) const
     {
         return TimeStep(ts);
@@ -105,6 +118,16 @@ namespace ns3
     uint32_t ContentionBasedFloodingHeader::GetSerializedSize(void) const
     {
         NS_LOG_FUNCTION(this);
+        if (compact)
+        {
+            return GetVarintSize(seq)
+                   + 5      // low 40 bits of ts
+                   + GetVarintSize(src)
+                   + GetVarintSize(lastHop)
+                   + GetVarintSize(numHops)
+                   + 3 * 2  // startPos
+                   + 3 * 2; // lastPos
+        }
         return 4        // seq
                + 8      // ts
                + 8      // src
@@ -118,6 +141,18 @@ namespace ns3
     {
         NS_LOG_FUNCTION(this << &start);
         Buffer::Iterator i = start;
+        if (compact)
+        {
+            WriteVarint(i, seq);
+            i.WriteU8((ts >> 32) & 0xff);
+            i.WriteHtonU32(ts & 0xffffffff);
+            WriteVarint(i, src);
+            WriteVarint(i, lastHop);
+            WriteVarint(i, numHops);
+            WriteCompactPos(i, start_pos);
+            WriteCompactPos(i, last_pos);
+            return;
+        }
         i.WriteHtonU32(seq);
         i.WriteHtonU64(ts);
         i.WriteHtonU32(src);
@@ -145,6 +180,22 @@ namespace ns3
     {
         NS_LOG_FUNCTION(this << &start);
         Buffer::Iterator i = start;
+        if (compact)
+        {
+            seq = ReadVarint(i);
+            uint64_t low = uint64_t(i.ReadU8()) << 32;
+            low |= i.ReadNtohU32();
+            // The timestamp is the latest time not after now with the same low bits
+            const uint64_t mask = (uint64_t(1) << 40) - 1;
+            uint64_t now = Simulator::Now().GetTimeStep();
+            ts = now - ((now - low) & mask);
+            src = ReadVarint(i);
+            lastHop = ReadVarint(i);
+            numHops = ReadVarint(i);
+            start_pos = ReadCompactPos(i);
+            last_pos = ReadCompactPos(i);
+            return GetSerializedSize();
+        }
         seq = i.ReadNtohU32();
         ts = i.ReadNtohU64();
         src = i.ReadNtohU32();
@@ -164,4 +215,57 @@ namespace ns3
         return GetSerializedSize();
     }
 
+    uint32_t ContentionBasedFloodingHeader::GetVarintSize(uint32_t value)
+    {
+        uint32_t size = 1;
+        while (value >= 0x80)
+        {
+            value >>= 7;
+            size++;
+        }
+        return size;
+    }
+
+    void ContentionBasedFloodingHeader::WriteVarint(Buffer::Iterator &i, uint32_t value)
+    {
+        // Seven bits per byte, least significant first, high bit set on all but the last byte
+        while (value >= 0x80)
+        {
+            i.WriteU8((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        i.WriteU8(value);
+    }
+
+    uint32_t ContentionBasedFloodingHeader::ReadVarint(Buffer::Iterator &i)
+    {
+        uint32_t value = 0;
+        for (uint32_t shift = 0; shift < 35; shift += 7)
+        {
+            uint8_t byte = i.ReadU8();
+            value |= uint32_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+        return value;
+    }
+
+    void ContentionBasedFloodingHeader::WriteCompactPos(Buffer::Iterator &i, const Vector &pos) const
+    {
+        for (double offset : {pos.x - origin.x, pos.y - origin.y, pos.z - origin.z})
+        {
+            i.WriteHtonU16(std::min(std::max(std::floor(offset), 0.0), 65535.0));
+        }
+    }
+
+    Vector ContentionBasedFloodingHeader::ReadCompactPos(Buffer::Iterator &i) const
+    {
+        double x = origin.x + i.ReadNtohU16();
+        double y = origin.y + i.ReadNtohU16();
+        double z = origin.z + i.ReadNtohU16();
+        return Vector(x, y, z);
+    }
+
 } // namespace ns3
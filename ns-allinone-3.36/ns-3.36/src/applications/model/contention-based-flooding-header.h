@@ -28,6 +28,23 @@
 
 namespace ns3
 {
+    /**
+     * \ingroup applications
+     * \brief Header of the contention-based and rate decay flooding packets
+     *
+     * The header has two serialized formats. The full format writes every
+     * field with a fixed width. The compact format, selected with
+     * SetCompact(), writes the sequence number, the node ids and the hop
+     * count as varints, the positions as 16-bit offsets in meters from an
+     * origin, and the low 40 bits of the timestamp. The receiver restores
+     * the timestamp as the latest time at or before its current time with
+     * these low bits, which is exact for packets younger than 2^40 time
+     * steps (18 minutes with the default nanosecond resolution). Positions
+     * are truncated to whole meters in both formats; in the compact format
+     * they are clamped to [origin, origin + 65535 m] on each axis.
+     *
+     * Sender and receivers must use the same format and origin.
+     */
     class ContentionBasedFloodingHeader : public Header
     {
     public:
@@ -49,6 +66,18 @@ namespace ns3
         void SetLastPos (Vector pos);
         Vector GetLastPos ();
 
+        /**
+         * Select the serialized format.
+         *
+         * \param compact whether the compact format is used
+         * \param origin the origin of the positions in the compact format
+         */
+        void SetCompact (bool compact, Vector origin = Vector (0, 0, 0));
+        /**
+         * \return whether the compact format is used
+         */
+        bool IsCompact (void) const;
+
         static TypeId GetTypeId(void);
 
         virtual TypeId GetInstanceTypeId(void) const;
@@ -65,8 +94,34 @@ namespace ns3
         uint64_t ts = 0;
         Vector start_pos = Vector(0, 0, 0);
         Vector last_pos = Vector(0, 0, 0);
+        bool compact = false;              //!< whether the compact format is used
+        Vector origin = Vector(0, 0, 0);   //!< origin of the positions in the compact format
 
-        
+        /**
+         * \param value the value to encode
+         * \return the number of bytes of the varint encoding of value
+         */
+        static uint32_t GetVarintSize(uint32_t value);
+        /**
+         * \param i the iterator to write to
+         * \param value the value to encode as a varint
+         */
+        static void WriteVarint(Buffer::Iterator &i, uint32_t value);
+        /**
+         * \param i the iterator to read from
+         * \return the decoded varint
+         */
+        static uint32_t ReadVarint(Buffer::Iterator &i);
+        /**
+         * \param i the iterator to write to
+         * \param pos the position to write relative to origin
+         */
+        void WriteCompactPos(Buffer::Iterator &i, const Vector &pos) const;
+        /**
+         * \param i the iterator to read from
+         * \return the position read relative to origin
+         */
+        Vector ReadCompactPos(Buffer::Iterator &i) const;
     };
 
 } // namespace ns3
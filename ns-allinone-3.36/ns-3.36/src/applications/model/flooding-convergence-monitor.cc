@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "flooding-convergence-monitor.h"
+
+namespace ns3
+{
+
+  NS_LOG_COMPONENT_DEFINE("FloodingConvergenceMonitor");
+
+  NS_OBJECT_ENSURE_REGISTERED(FloodingConvergenceMonitor);
+
+  namespace
+  {
+    /**
+     * \param df degrees of freedom
+     * \return the two-sided 95% quantile of the Student t distribution
+     */
+    double StudentT95(uint32_t df)
+    {
+      static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+      if (df == 0)
+      {
+        return INFINITY;
+      }
+      if (df <= 30)
+      {
+        return table[df - 1];
+      }
+      return 1.96;
+    }
+  } // namespace
+
+  TypeId
+  FloodingConvergenceMonitor::GetTypeId(void)
+  {
+    static TypeId tid = TypeId("ns3::FloodingConvergenceMonitor")
+                            .SetParent<Object>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<FloodingConvergenceMonitor>()
+                            .AddAttribute("Threshold", "Relative half-width of the confidence intervals below which the KPIs are converged",
+                                          DoubleValue(0.05),
+                                          MakeDoubleAccessor(&FloodingConvergenceMonitor::m_threshold),
+                                          MakeDoubleChecker<double>(0.0))
+                            .AddAttribute("Batches", "Number of recent snapshots the confidence intervals are computed over",
+                                          UintegerValue(10),
+                                          MakeUintegerAccessor(&FloodingConvergenceMonitor::m_batches),
+                                          MakeUintegerChecker<uint32_t>(2))
+                            .AddAttribute("StartTime", "Snapshots before this time are ignored, e.g. during the warmup",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&FloodingConvergenceMonitor::m_startTime),
+                                          MakeTimeChecker());
+    return tid;
+  }
+
+  FloodingConvergenceMonitor::FloodingConvergenceMonitor()
+      : m_converged(false)
+  {
+    NS_LOG_FUNCTION(this);
+  }
+
+  FloodingConvergenceMonitor::~FloodingConvergenceMonitor()
+  {
+    NS_LOG_FUNCTION(this);
+  }
+
+  void
+  FloodingConvergenceMonitor::DoDispose(void)
+  {
+    NS_LOG_FUNCTION(this);
+    if (m_stats)
+    {
+      m_stats->TraceDisconnectWithoutContext("Snapshot", MakeCallback(&FloodingConvergenceMonitor::OnSnapshot, this));
+      m_stats = 0;
+    }
+    Object::DoDispose();
+  }
+
+  void
+  FloodingConvergenceMonitor::Monitor(Ptr<FloodingStats> stats)
+  {
+    NS_LOG_FUNCTION(this << stats);
+    m_stats = stats;
+    m_stats->TraceConnectWithoutContext("Snapshot", MakeCallback(&FloodingConvergenceMonitor::OnSnapshot, this));
+  }
+
+  bool
+  FloodingConvergenceMonitor::HasConverged() const
+  {
+    return m_converged;
+  }
+
+  std::string
+  FloodingConvergenceMonitor::GetStopReason() const
+  {
+    return m_converged ? "converged" : "simTime";
+  }
+
+  Time
+  FloodingConvergenceMonitor::GetStopTime() const
+  {
+    return m_converged ? m_stopTime : Simulator::Now();
+  }
+
+  double
+  FloodingConvergenceMonitor::GetRelativeHalfWidth(const std::deque<double> &values)
+  {
+    uint32_t n = values.size();
+    if (n < 2)
+    {
+      return INFINITY;
+    }
+    double mean = 0;
+    for (double value : values)
+    {
+      mean += value;
+    }
+    mean /= n;
+    double variance = 0;
+    for (double value : values)
+    {
+      variance += (value - mean) * (value - mean);
+    }
+    variance /= n - 1;
+
+    double halfWidth = StudentT95(n - 1) * std::sqrt(variance / n);
+    if (halfWidth == 0)
+    {
+      // Constant batches, including a KPI that stays at 0
+      return 0;
+    }
+    return halfWidth / std::fabs(mean);
+  }
+
+  void
+  FloodingConvergenceMonitor::AddBatch(std::deque<double> &batches, double value)
+  {
+    batches.push_back(value);
+    if (batches.size() > m_batches)
+    {
+      batches.pop_front();
+    }
+  }
+
+  void
+  FloodingConvergenceMonitor::OnSnapshot(const FloodingStatsSnapshot &snapshot)
+  {
+    NS_LOG_FUNCTION(this);
+    if (m_converged || snapshot.time < m_startTime)
+    {
+      return;
+    }
+
+    if (snapshot.windowSent > 0)
+    {
+      AddBatch(m_pd, snapshot.windowPd);
+    }
+    if (snapshot.windowUpdates > 0)
+    {
+      AddBatch(m_pe500, snapshot.windowPe500);
+    }
+    if (m_pd.size() < m_batches || m_pe500.size() < m_batches)
+    {
+      return;
+    }
+
+    double pdWidth = GetRelativeHalfWidth(m_pd);
+    double pe500Width = GetRelativeHalfWidth(m_pe500);
+    NS_LOG_DEBUG("pd " << pdWidth << " pe500 " << pe500Width);
+    if (pdWidth < m_threshold && pe500Width < m_threshold)
+    {
+      NS_LOG_INFO("KPIs converged at " << snapshot.time.As(Time::S));
+      m_converged = true;
+      m_stopTime = snapshot.time;
+      Simulator::Stop();
+    }
+  }
+
+} // namespace ns3
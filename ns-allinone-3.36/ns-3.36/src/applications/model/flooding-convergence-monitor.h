@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOODING_CONVERGENCE_MONITOR_H
+#define FLOODING_CONVERGENCE_MONITOR_H
+
+#include <deque>
+#include <string>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/flooding-stats.h"
+
+namespace ns3
+{
+
+  /**
+   * \ingroup applications
+   *
+   * \brief Stops a flooding simulation once its KPIs have converged.
+   *
+   * The monitor listens to the snapshots of a FloodingStats block. Every
+   * snapshot after StartTime contributes one batch to each KPI: the pd and
+   * the pe500 of its window, so that the batches are means over disjoint
+   * windows rather than successive values of the running totals. The pd of
+   * a window is the ratio of the receptions to the possible receptions of
+   * the packets sent in it. Over the last Batches batches
+   * the 95% confidence interval of the mean is computed with the Student t
+   * distribution. Once the half-width of both intervals relative to their
+   * mean is below Threshold, the monitor calls Simulator::Stop and records
+   * the reason. Windows without any packet sent do not produce a pd batch,
+   * windows without any update do not produce a pe500 batch.
+   */
+  class FloodingConvergenceMonitor : public Object
+  {
+  public:
+    static TypeId GetTypeId(void);
+    FloodingConvergenceMonitor();
+    virtual ~FloodingConvergenceMonitor();
+
+    /**
+     * Start monitoring the snapshots of a stats block. The stats block needs
+     * a SnapshotInterval, which is the batch length.
+     *
+     * \param stats the stats block
+     */
+    void Monitor(Ptr<FloodingStats> stats);
+
+    /**
+     * \return true if the simulation has been stopped by the monitor
+     */
+    bool HasConverged() const;
+
+    /**
+     * \return "converged" if the monitor stopped the simulation, "simTime" otherwise
+     */
+    std::string GetStopReason() const;
+
+    /**
+     * \return the time at which the KPIs converged, or the current time if they did not
+     */
+    Time GetStopTime() const;
+
+    /**
+     * \param values the batch values
+     * \return the half-width of the 95% confidence interval of the mean relative to the mean
+     */
+    static double GetRelativeHalfWidth(const std::deque<double> &values);
+
+  protected:
+    virtual void DoDispose(void);
+
+  private:
+    void OnSnapshot(const FloodingStatsSnapshot &snapshot);
+    void AddBatch(std::deque<double> &batches, double value);
+
+    double m_threshold;          //!< relative half-width below which the KPIs are converged
+    uint32_t m_batches;          //!< number of recent batches the intervals are computed over
+    Time m_startTime;            //!< snapshots before this time are ignored
+    Ptr<FloodingStats> m_stats;  //!< the monitored stats block
+    std::deque<double> m_pd;     //!< recent pd batches
+    std::deque<double> m_pe500;  //!< recent pe500 batches
+    bool m_converged;            //!< true once the monitor stopped the simulation
+    Time m_stopTime;             //!< time of convergence
+  };
+
+} // namespace ns3
+
+#endif /* FLOODING_CONVERGENCE_MONITOR_H */
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "flooding-duplicate-cache.h"
+
+namespace ns3
+{
+
+  NS_LOG_COMPONENT_DEFINE("FloodingDuplicateCache");
+
+  FloodingDuplicateCache::FloodingDuplicateCache(uint32_t windowSize, Time maxAge)
+      : m_windowSize(windowSize),
+        m_words(windowSize / 64),
+        m_maxAge(maxAge),
+        m_lastExpiry(Seconds(0)),
+        m_nSources(0)
+  {
+    NS_LOG_FUNCTION(this << windowSize << maxAge);
+    NS_ABORT_MSG_IF(windowSize == 0 || windowSize % 64 != 0, "The window size should be a multiple of 64, got " << windowSize);
+  }
+
+  bool FloodingDuplicateCache::Contains(uint64_t key) const
+  {
+    uint32_t src = key >> 32;
+    uint32_t seq = key & 0xffffffff;
+    if (!IsTracked(src) || seq > m_heads[src])
+    {
+      return false;
+    }
+    if (m_heads[src] - seq >= m_windowSize)
+    {
+      // Too old to be tracked anymore
+      return true;
+    }
+    uint32_t bit = seq % m_windowSize;
+    return (m_bits[std::size_t(src) * m_words + bit / 64] >> (bit % 64)) & 1;
+  }
+
+  bool FloodingDuplicateCache::Insert(uint64_t key)
+  {
+    uint32_t src = key >> 32;
+    uint32_t seq = key & 0xffffffff;
+    Time now = Simulator::Now();
+    if (now - m_lastExpiry > m_maxAge)
+    {
+      Expire();
+    }
+
+    if (src >= m_tracked.size())
+    {
+      m_tracked.resize(src + 1, 0);
+      m_heads.resize(src + 1);
+      m_lastUpdates.resize(src + 1);
+      m_bits.resize((std::size_t(src) + 1) * m_words, 0);
+    }
+    uint64_t *bits = &m_bits[std::size_t(src) * m_words];
+    if (!m_tracked[src])
+    {
+      m_tracked[src] = 1;
+      m_heads[src] = seq;
+      std::fill(bits, bits + m_words, 0);
+      m_nSources++;
+    }
+    m_lastUpdates[src] = now;
+
+    uint32_t &head = m_heads[src];
+    if (seq > head)
+    {
+      // Slide the window forward, clearing the slots that are reused
+      if (seq - head >= m_windowSize)
+      {
+        std::fill(bits, bits + m_words, 0);
+      }
+      else
+      {
+        for (uint32_t i = 1; i <= seq - head; i++)
+        {
+          uint32_t bit = (head + i) % m_windowSize;
+          bits[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+        }
+      }
+      head = seq;
+    }
+    else if (head - seq >= m_windowSize)
+    {
+      return false;
+    }
+
+    uint32_t bit = seq % m_windowSize;
+    uint64_t mask = uint64_t(1) << (bit % 64);
+    if (bits[bit / 64] & mask)
+    {
+      return false;
+    }
+    bits[bit / 64] |= mask;
+    return true;
+  }
+
+  void FloodingDuplicateCache::Clear()
+  {
+    NS_LOG_FUNCTION(this);
+    m_nSources = 0;
+    std::vector<uint8_t>().swap(m_tracked);
+    std::vector<uint32_t>().swap(m_heads);
+    std::vector<Time>().swap(m_lastUpdates);
+    std::vector<uint64_t>().swap(m_bits);
+  }
+
+  void FloodingDuplicateCache::SetWindowSize(uint32_t windowSize)
+  {
+    NS_LOG_FUNCTION(this << windowSize);
+    NS_ABORT_MSG_IF(windowSize == 0 || windowSize % 64 != 0, "The window size should be a multiple of 64, got " << windowSize);
+    m_windowSize = windowSize;
+    m_words = windowSize / 64;
+    Clear();
+  }
+
+  uint32_t FloodingDuplicateCache::GetWindowSize() const
+  {
+    return m_windowSize;
+  }
+
+  void FloodingDuplicateCache::SetMaxAge(Time maxAge)
+  {
+    NS_LOG_FUNCTION(this << maxAge);
+    m_maxAge = maxAge;
+  }
+
+  Time FloodingDuplicateCache::GetMaxAge() const
+  {
+    return m_maxAge;
+  }
+
+  std::size_t FloodingDuplicateCache::GetNSources() const
+  {
+    return m_nSources;
+  }
+
+  std::size_t FloodingDuplicateCache::GetMemoryUsage() const
+  {
+    return m_tracked.capacity() * sizeof(uint8_t)
+           + m_heads.capacity() * sizeof(uint32_t)
+           + m_lastUpdates.capacity() * sizeof(Time)
+           + m_bits.capacity() * sizeof(uint64_t);
+  }
+
+  void FloodingDuplicateCache::Expire()
+  {
+    NS_LOG_FUNCTION(this);
+    Time now = Simulator::Now();
+    for (uint32_t src = 0; src < m_tracked.size(); src++)
+    {
+      if (m_tracked[src] && now - m_lastUpdates[src] > m_maxAge)
+      {
+        m_tracked[src] = 0;
+        m_nSources--;
+      }
+    }
+    m_lastExpiry = now;
+  }
+
+} // namespace ns3
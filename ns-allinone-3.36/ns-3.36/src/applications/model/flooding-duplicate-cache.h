@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOODING_DUPLICATE_CACHE_H
+#define FLOODING_DUPLICATE_CACHE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "ns3/nstime.h"
+
+namespace ns3
+{
+
+  /**
+   * \ingroup applications
+   *
+   * \brief Duplicate detection for the flooding applications.
+   *
+   * A packet is identified by its (src, seq) pair, packed into a single
+   * 64 bit key. For every source, the cache keeps a sliding bitmap over the
+   * last WindowSize sequence numbers, so lookups and insertions are O(1).
+   * Sequence numbers that fell out of the window are reported as already
+   * seen. Sources that have not been heard of for longer than MaxAge are
+   * forgotten.
+   *
+   * Sources are node ids, which are dense, so the state of the sources is
+   * kept in arrays indexed by source id, like in the FloodingSourceTable:
+   * the bitmaps of all sources share one array of WindowSize / 64 words per
+   * source. The memory is bounded by the highest source id, at
+   * WindowSize / 8 + 13 bytes per source.
+   */
+  class FloodingDuplicateCache
+  {
+  public:
+    /**
+     * \param windowSize number of sequence numbers tracked per source, must be a multiple of 64
+     * \param maxAge time after which a silent source is removed from the cache
+     */
+    FloodingDuplicateCache(uint32_t windowSize = 256, Time maxAge = Seconds(60));
+
+    /**
+     * \param src the source node id
+     * \param seq the sequence number of the packet at the source
+     * \return the key identifying the packet
+     */
+    static uint64_t MakeKey(uint32_t src, uint32_t seq)
+    {
+      return (static_cast<uint64_t>(src) << 32) | seq;
+    }
+
+    /**
+     * \param key the packet key
+     * \return true if the packet has already been inserted
+     */
+    bool Contains(uint64_t key) const;
+
+    /**
+     * Insert a packet into the cache.
+     *
+     * \param key the packet key
+     * \return true if the packet was not in the cache yet
+     */
+    bool Insert(uint64_t key);
+
+    /**
+     * Forget all packets.
+     */
+    void Clear();
+
+    /**
+     * \param windowSize number of sequence numbers tracked per source, must be a multiple of 64
+     */
+    void SetWindowSize(uint32_t windowSize);
+    uint32_t GetWindowSize() const;
+
+    /**
+     * \param maxAge time after which a silent source is removed from the cache
+     */
+    void SetMaxAge(Time maxAge);
+    Time GetMaxAge() const;
+
+    /**
+     * \return the number of sources currently tracked
+     */
+    std::size_t GetNSources() const;
+
+    /**
+     * \return the bytes allocated by the arrays of the cache
+     */
+    std::size_t GetMemoryUsage() const;
+
+  private:
+    /**
+     * Remove the sources that have been silent for longer than m_maxAge.
+     */
+    void Expire();
+
+    /**
+     * \param src the source node id
+     * \return true if the source is tracked
+     */
+    bool IsTracked(uint32_t src) const
+    {
+      return src < m_tracked.size() && m_tracked[src];
+    }
+
+    uint32_t m_windowSize;                          //!< sequence numbers tracked per source
+    uint32_t m_words;                               //!< words of the bitmap of a source
+    Time m_maxAge;                                  //!< lifetime of a silent source
+    Time m_lastExpiry;                              //!< time of the last expiry pass
+    std::size_t m_nSources;                         //!< sources currently tracked
+
+    // One entry per source id
+    std::vector<uint8_t> m_tracked;                 //!< whether the source is tracked
+    std::vector<uint32_t> m_heads;                  //!< highest sequence number seen
+    std::vector<Time> m_lastUpdates;                //!< time of the last insertion
+    std::vector<uint64_t> m_bits;                   //!< m_words words per source, bit (seq % windowSize) is set if seq has been seen
+  };
+
+} // namespace ns3
+
+#endif /* FLOODING_DUPLICATE_CACHE_H */
@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "flooding-source-table.h"
+
+namespace ns3
+{
+
+  NS_LOG_COMPONENT_DEFINE("FloodingSourceTable");
+
+  FloodingSourceTable::FloodingSourceTable()
+      : m_nSeen(0)
+  {
+    NS_LOG_FUNCTION(this);
+  }
+
+  void FloodingSourceTable::ClearSeen()
+  {
+    NS_LOG_FUNCTION(this);
+    for (uint8_t &flags : m_flags)
+    {
+      flags &= ~SEEN;
+    }
+    m_nSeen = 0;
+  }
+
+  void FloodingSourceTable::Clear()
+  {
+    NS_LOG_FUNCTION(this);
+    m_nSeen = 0;
+    std::vector<uint8_t>().swap(m_flags);
+    std::vector<Time>().swap(m_lastReceived);
+    std::vector<Time>().swap(m_lastForwarded);
+    std::vector<Ptr<Packet>>().swap(m_packets);
+  }
+
+  std::size_t FloodingSourceTable::GetMemoryUsage() const
+  {
+    return m_flags.capacity() * sizeof(uint8_t)
+           + m_lastReceived.capacity() * sizeof(Time)
+           + m_lastForwarded.capacity() * sizeof(Time)
+           + m_packets.capacity() * sizeof(Ptr<Packet>);
+  }
+
+} // namespace ns3
@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOODING_SOURCE_TABLE_H
+#define FLOODING_SOURCE_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+namespace ns3
+{
+
+  /**
+   * \ingroup applications
+   *
+   * \brief Per-source state of the flooding applications.
+   *
+   * Sources are node ids, which are dense, so every column of the table is
+   * a contiguous array indexed by source id instead of a tree of the
+   * sources heard of. A lookup is a bounds check and an array access, and a
+   * source costs one byte of flags plus the columns that have been written
+   * for it: 8 bytes for each of the last reception and forwarding times and
+   * the packet to forward. The columns grow to the highest source id written
+   * to them, so an application that never forwards with a rate decay does
+   * not pay for those columns.
+   */
+  class FloodingSourceTable
+  {
+  public:
+    FloodingSourceTable();
+
+    /**
+     * Mark a source as heard of.
+     *
+     * \param src the source node id
+     * \return true if the source had not been heard of yet
+     */
+    bool MarkSeen(uint32_t src)
+    {
+      uint8_t &flags = GetFlags(src);
+      if (flags & SEEN)
+      {
+        return false;
+      }
+      flags |= SEEN;
+      m_nSeen++;
+      return true;
+    }
+
+    /**
+     * \param src the source node id
+     * \return true if the source has been heard of since the last ClearSeen()
+     */
+    bool IsSeen(uint32_t src) const
+    {
+      return src < m_flags.size() && (m_flags[src] & SEEN);
+    }
+
+    /**
+     * \return the number of sources heard of since the last ClearSeen()
+     */
+    uint32_t GetNSeen() const
+    {
+      return m_nSeen;
+    }
+
+    /**
+     * \param src the source node id
+     * \param [out] time the generation time of the last update received from the source
+     * \return true if an update has been received from the source
+     */
+    bool GetLastReceived(uint32_t src, Time &time) const
+    {
+      if (src < m_flags.size() && (m_flags[src] & RECEIVED))
+      {
+        time = m_lastReceived[src];
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * \param src the source node id
+     * \param time the generation time of the last update received from the source
+     */
+    void SetLastReceived(uint32_t src, Time time)
+    {
+      GetFlags(src) |= RECEIVED;
+      Set(m_lastReceived, src, time);
+    }
+
+    /**
+     * \param src the source node id
+     * \param [out] time the time of the last forwarding for the source
+     * \return true if a packet of the source has been forwarded
+     */
+    bool GetLastForwarded(uint32_t src, Time &time) const
+    {
+      if (src < m_flags.size() && (m_flags[src] & FORWARDED))
+      {
+        time = m_lastForwarded[src];
+        return true;
+      }
+      return false;
+    }
+
+    /**
+     * \param src the source node id
+     * \param time the time of the last forwarding for the source
+     */
+    void SetLastForwarded(uint32_t src, Time time)
+    {
+      GetFlags(src) |= FORWARDED;
+      Set(m_lastForwarded, src, time);
+    }
+
+    /**
+     * \param src the source node id
+     * \return the packet to forward for the source, null if none has been set
+     */
+    Ptr<Packet> GetPacket(uint32_t src) const
+    {
+      return src < m_packets.size() ? m_packets[src] : Ptr<Packet>();
+    }
+
+    /**
+     * \param src the source node id
+     * \param packet the packet to forward for the source
+     */
+    void SetPacket(uint32_t src, Ptr<Packet> packet)
+    {
+      Set(m_packets, src, packet);
+    }
+
+    /**
+     * Forget which sources have been heard of, the other columns are kept.
+     */
+    void ClearSeen();
+
+    /**
+     * Forget all sources and release the memory of the columns.
+     */
+    void Clear();
+
+    /**
+     * \return the number of source ids covered by the table
+     */
+    uint32_t GetNSources() const
+    {
+      return m_flags.size();
+    }
+
+    /**
+     * \return the bytes allocated by the columns of the table, the packets
+     *         themselves are not included
+     */
+    std::size_t GetMemoryUsage() const;
+
+  private:
+    /// Bits of the flags of a source
+    enum Flag : uint8_t
+    {
+      SEEN = 1,       //!< the source has been heard of
+      RECEIVED = 2,   //!< m_lastReceived holds a value for the source
+      FORWARDED = 4   //!< m_lastForwarded holds a value for the source
+    };
+
+    /**
+     * \param src the source node id
+     * \return the flags of the source, the table is grown if needed
+     */
+    uint8_t &GetFlags(uint32_t src)
+    {
+      if (src >= m_flags.size())
+      {
+        m_flags.resize(src + 1, 0);
+      }
+      return m_flags[src];
+    }
+
+    /**
+     * Write a column, growing it to the source if needed.
+     *
+     * \param column the column
+     * \param src the source node id
+     * \param value the value of the source
+     */
+    template <typename T>
+    static void Set(std::vector<T> &column, uint32_t src, const T &value)
+    {
+      if (src >= column.size())
+      {
+        column.resize(src + 1);
+      }
+      column[src] = value;
+    }
+
+    uint32_t m_nSeen;                      //!< sources with the SEEN flag
+    std::vector<uint8_t> m_flags;          //!< flags of every source
+    std::vector<Time> m_lastReceived;      //!< generation time of the last update per source
+    std::vector<Time> m_lastForwarded;     //!< time of the last forwarding per source
+    std::vector<Ptr<Packet>> m_packets;    //!< packet to forward per source
+  };
+
+} // namespace ns3
+
+#endif /* FLOODING_SOURCE_TABLE_H */
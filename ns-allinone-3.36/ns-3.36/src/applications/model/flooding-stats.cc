@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "flooding-stats.h"
+
+namespace ns3
+{
+
+  NS_LOG_COMPONENT_DEFINE("FloodingStats");
+
+  NS_OBJECT_ENSURE_REGISTERED(FloodingStats);
+
+  TypeId
+  FloodingStats::GetTypeId(void)
+  {
+    static TypeId tid = TypeId("ns3::FloodingStats")
+                            .SetParent<Object>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<FloodingStats>()
+                            .AddAttribute("SnapshotInterval", "Time between two snapshots of the KPIs, 0 disables them. "
+                                                              "Snapshots start when the object is initialized.",
+                                          TimeValue(Seconds(0)),
+                                          MakeTimeAccessor(&FloodingStats::m_snapshotInterval),
+                                          MakeTimeChecker())
+                            .AddTraceSource("Snapshot", "A snapshot of the KPIs has been taken",
+                                            MakeTraceSourceAccessor(&FloodingStats::m_snapshotTrace),
+                                            "ns3::FloodingStats::SnapshotTracedCallback");
+    return tid;
+  }
+
+  FloodingStats::FloodingStats()
+      : m_nNodes(0),
+        m_windowSent(0),
+        m_windowReceived(0),
+        m_windowForwarded(0),
+        m_windowInTime(0),
+        m_windowLate(0),
+        m_windowAoiSum(0)
+  {
+    NS_LOG_FUNCTION(this);
+  }
+
+  FloodingStats::~FloodingStats()
+  {
+    NS_LOG_FUNCTION(this);
+  }
+
+  void
+  FloodingStats::DoInitialize(void)
+  {
+    NS_LOG_FUNCTION(this);
+    if (m_snapshotInterval.IsStrictlyPositive())
+    {
+      ScheduleSnapshot();
+    }
+    Object::DoInitialize();
+  }
+
+  void
+  FloodingStats::DoDispose(void)
+  {
+    NS_LOG_FUNCTION(this);
+    m_snapshotEvent.Cancel();
+    Object::DoDispose();
+  }
+
+  void
+  FloodingStats::AddNode(uint32_t nodeId)
+  {
+    NS_LOG_FUNCTION(this << nodeId);
+    if (nodeId >= m_sent.size())
+    {
+      m_sent.resize(nodeId + 1, 0);
+      m_received.resize(nodeId + 1, 0);
+      m_forwarded.resize(nodeId + 1, 0);
+      m_seenNodes.resize(nodeId + 1, 0);
+      m_inTime.resize(nodeId + 1, 0);
+      m_late.resize(nodeId + 1, 0);
+      m_aoiSum.resize(nodeId + 1, 0);
+      m_added.resize(nodeId + 1, false);
+    }
+    if (!m_added[nodeId])
+    {
+      m_added[nodeId] = true;
+      m_nNodes++;
+    }
+  }
+
+  uint32_t
+  FloodingStats::GetNNodes() const
+  {
+    return m_nNodes;
+  }
+
+  void
+  FloodingStats::ResetNode(uint32_t nodeId)
+  {
+    NS_LOG_FUNCTION(this << nodeId);
+    m_sent[nodeId] = 0;
+    m_received[nodeId] = 0;
+    m_forwarded[nodeId] = 0;
+    m_seenNodes[nodeId] = 0;
+    m_inTime[nodeId] = 0;
+    m_late[nodeId] = 0;
+    m_aoiSum[nodeId] = 0;
+  }
+
+  void
+  FloodingStats::Reset()
+  {
+    NS_LOG_FUNCTION(this);
+    for (uint32_t i = 0; i < m_sent.size(); i++)
+    {
+      ResetNode(i);
+    }
+  }
+
+  FloodingStatsSnapshot
+  FloodingStats::GetTotals() const
+  {
+    uint64_t seenNodes = 0;
+    uint64_t inTime = 0;
+    uint64_t late = 0;
+    double aoiSum = 0;
+    FloodingStatsSnapshot snapshot;
+    snapshot.time = Simulator::Now();
+    snapshot.sent = 0;
+    snapshot.received = 0;
+    snapshot.forwarded = 0;
+    for (uint32_t i = 0; i < m_sent.size(); i++)
+    {
+      snapshot.sent += m_sent[i];
+      snapshot.received += m_received[i];
+      snapshot.forwarded += m_forwarded[i];
+      seenNodes += m_seenNodes[i];
+      inTime += m_inTime[i];
+      late += m_late[i];
+      aoiSum += m_aoiSum[i];
+    }
+
+    // Ratios without any sample are reported as 0
+    double nNodes = m_nNodes;
+    snapshot.pd = m_nNodes > 1 ? seenNodes / (nNodes * (nNodes - 1)) : 0;
+    uint64_t updates = inTime + late;
+    snapshot.updates = updates;
+    snapshot.pe500 = updates > 0 ? static_cast<double>(late) / updates : 0;
+    snapshot.meanAoi = updates > 0 ? aoiSum / updates : 0;
+
+    snapshot.windowSent = m_windowSent;
+    snapshot.windowReceived = m_windowReceived;
+    snapshot.windowForwarded = m_windowForwarded;
+    snapshot.windowPd = m_windowSent > 0 && m_nNodes > 1 ? m_windowReceived / (m_windowSent * (nNodes - 1)) : 0;
+    uint64_t windowUpdates = m_windowInTime + m_windowLate;
+    snapshot.windowUpdates = windowUpdates;
+    snapshot.windowPe500 = windowUpdates > 0 ? static_cast<double>(m_windowLate) / windowUpdates : 0;
+    snapshot.windowMeanAoi = windowUpdates > 0 ? m_windowAoiSum / windowUpdates : 0;
+    return snapshot;
+  }
+
+  const std::vector<FloodingStatsSnapshot> &
+  FloodingStats::GetSnapshots() const
+  {
+    return m_snapshots;
+  }
+
+  void
+  FloodingStats::Snapshot()
+  {
+    NS_LOG_FUNCTION(this);
+    m_snapshots.push_back(GetTotals());
+
+    m_windowSent = 0;
+    m_windowReceived = 0;
+    m_windowForwarded = 0;
+    m_windowInTime = 0;
+    m_windowLate = 0;
+    m_windowAoiSum = 0;
+
+    m_snapshotTrace(m_snapshots.back());
+  }
+
+  void
+  FloodingStats::ScheduleSnapshot()
+  {
+    m_snapshotEvent = Simulator::Schedule(m_snapshotInterval, &FloodingStats::PeriodicSnapshot, this);
+  }
+
+  void
+  FloodingStats::PeriodicSnapshot()
+  {
+    ScheduleSnapshot();
+    Snapshot();
+  }
+
+} // namespace ns3
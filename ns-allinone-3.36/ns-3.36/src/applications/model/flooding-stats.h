@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOODING_STATS_H
+#define FLOODING_STATS_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3
+{
+
+  /**
+   * \ingroup applications
+   *
+   * \brief KPIs of a flooding simulation at one point in time.
+   *
+   * The totals cover everything since the last reset of the nodes, the
+   * window values only what happened since the previous snapshot.
+   */
+  struct FloodingStatsSnapshot
+  {
+    Time time;                 //!< time of the snapshot
+    double pd;                 //!< ratio of the (node, source) pairs that have been seen
+    double pe500;              //!< ratio of the updates received after the AoI threshold
+    uint64_t sent;             //!< packets sent by all nodes
+    uint64_t received;         //!< first receptions at all nodes
+    uint64_t forwarded;        //!< packets forwarded by all nodes
+    uint64_t updates;          //!< in-range updates received by all nodes
+    double meanAoi;            //!< mean AoI of the in-range updates in seconds
+    double windowPd;           //!< ratio of the receptions to the possible receptions of the packets sent in the window
+    double windowPe500;        //!< pe500 of the updates received in the window
+    uint64_t windowUpdates;    //!< in-range updates received in the window
+    uint64_t windowSent;       //!< packets sent in the window
+    uint64_t windowReceived;   //!< first receptions in the window
+    uint64_t windowForwarded;  //!< packets forwarded in the window
+    double windowMeanAoi;      //!< mean AoI of the updates received in the window in seconds
+  };
+
+  /**
+   * \ingroup applications
+   *
+   * \brief Per-node counters shared by all flooding applications of a simulation.
+   *
+   * The applications add to the counters of their node as packets are sent,
+   * received and forwarded. Every counter is a contiguous array indexed by
+   * node id, so computing the KPIs only walks a few flat arrays instead of
+   * looking up every application. With a SnapshotInterval set, the KPIs are
+   * computed periodically, stored and fired through the Snapshot trace.
+   */
+  class FloodingStats : public Object
+  {
+  public:
+    static TypeId GetTypeId(void);
+    FloodingStats();
+    virtual ~FloodingStats();
+
+    /**
+     * TracedCallback signature for snapshots.
+     *
+     * \param [in] snapshot the KPIs at the time of the snapshot
+     */
+    typedef void (*SnapshotTracedCallback)(const FloodingStatsSnapshot &snapshot);
+
+    /**
+     * Make room for the counters of a node. Every node that publishes its
+     * counters has to be added, adding it again has no effect.
+     *
+     * \param nodeId the node id
+     */
+    void AddNode(uint32_t nodeId);
+
+    /**
+     * \return the number of nodes added
+     */
+    uint32_t GetNNodes() const;
+
+    void NotifySent(uint32_t nodeId)
+    {
+      m_sent[nodeId]++;
+      m_windowSent++;
+    }
+
+    void NotifyForwarded(uint32_t nodeId)
+    {
+      m_forwarded[nodeId]++;
+      m_windowForwarded++;
+    }
+
+    void NotifyReceived(uint32_t nodeId)
+    {
+      m_received[nodeId]++;
+      m_windowReceived++;
+    }
+
+    /**
+     * A node received the first packet of a source.
+     *
+     * \param nodeId the node id
+     */
+    void NotifySeenNode(uint32_t nodeId)
+    {
+      m_seenNodes[nodeId]++;
+    }
+
+    /**
+     * A node received an update of a source in range.
+     *
+     * \param nodeId the node id
+     * \param aoi the age of information at the time of reception
+     * \param late true if the age was above the AoI threshold
+     */
+    void NotifyUpdate(uint32_t nodeId, Time aoi, bool late)
+    {
+      double seconds = aoi.GetSeconds();
+      if (late)
+      {
+        m_late[nodeId]++;
+        m_windowLate++;
+      }
+      else
+      {
+        m_inTime[nodeId]++;
+        m_windowInTime++;
+      }
+      m_aoiSum[nodeId] += seconds;
+      m_windowAoiSum += seconds;
+    }
+
+    /**
+     * Clear the counters of a node, the window counters are left untouched.
+     *
+     * \param nodeId the node id
+     */
+    void ResetNode(uint32_t nodeId);
+
+    /**
+     * Clear the counters of all nodes.
+     */
+    void Reset();
+
+    /**
+     * \return the current KPIs, the window covers the time since the last snapshot
+     */
+    FloodingStatsSnapshot GetTotals() const;
+
+    /**
+     * \return the snapshots taken so far
+     */
+    const std::vector<FloodingStatsSnapshot> &GetSnapshots() const;
+
+    /**
+     * Take a snapshot now and start a new window.
+     */
+    void Snapshot();
+
+  protected:
+    virtual void DoInitialize(void);
+    virtual void DoDispose(void);
+
+  private:
+    void ScheduleSnapshot();
+    void PeriodicSnapshot();
+
+    Time m_snapshotInterval;                        //!< time between snapshots, 0 disables them
+    EventId m_snapshotEvent;                        //!< next periodic snapshot
+    uint32_t m_nNodes;                              //!< number of nodes added
+
+    // One entry per node id
+    std::vector<bool> m_added;                      //!< whether the node has been added
+    std::vector<uint32_t> m_sent;                   //!< packets sent
+    std::vector<uint32_t> m_received;               //!< first receptions
+    std::vector<uint32_t> m_forwarded;              //!< packets forwarded
+    std::vector<uint32_t> m_seenNodes;              //!< sources heard of
+    std::vector<uint32_t> m_inTime;                 //!< updates received within the AoI threshold
+    std::vector<uint32_t> m_late;                   //!< updates received after the AoI threshold
+    std::vector<double> m_aoiSum;                   //!< sum of the AoI of all updates in seconds
+
+    // Totals since the last snapshot
+    uint64_t m_windowSent;                          //!< packets sent
+    uint64_t m_windowReceived;                      //!< first receptions
+    uint64_t m_windowForwarded;                     //!< packets forwarded
+    uint64_t m_windowInTime;                        //!< updates within the AoI threshold
+    uint64_t m_windowLate;                          //!< updates after the AoI threshold
+    double m_windowAoiSum;                          //!< sum of the AoI in seconds
+
+    std::vector<FloodingStatsSnapshot> m_snapshots; //!< snapshots taken so far
+
+    /// Callbacks fired for every snapshot
+    TracedCallback<const FloodingStatsSnapshot &> m_snapshotTrace;
+  };
+
+} // namespace ns3
+
+#endif /* FLOODING_STATS_H */
@@ -29,6 +29,9 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-position-cache.h"
 
 #include "pure-flooding-application.h"
 
@@ -72,6 +75,18 @@ namespace ns3
                                           DoubleValue(1.0),
                                           MakeDoubleAccessor(&PureFloodingApp::m_forwardingProbability),
                                           MakeDoubleChecker<double>(0.0))
+                            .AddAttribute("DuplicateWindowSize", "Number of sequence numbers per source tracked for duplicate detection (multiple of 64)",
+                                          UintegerValue(256),
+                                          MakeUintegerAccessor(&PureFloodingApp::m_duplicateWindowSize),
+                                          MakeUintegerChecker<uint32_t>(64))
+                            .AddAttribute("DuplicateMaxAge", "Time after which a silent source is removed from the duplicate detection",
+                                          TimeValue(Seconds(60)),
+                                          MakeTimeAccessor(&PureFloodingApp::m_duplicateMaxAge),
+                                          MakeTimeChecker())
+                            .AddAttribute("PositionCacheEnabled", "If true, the own position is read from the NodePositionCache instead of the aggregated mobility model",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&PureFloodingApp::m_positionCacheEnabled),
+                                          MakeBooleanChecker())
                             .AddTraceSource("Rx", "A packet has been received",
                                             MakeTraceSourceAccessor(&PureFloodingApp::m_rxTrace),
                                             "ns3::Packet::TracedCallback")
@@ -91,9 +106,7 @@ namespace ns3
   {
     NS_LOG_FUNCTION(this);
     m_socket = 0;
-    jitter = CreateObject<UniformRandomVariable>();
-    jitter->SetAttribute("Min", DoubleValue(0));
-    jitter->SetAttribute("Max", DoubleValue(m_forwardingJitter.GetSeconds()));
+    m_maxJitter = m_forwardingJitter.GetSeconds();
   }
 
   PureFloodingApp::~PureFloodingApp()
@@ -106,6 +119,7 @@ namespace ns3
   PureFloodingApp::DoDispose(void)
   {
     NS_LOG_FUNCTION(this);
+    m_stats = 0;
     Application::DoDispose();
   }
 
@@ -114,6 +128,9 @@ namespace ns3
   {
     NS_LOG_FUNCTION(this);
 
+    m_seenPackets.SetWindowSize(m_duplicateWindowSize);
+    m_seenPackets.SetMaxAge(m_duplicateMaxAge);
+
     if (m_socket == 0)
     {
       TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
@@ -167,15 +184,15 @@ namespace ns3
 
   void PureFloodingApp::Forward(Ptr<Packet> packet)
   {
-    auto p = CreateObject<UniformRandomVariable>();
-    p->SetAttribute("Min", DoubleValue(0));
-    p->SetAttribute("Max", DoubleValue(1.0));
-
-    if (p->GetValue() <= m_forwardingProbability)
+    if (m_forwardingStream.GetUniform() <= m_forwardingProbability)
     {
       m_socket->Send(packet);
       m_fwdTrace(packet, GetNode()->GetId());
       numForwarded++;
+      if (m_stats)
+      {
+        m_stats->NotifyForwarded(GetNode()->GetId());
+      }
     }
   }
 
@@ -191,7 +208,7 @@ namespace ns3
     Ptr<Packet> p = Create<Packet>(m_dataSize);
     uint32_t nodeId = GetNode()->GetId();
 
-    Vector nodePos = GetNode()->GetObject<MobilityModel>()->GetPosition();
+    Vector nodePos = GetOwnPosition();
 
     PureFloodingHeader header;
     header.SetSeq(this->seqNo++);
@@ -201,11 +218,24 @@ namespace ns3
     p->AddHeader(header);
     m_txTrace(p, GetNode()->GetId());
     numSent++;
+    if (m_stats)
+    {
+      m_stats->NotifySent(nodeId);
+    }
     m_socket->Send(p);
     ScheduleTransmit(m_sendInterval);
 
-    string pkt_id = to_string(GetNode()->GetId()) + "-" + to_string(header.GetSeq());
-    seenSeqNos.push_back(pkt_id);
+    m_seenPackets.Insert(FloodingDuplicateCache::MakeKey(nodeId, header.GetSeq()));
+  }
+
+  Vector
+  PureFloodingApp::GetOwnPosition(void) const
+  {
+    if (m_positionCacheEnabled)
+    {
+      return NodePositionCache::Get()->GetPosition(GetNode()->GetId());
+    }
+    return GetNode()->GetObject<MobilityModel>()->GetPosition();
   }
 
   void
@@ -219,29 +249,27 @@ namespace ns3
     while ((packet = socket->RecvFrom(from)))
     {
       socket->GetSockName(localAddress);
-      Ptr<Packet> packetCopy = packet->Copy();
-      packetCopy->RemoveAllPacketTags();
-      packetCopy->RemoveAllByteTags();
       PureFloodingHeader header;
-      packetCopy->RemoveHeader(header);
+      uint32_t headerSize = packet->PeekHeader(header);
 
+      // Duplicates are dropped before the packet is copied
       uint32_t src = header.GetSrc();
-      Vector nodePos = GetNode()->GetObject<MobilityModel>()->GetPosition();
-      double dist_sender = CalculateDistance(header.GetStartPos(), nodePos);
-
-      header.SetNumHops(header.GetNumHops() + 1);
-      header.SetLastHop(GetNode()->GetId());
-
-      packetCopy->AddHeader(header);
+      if (m_seenPackets.Insert(FloodingDuplicateCache::MakeKey(src, header.GetSeq())))
+      {
+        Vector nodePos = GetOwnPosition();
+        double dist_sender = CalculateDistance(header.GetStartPos(), nodePos);
 
-      string pkt_id = to_string(header.GetSrc()) + "-" + to_string(header.GetSeq());
+        header.SetNumHops(header.GetNumHops() + 1);
+        header.SetLastHop(GetNode()->GetId());
 
-      if (std::find(seenSeqNos.begin(), seenSeqNos.end(), pkt_id) == seenSeqNos.end())
-      {
-        seenNodes.insert(src);
-        if (lastReceived.count(src) > 0 && dist_sender <= 509.003)
+        if (m_sources.MarkSeen(src) && m_stats)
+        {
+          m_stats->NotifySeenNode(GetNode()->GetId());
+        }
+        Time lastReceived;
+        if (m_sources.GetLastReceived(src, lastReceived) && dist_sender <= 509.003)
         {
-          Time aoi = Simulator::Now() - lastReceived[src];
+          Time aoi = Simulator::Now() - lastReceived;
           if (aoi > m_aoiThreshold)
           {
             numUpdatesReceivedLate++;
@@ -250,16 +278,27 @@ namespace ns3
           {
             numUpdatesReceivedInTime++;
           }
+          if (m_stats)
+          {
+            m_stats->NotifyUpdate(GetNode()->GetId(), aoi, aoi > m_aoiThreshold);
+          }
         }
-        lastReceived[src] = header.GetTs();
+        m_sources.SetLastReceived(src, header.GetTs());
         m_rxTrace(packet, GetNode()->GetId());
         m_rxTraceWithAddresses(packet, from, localAddress);
         numReceived++;
+        if (m_stats)
+        {
+          m_stats->NotifyReceived(GetNode()->GetId());
+        }
         if (header.GetNumHops() < m_ttl)
         {
-          Simulator::Schedule(Seconds(jitter->GetValue()), &PureFloodingApp::Forward, this, packetCopy);
+          Ptr<Packet> packetCopy = packet->Copy();
+          packetCopy->RemoveAllPacketTags();
+          packetCopy->RemoveAllByteTags();
+          packetCopy->PatchHeader(header, headerSize);
+          Simulator::Schedule(Seconds(m_jitterStream.GetUniform(0, m_maxJitter)), &PureFloodingApp::Forward, this, packetCopy);
         }
-        seenSeqNos.push_back(pkt_id);
       }
     }
   }
@@ -276,7 +315,7 @@ namespace ns3
 
   int PureFloodingApp::GetNumSeenNodes()
   {
-    return seenNodes.size();
+    return m_sources.GetNSeen();
   }
 
   int PureFloodingApp::GetNumSent()
@@ -298,10 +337,28 @@ namespace ns3
   {
         numUpdatesReceivedInTime = 0;
         numUpdatesReceivedLate = 0;
-        seenNodes.clear();
+        m_sources.ClearSeen();
         numSent = 0;
         numReceived = 0;
         numForwarded = 0;
+        if (m_stats)
+        {
+          m_stats->ResetNode(GetNode()->GetId());
+        }
+  }
+
+  void PureFloodingApp::SetStats(Ptr<FloodingStats> stats)
+  {
+    m_stats = stats;
+    m_stats->AddNode(GetNode()->GetId());
+  }
+
+  int64_t PureFloodingApp::AssignStreams(int64_t stream)
+  {
+    NS_LOG_FUNCTION(this << stream);
+    m_jitterStream.SetStream(stream);
+    m_forwardingStream.SetStream(stream + 1);
+    return 2;
   }
 
 } // Namespace ns3
@@ -28,6 +28,10 @@
 #include "ns3/traced-callback.h"
 #include "ns3/pure-flooding-header.h"
 #include "ns3/core-module.h"
+#include "ns3/flooding-duplicate-cache.h"
+#include "ns3/flooding-source-table.h"
+#include "ns3/flooding-stats.h"
+#include "ns3/inline-random-stream.h"
 
 namespace ns3
 {
@@ -43,7 +47,7 @@ namespace ns3
     virtual ~PureFloodingApp();
 
     void LogPerformance() {
-      NS_LOG_UNCOND("PERFORMANCE: " << seenNodes.size() << " " << numUpdatesReceivedInTime << " " << numUpdatesReceivedLate);
+      NS_LOG_UNCOND("PERFORMANCE: " << m_sources.GetNSeen() << " " << numUpdatesReceivedInTime << " " << numUpdatesReceivedLate);
     };
 
     int GetNumUpdatesReceivedInTime();
@@ -58,6 +62,23 @@ namespace ns3
 
     void ResetStats();
 
+    /**
+     * Publish the counters of this node in a stats block shared by all nodes.
+     * Must be called after the application has been added to its node.
+     *
+     * \param stats the stats block
+     */
+    void SetStats(Ptr<FloodingStats> stats);
+
+    /**
+     * Assign fixed random variable streams to the forwarding jitter and the
+     * forwarding decision of this application.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream);
+
   protected:
     virtual void DoDispose(void);
 
@@ -73,7 +94,14 @@ namespace ns3
 
     void HandleRead(Ptr<Socket> socket);
 
-    Ptr<UniformRandomVariable> jitter;
+    /**
+     * \return the position of the node, from the NodePositionCache if enabled
+     */
+    Vector GetOwnPosition(void) const;
+
+    InlineRandomStream m_jitterStream;                      //!< draws the forwarding jitter
+    InlineRandomStream m_forwardingStream;                  //!< draws the forwarding decision
+    double m_maxJitter;                                     //!< upper bound of the forwarding jitter in seconds, fixed at construction
 
     int seqNo = 0;
 
@@ -92,16 +120,19 @@ namespace ns3
     EventId m_sendEvent;                                    //!< Event to send the next packet
     Address m_peerAddress = Ipv4Address("255.255.255.255"); //!< Remote peer address
     uint16_t m_peerPort = 300;                              //!< Remote peer port
-    std::vector<std::string> seenSeqNos;
-    std::map<uint32_t, Time> lastReceived;
+    uint32_t m_duplicateWindowSize = 256;                   //!< sequence numbers tracked per source for duplicate detection
+    Time m_duplicateMaxAge = Seconds(60);                   //!< lifetime of a silent source in the duplicate cache
+    bool m_positionCacheEnabled = false;                    //!< read the own position from the NodePositionCache
+    FloodingDuplicateCache m_seenPackets;                   //!< packets received at least once
+    FloodingSourceTable m_sources;                          //!< sources heard of and their last reception
 
     // Metrics
-    std::set<uint32_t> seenNodes;
     int numUpdatesReceivedInTime = 0;
     int numUpdatesReceivedLate = 0;
     int numSent = 0;
     int numReceived = 0;
     int numForwarded = 0;
+    Ptr<FloodingStats> m_stats;                             //!< shared stats block, may be null
 
     /// Callbacks for tracing the packet Rx events
     TracedCallback<Ptr<const Packet>, uint32_t> m_rxTrace;
@@ -29,6 +29,8 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/vector.h"
 #include "ns3/mobility-module.h"
 
 #include "rate-decay-flooding-application.h"
@@ -73,6 +75,26 @@ namespace ns3
                                               DoubleValue(1.0),
                                               MakeDoubleAccessor(&RateDecayFloodingApp::m_decayFactor),
                                               MakeDoubleChecker<double>(0.0))
+                                .AddAttribute("DuplicateWindowSize", "Number of sequence numbers per source tracked for duplicate detection (multiple of 64)",
+                                              UintegerValue(256),
+                                              MakeUintegerAccessor(&RateDecayFloodingApp::m_duplicateWindowSize),
+                                              MakeUintegerChecker<uint32_t>(64))
+                                .AddAttribute("DuplicateMaxAge", "Time after which a silent source is removed from the duplicate detection",
+                                              TimeValue(Seconds(60)),
+                                              MakeTimeAccessor(&RateDecayFloodingApp::m_duplicateMaxAge),
+                                              MakeTimeChecker())
+                                .AddAttribute("PositionCacheEnabled", "If true, the own position is read from the NodePositionCache instead of the aggregated mobility model",
+                                              BooleanValue(false),
+                                              MakeBooleanAccessor(&RateDecayFloodingApp::m_positionCacheEnabled),
+                                              MakeBooleanChecker())
+                                .AddAttribute("CompactHeader", "If true, packets carry the compact format of the ContentionBasedFloodingHeader (all nodes must agree)",
+                                              BooleanValue(false),
+                                              MakeBooleanAccessor(&RateDecayFloodingApp::m_compactHeader),
+                                              MakeBooleanChecker())
+                                .AddAttribute("CompactHeaderOrigin", "Origin of the 16-bit positions of the compact header",
+                                              VectorValue(Vector(0, 0, 0)),
+                                              MakeVectorAccessor(&RateDecayFloodingApp::m_compactHeaderOrigin),
+                                              MakeVectorChecker())
                                 .AddTraceSource("Rx", "A packet has been received",
                                                 MakeTraceSourceAccessor(&RateDecayFloodingApp::m_rxTrace),
                                                 "ns3::Packet::TracedCallback")
@@ -104,6 +126,8 @@ namespace ns3
     RateDecayFloodingApp::DoDispose(void)
     {
         NS_LOG_FUNCTION(this);
+        m_stats = 0;
+        m_sources.Clear();
         Application::DoDispose();
     }
 
@@ -112,6 +136,11 @@ namespace ns3
     {
         NS_LOG_FUNCTION(this);
 
+        m_seenPackets.SetWindowSize(m_duplicateWindowSize);
+        m_seenPackets.SetMaxAge(m_duplicateMaxAge);
+        m_twiceSeenPackets.SetWindowSize(m_duplicateWindowSize);
+        m_twiceSeenPackets.SetMaxAge(m_duplicateMaxAge);
+
         if (m_socket == 0)
         {
             TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
@@ -163,14 +192,18 @@ namespace ns3
         m_sendEvent = Simulator::Schedule(dt, &RateDecayFloodingApp::Send, this);
     }
 
-    void RateDecayFloodingApp::Forward(uint32_t src, string pkt_id)
+    void RateDecayFloodingApp::Forward(uint32_t src, uint64_t pktKey)
     {
-        Ptr<Packet> packet = packetsToForward[src];
-        if (std::find(twiceSeenSeqNos.begin(), twiceSeenSeqNos.end(), pkt_id) == twiceSeenSeqNos.end())
+        Ptr<Packet> packet = m_sources.GetPacket(src);
+        if (!m_twiceSeenPackets.Contains(pktKey))
         {
             m_socket->Send(packet);
             m_fwdTrace(packet, GetNode()->GetId());
             numForwarded++;
+            if (m_stats)
+            {
+                m_stats->NotifyForwarded(GetNode()->GetId());
+            }
         }
     }
 
@@ -186,9 +219,10 @@ namespace ns3
         Ptr<Packet> p = Create<Packet>(m_dataSize);
         uint32_t nodeId = GetNode()->GetId();
 
-        Vector nodePos = GetNode()->GetObject<MobilityModel>()->GetPosition();
+        Vector nodePos = GetOwnPosition();
 
         ContentionBasedFloodingHeader header;
+        header.SetCompact(m_compactHeader, m_compactHeaderOrigin);
         header.SetSeq(this->seqNo++);
         header.SetSrc(nodeId);
         header.SetLastHop(nodeId);
@@ -197,11 +231,24 @@ namespace ns3
         p->AddHeader(header);
         m_txTrace(p, GetNode()->GetId());
         numSent++;
+        if (m_stats)
+        {
+            m_stats->NotifySent(nodeId);
+        }
         m_socket->Send(p);
         ScheduleTransmit(m_sendInterval);
 
-        string pkt_id = to_string(GetNode()->GetId()) + "-" + to_string(header.GetSeq());
-        seenSeqNos.push_back(pkt_id);
+        m_seenPackets.Insert(FloodingDuplicateCache::MakeKey(nodeId, header.GetSeq()));
+    }
+
+    Vector
+    RateDecayFloodingApp::GetOwnPosition(void) const
+    {
+        if (m_positionCacheEnabled)
+        {
+            return NodePositionCache::Get()->GetPosition(GetNode()->GetId());
+        }
+        return GetNode()->GetObject<MobilityModel>()->GetPosition();
     }
 
     void
@@ -215,34 +262,39 @@ namespace ns3
         while ((packet = socket->RecvFrom(from)))
         {
             socket->GetSockName(localAddress);
-            Ptr<Packet> packetCopy = packet->Copy();
-            packetCopy->RemoveAllPacketTags();
-            packetCopy->RemoveAllByteTags();
             ContentionBasedFloodingHeader header;
-            packetCopy->RemoveHeader(header);
+            header.SetCompact(m_compactHeader, m_compactHeaderOrigin);
+            uint32_t headerSize = packet->PeekHeader(header);
 
+            // Duplicates are counted before the packet is copied
             uint32_t src = header.GetSrc();
-            uint32_t numHops = header.GetNumHops();
-            Vector nodePos = GetNode()->GetObject<MobilityModel>()->GetPosition();
-            double dist_sender = CalculateDistance(header.GetStartPos(), nodePos);
-            double dist_sender_lastHop = CalculateDistance(header.GetStartPos(), header.GetLastPos());
-            double advance = dist_sender - dist_sender_lastHop;
-
-            header.SetNumHops(numHops + 1);
-            header.SetLastHop(GetNode()->GetId());
-            header.SetLastPos(nodePos);
-
-            packetCopy->AddHeader(header);
-
-            string pkt_id = to_string(src) + "-" + to_string(header.GetSeq());
+            uint64_t pktKey = FloodingDuplicateCache::MakeKey(src, header.GetSeq());
 
-            if (std::find(seenSeqNos.begin(), seenSeqNos.end(), pkt_id) == seenSeqNos.end())
+            if (m_seenPackets.Insert(pktKey))
             {
-
-                seenNodes.insert(src);
-                if (lastReceived.count(src) > 0 && dist_sender <= 509.003)
+                uint32_t numHops = header.GetNumHops();
+                Vector nodePos = GetOwnPosition();
+                double dist_sender = CalculateDistance(header.GetStartPos(), nodePos);
+                double dist_sender_lastHop = CalculateDistance(header.GetStartPos(), header.GetLastPos());
+                double advance = dist_sender - dist_sender_lastHop;
+
+                header.SetNumHops(numHops + 1);
+                header.SetLastHop(GetNode()->GetId());
+                header.SetLastPos(nodePos);
+
+                Ptr<Packet> packetCopy = packet->Copy();
+                packetCopy->RemoveAllPacketTags();
+                packetCopy->RemoveAllByteTags();
+                packetCopy->PatchHeader(header, headerSize);
+
+                if (m_sources.MarkSeen(src) && m_stats)
+                {
+                    m_stats->NotifySeenNode(GetNode()->GetId());
+                }
+                Time lastReceivedForSrc;
+                if (m_sources.GetLastReceived(src, lastReceivedForSrc) && dist_sender <= 509.003)
                 {
-                    Time aoi = Simulator::Now() - lastReceived[src];
+                    Time aoi = Simulator::Now() - lastReceivedForSrc;
                     if (aoi > m_aoiThreshold)
                     {
                         numUpdatesReceivedLate++;
@@ -251,11 +303,19 @@ namespace ns3
                     {
                         numUpdatesReceivedInTime++;
                     }
+                    if (m_stats)
+                    {
+                        m_stats->NotifyUpdate(GetNode()->GetId(), aoi, aoi > m_aoiThreshold);
+                    }
                 }
-                lastReceived[src] = header.GetTs();
+                m_sources.SetLastReceived(src, header.GetTs());
                 m_rxTrace(packet, GetNode()->GetId());
                 m_rxTraceWithAddresses(packet, from, localAddress);
                 numReceived++;
+                if (m_stats)
+                {
+                    m_stats->NotifyReceived(GetNode()->GetId());
+                }
                 double scale = (1.0 - (advance / m_maxDistance));
 
                 if (scale < 0.0)
@@ -265,9 +325,9 @@ namespace ns3
 
                 Time cbfDelay = m_forwardingJitter * scale;
                 Time rdfDelay = Seconds(0);
-                if (lastForwarded.find(src) != lastForwarded.end())
+                Time lastForwardedForSrc;
+                if (m_sources.GetLastForwarded(src, lastForwardedForSrc))
                 {
-                    Time lastForwardedForSrc = lastForwarded[src];
                     // rdfDelay = lastForwardedForSrc + m_sendInterval * pow(m_decayFactor, numHops + 1) - Simulator::Now();
                     rdfDelay = lastForwardedForSrc + m_sendInterval * pow(numHops + 1, m_decayFactor) - Simulator::Now();
                     if (rdfDelay < Seconds(0))
@@ -277,21 +337,17 @@ namespace ns3
                 }
 
                 Time delay = cbfDelay + rdfDelay;
-                packetsToForward[src] = packetCopy;
+                m_sources.SetPacket(src, packetCopy);
 
                 if (advance > 0)
                 {
-                    Simulator::Schedule(delay, &RateDecayFloodingApp::Forward, this, src, pkt_id);
+                    Simulator::Schedule(delay, &RateDecayFloodingApp::Forward, this, src, pktKey);
                 }
-                seenSeqNos.push_back(pkt_id);
-                lastForwarded[src] = Simulator::Now() + rdfDelay;
+                m_sources.SetLastForwarded(src, Simulator::Now() + rdfDelay);
             }
             else
             {
-                if (std::find(twiceSeenSeqNos.begin(), twiceSeenSeqNos.end(), pkt_id) == twiceSeenSeqNos.end())
-                {
-                    twiceSeenSeqNos.push_back(pkt_id);
-                }
+                m_twiceSeenPackets.Insert(pktKey);
             }
         }
     }
@@ -308,7 +364,7 @@ namespace ns3
 
     int RateDecayFloodingApp::GetNumSeenNodes()
     {
-        return seenNodes.size();
+        return m_sources.GetNSeen();
     }
 
     int RateDecayFloodingApp::GetNumSent()
@@ -330,10 +386,20 @@ namespace ns3
     {
         numUpdatesReceivedInTime = 0;
         numUpdatesReceivedLate = 0;
-        seenNodes.clear();
+        m_sources.ClearSeen();
         numSent = 0;
         numReceived = 0;
         numForwarded = 0;
+        if (m_stats)
+        {
+            m_stats->ResetNode(GetNode()->GetId());
+        }
+    }
+
+    void RateDecayFloodingApp::SetStats(Ptr<FloodingStats> stats)
+    {
+        m_stats = stats;
+        m_stats->AddNode(GetNode()->GetId());
     }
 
 } // Namespace ns3
@@ -29,6 +29,9 @@
 #include "ns3/traced-callback.h"
 #include "ns3/contention-based-flooding-header.h"
 #include "ns3/core-module.h"
+#include "ns3/flooding-duplicate-cache.h"
+#include "ns3/flooding-source-table.h"
+#include "ns3/flooding-stats.h"
 #include "ns3/mobility-module.h"
 
 namespace ns3
@@ -45,7 +48,7 @@ namespace ns3
     virtual ~RateDecayFloodingApp();
 
     void LogPerformance() {
-      NS_LOG_UNCOND("PERFORMANCE: " << seenNodes.size() << " " << numUpdatesReceivedInTime << " " << numUpdatesReceivedLate);
+      NS_LOG_UNCOND("PERFORMANCE: " << m_sources.GetNSeen() << " " << numUpdatesReceivedInTime << " " << numUpdatesReceivedLate);
     };
 
     int GetNumUpdatesReceivedInTime();
@@ -60,6 +63,14 @@ namespace ns3
 
     void ResetStats();
 
+    /**
+     * Publish the counters of this node in a stats block shared by all nodes.
+     * Must be called after the application has been added to its node.
+     *
+     * \param stats the stats block
+     */
+    void SetStats(Ptr<FloodingStats> stats);
+
   protected:
     virtual void DoDispose(void);
 
@@ -71,10 +82,15 @@ namespace ns3
 
     void Send(void);
 
-    void Forward(uint32_t src, std::string pkt_id);
+    void Forward(uint32_t src, uint64_t pktKey);
 
     void HandleRead(Ptr<Socket> socket);
 
+    /**
+     * \return the position of the node, from the NodePositionCache if enabled
+     */
+    Vector GetOwnPosition(void) const;
+
     int seqNo = 0;
 
     double m_maxDistance = 509.003;
@@ -91,19 +107,22 @@ namespace ns3
     EventId m_sendEvent;                                    //!< Event to send the next packet
     Address m_peerAddress = Ipv4Address("255.255.255.255"); //!< Remote peer address
     uint16_t m_peerPort = 300;                              //!< Remote peer port
-    std::vector<std::string> seenSeqNos;
-    std::vector<std::string> twiceSeenSeqNos;
-    std::map<uint32_t, Time> lastForwarded;
-    std::map<uint32_t, Ptr<Packet>> packetsToForward;
-    std::map<uint32_t, Time> lastReceived;
+    uint32_t m_duplicateWindowSize = 256;                   //!< sequence numbers tracked per source for duplicate detection
+    Time m_duplicateMaxAge = Seconds(60);                   //!< lifetime of a silent source in the duplicate caches
+    bool m_positionCacheEnabled = false;                    //!< read the own position from the NodePositionCache
+    bool m_compactHeader = false;                           //!< use the compact header format
+    Vector m_compactHeaderOrigin = Vector(0, 0, 0);         //!< origin of the positions in the compact header
+    FloodingDuplicateCache m_seenPackets;                   //!< packets received at least once
+    FloodingDuplicateCache m_twiceSeenPackets;              //!< packets received at least twice
+    FloodingSourceTable m_sources;                          //!< last reception, last forwarding and packet to forward per source
 
     // Metrics
-    std::set<uint32_t> seenNodes;
     int numUpdatesReceivedInTime = 0;
     int numUpdatesReceivedLate = 0;
     int numSent = 0;
     int numReceived = 0;
     int numForwarded = 0;
+    Ptr<FloodingStats> m_stats;                             //!< shared stats block, may be null
 
     /// Callbacks for tracing the packet Rx events
     TracedCallback<Ptr<const Packet>, uint32_t> m_rxTrace;
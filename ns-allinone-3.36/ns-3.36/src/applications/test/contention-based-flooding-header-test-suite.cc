@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/contention-based-flooding-header.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the full and the compact format of the
+ * ContentionBasedFloodingHeader round-trip, and the size, clamping and
+ * timestamp restoration of the compact format.
+ */
+class ContentionBasedFloodingHeaderTestCase : public TestCase
+{
+public:
+  ContentionBasedFloodingHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// Build the headers and add them to the packets
+  void Send (void);
+  /// Remove the headers from the packets and check them
+  void Receive (void);
+
+  Ptr<Packet> m_full;    //!< packet with the full header
+  Ptr<Packet> m_compact; //!< packet with the compact header
+  Ptr<Packet> m_clamped; //!< packet with a compact header out of the origin range
+  Time m_ts;             //!< timestamp of the headers
+};
+
+ContentionBasedFloodingHeaderTestCase::ContentionBasedFloodingHeaderTestCase ()
+  : TestCase ("Round trip of the flooding header formats")
+{
+}
+
+void
+ContentionBasedFloodingHeaderTestCase::Send (void)
+{
+  m_ts = Simulator::Now ();
+  ContentionBasedFloodingHeader header;
+  header.SetSeq (300);
+  header.SetSrc (5);
+  header.SetLastHop (150);
+  header.SetNumHops (3);
+  header.SetStartPos (Vector (1000.7, 2000, 120));
+  header.SetLastPos (Vector (1500, 2500.2, 80));
+
+  m_full = Create<Packet> (100);
+  m_full->AddHeader (header);
+
+  header.SetCompact (true, Vector (500, 500, 0));
+  // 2 + 5 + 1 + 2 + 1 bytes of seq, ts, src, lastHop and numHops, 12 of positions
+  NS_TEST_EXPECT_MSG_EQ (header.GetSerializedSize (), 23, "wrong compact size");
+  NS_TEST_EXPECT_MSG_LT (header.GetSerializedSize (), ContentionBasedFloodingHeader ().GetSerializedSize (), "compact format not smaller");
+  m_compact = Create<Packet> (100);
+  m_compact->AddHeader (header);
+
+  header.SetSeq (0xffffffff);
+  header.SetStartPos (Vector (100, 400, 0));
+  header.SetLastPos (Vector (70000, 500, 65535));
+  m_clamped = Create<Packet> (100);
+  m_clamped->AddHeader (header);
+}
+
+void
+ContentionBasedFloodingHeaderTestCase::Receive (void)
+{
+  ContentionBasedFloodingHeader full;
+  m_full->RemoveHeader (full);
+  ContentionBasedFloodingHeader compact;
+  compact.SetCompact (true, Vector (500, 500, 0));
+  m_compact->RemoveHeader (compact);
+  NS_TEST_EXPECT_MSG_EQ (m_compact->GetSize (), 100, "compact header not fully removed");
+
+  NS_TEST_EXPECT_MSG_EQ (compact.GetSeq (), 300, "wrong seq");
+  NS_TEST_EXPECT_MSG_EQ (compact.GetSrc (), 5, "wrong src");
+  NS_TEST_EXPECT_MSG_EQ (compact.GetLastHop (), 150, "wrong lastHop");
+  NS_TEST_EXPECT_MSG_EQ (compact.GetNumHops (), 3, "wrong numHops");
+  NS_TEST_EXPECT_MSG_EQ (compact.GetTs (), m_ts, "wrong ts");
+  NS_TEST_EXPECT_MSG_EQ (compact.GetStartPos (), Vector (1000, 2000, 120), "wrong startPos");
+  NS_TEST_EXPECT_MSG_EQ (compact.GetLastPos (), Vector (1500, 2500, 80), "wrong lastPos");
+
+  // Both formats decode to the same header
+  NS_TEST_EXPECT_MSG_EQ (full.GetSeq (), compact.GetSeq (), "formats differ in seq");
+  NS_TEST_EXPECT_MSG_EQ (full.GetSrc (), compact.GetSrc (), "formats differ in src");
+  NS_TEST_EXPECT_MSG_EQ (full.GetLastHop (), compact.GetLastHop (), "formats differ in lastHop");
+  NS_TEST_EXPECT_MSG_EQ (full.GetNumHops (), compact.GetNumHops (), "formats differ in numHops");
+  NS_TEST_EXPECT_MSG_EQ (full.GetTs (), compact.GetTs (), "formats differ in ts");
+  NS_TEST_EXPECT_MSG_EQ (full.GetStartPos (), compact.GetStartPos (), "formats differ in startPos");
+  NS_TEST_EXPECT_MSG_EQ (full.GetLastPos (), compact.GetLastPos (), "formats differ in lastPos");
+
+  ContentionBasedFloodingHeader clamped;
+  clamped.SetCompact (true, Vector (500, 500, 0));
+  m_clamped->RemoveHeader (clamped);
+  NS_TEST_EXPECT_MSG_EQ (clamped.GetSeq (), 0xffffffff, "wrong five byte varint");
+  NS_TEST_EXPECT_MSG_EQ (clamped.GetStartPos (), Vector (500, 500, 0), "position not clamped to the origin");
+  NS_TEST_EXPECT_MSG_EQ (clamped.GetLastPos (), Vector (66035, 500, 65535), "position not clamped to the range");
+}
+
+void
+ContentionBasedFloodingHeaderTestCase::DoRun (void)
+{
+  Simulator::Schedule (Seconds (2) + NanoSeconds (123), &ContentionBasedFloodingHeaderTestCase::Send, this);
+  Simulator::Schedule (Seconds (3.5), &ContentionBasedFloodingHeaderTestCase::Receive, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Contention-based flooding header TestSuite
+ */
+class ContentionBasedFloodingHeaderTestSuite : public TestSuite
+{
+public:
+  ContentionBasedFloodingHeaderTestSuite ();
+};
+
+ContentionBasedFloodingHeaderTestSuite::ContentionBasedFloodingHeaderTestSuite ()
+  : TestSuite ("contention-based-flooding-header", UNIT)
+{
+  AddTestCase (new ContentionBasedFloodingHeaderTestCase, TestCase::QUICK);
+}
+
+static ContentionBasedFloodingHeaderTestSuite g_contentionBasedFloodingHeaderTestSuite; //!< Static variable for test initialization
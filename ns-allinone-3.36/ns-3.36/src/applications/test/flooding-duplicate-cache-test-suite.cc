@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flooding-duplicate-cache.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check insertion, lookup, window sliding and age expiry of the
+ * duplicate cache used by the flooding applications.
+ */
+class FloodingDuplicateCacheTestCase : public TestCase
+{
+public:
+  FloodingDuplicateCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// Insert a packet of a source that is not heard of otherwise
+  void InsertLate (void);
+
+  FloodingDuplicateCache m_cache; //!< the cache under test
+};
+
+FloodingDuplicateCacheTestCase::FloodingDuplicateCacheTestCase ()
+  : TestCase ("Duplicate detection of the flooding applications"),
+    m_cache (128, Seconds (10))
+{
+}
+
+void
+FloodingDuplicateCacheTestCase::InsertLate (void)
+{
+  m_cache.Insert (FloodingDuplicateCache::MakeKey (2, 0));
+}
+
+void
+FloodingDuplicateCacheTestCase::DoRun (void)
+{
+  uint64_t key = FloodingDuplicateCache::MakeKey (7, 3);
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (key), false, "empty cache reports a packet");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Insert (key), true, "first insertion not reported as new");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Insert (key), false, "second insertion reported as new");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (key), true, "inserted packet not found");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (FloodingDuplicateCache::MakeKey (8, 3)), false, "sources are not separated");
+
+  // Out of order arrivals within the window
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Insert (FloodingDuplicateCache::MakeKey (7, 100)), true, "newer packet not reported as new");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (FloodingDuplicateCache::MakeKey (7, 50)), false, "skipped packet reported as seen");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Insert (FloodingDuplicateCache::MakeKey (7, 50)), true, "late packet not reported as new");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (key), true, "packet lost after sliding the window");
+
+  // Sliding past a packet clears its bit for the reused slot
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Insert (FloodingDuplicateCache::MakeKey (7, 3 + 128)), true, "packet in reused slot not reported as new");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (FloodingDuplicateCache::MakeKey (7, 100 + 128)), false, "stale bit survived the slide");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Insert (FloodingDuplicateCache::MakeKey (7, 2)), false, "packet older than the window reported as new");
+
+  // Silent sources are forgotten
+  Simulator::Schedule (Seconds (20), &FloodingDuplicateCacheTestCase::InsertLate, this);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_cache.GetNSources (), 1, "silent source not expired");
+  NS_TEST_ASSERT_MSG_EQ (m_cache.Contains (key), false, "expired source still reports packets");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Flooding duplicate cache TestSuite
+ */
+class FloodingDuplicateCacheTestSuite : public TestSuite
+{
+public:
+  FloodingDuplicateCacheTestSuite ();
+};
+
+FloodingDuplicateCacheTestSuite::FloodingDuplicateCacheTestSuite ()
+  : TestSuite ("flooding-duplicate-cache", UNIT)
+{
+  AddTestCase (new FloodingDuplicateCacheTestCase, TestCase::QUICK);
+}
+
+static FloodingDuplicateCacheTestSuite g_floodingDuplicateCacheTestSuite; //!< Static variable for test initialization
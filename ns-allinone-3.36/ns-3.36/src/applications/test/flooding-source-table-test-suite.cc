@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flooding-source-table.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check the columns, the growth and the resets of the per-source state
+ * table of the flooding applications.
+ */
+class FloodingSourceTableTestCase : public TestCase
+{
+public:
+  FloodingSourceTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FloodingSourceTableTestCase::FloodingSourceTableTestCase ()
+  : TestCase ("Per-source state of the flooding applications")
+{
+}
+
+void
+FloodingSourceTableTestCase::DoRun (void)
+{
+  FloodingSourceTable table;
+  Time time;
+  NS_TEST_ASSERT_MSG_EQ (table.IsSeen (3), false, "empty table reports a source");
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastReceived (3, time), false, "empty table reports a reception");
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastForwarded (3, time), false, "empty table reports a forwarding");
+  NS_TEST_ASSERT_MSG_EQ (table.GetPacket (3), 0, "empty table reports a packet");
+
+  NS_TEST_ASSERT_MSG_EQ (table.MarkSeen (3), true, "first mark not reported as new");
+  NS_TEST_ASSERT_MSG_EQ (table.MarkSeen (3), false, "second mark reported as new");
+  NS_TEST_ASSERT_MSG_EQ (table.MarkSeen (1), true, "lower source not reported as new");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSeen (), 2, "wrong number of sources heard of");
+  NS_TEST_ASSERT_MSG_EQ (table.IsSeen (2), false, "source in between reported as seen");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSources (), 4, "table not grown to the highest source");
+
+  // The columns are independent of each other
+  table.SetLastReceived (7, Seconds (2));
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastReceived (7, time), true, "reception not found");
+  NS_TEST_ASSERT_MSG_EQ (time, Seconds (2), "wrong reception time");
+  NS_TEST_ASSERT_MSG_EQ (table.IsSeen (7), false, "reception marks the source as seen");
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastForwarded (7, time), false, "reception reported as forwarding");
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastReceived (3, time), false, "reception reported for another source");
+
+  table.SetLastForwarded (3, Seconds (5));
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastForwarded (3, time), true, "forwarding not found");
+  NS_TEST_ASSERT_MSG_EQ (time, Seconds (5), "wrong forwarding time");
+  table.SetLastForwarded (3, Seconds (6));
+  table.GetLastForwarded (3, time);
+  NS_TEST_ASSERT_MSG_EQ (time, Seconds (6), "forwarding time not replaced");
+
+  Ptr<Packet> packet = Create<Packet> (10);
+  table.SetPacket (9, packet);
+  NS_TEST_ASSERT_MSG_EQ (table.GetPacket (9), packet, "packet not found");
+  NS_TEST_ASSERT_MSG_EQ (table.GetPacket (7), 0, "packet reported for another source");
+
+  // Resetting the sources heard of keeps the other columns
+  table.ClearSeen ();
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSeen (), 0, "sources heard of not cleared");
+  NS_TEST_ASSERT_MSG_EQ (table.IsSeen (3), false, "source still seen after the reset");
+  NS_TEST_ASSERT_MSG_EQ (table.MarkSeen (3), true, "source not new after the reset");
+  NS_TEST_ASSERT_MSG_EQ (table.GetLastReceived (7, time), true, "reception lost by the reset");
+
+  NS_TEST_ASSERT_MSG_GT (table.GetMemoryUsage (), 0, "no memory reported");
+  table.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSources (), 0, "sources not cleared");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNSeen (), 0, "sources heard of not cleared");
+  NS_TEST_ASSERT_MSG_EQ (table.GetPacket (9), 0, "packet not cleared");
+  NS_TEST_ASSERT_MSG_EQ (table.GetMemoryUsage (), 0, "memory not released");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Flooding source table TestSuite
+ */
+class FloodingSourceTableTestSuite : public TestSuite
+{
+public:
+  FloodingSourceTableTestSuite ();
+};
+
+FloodingSourceTableTestSuite::FloodingSourceTableTestSuite ()
+  : TestSuite ("flooding-source-table", UNIT)
+{
+  AddTestCase (new FloodingSourceTableTestCase, TestCase::QUICK);
+}
+
+static FloodingSourceTableTestSuite g_floodingSourceTableTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/flooding-stats.h"
+#include "ns3/flooding-convergence-monitor.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check the totals, the window counters and the periodic snapshots of
+ * the stats block shared by the flooding applications.
+ */
+class FloodingStatsTestCase : public TestCase
+{
+public:
+  FloodingStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// Events of the first window
+  void FirstWindow (void);
+  /// Events of the second window, after a reset of node 0
+  void SecondWindow (void);
+
+  Ptr<FloodingStats> m_stats; //!< the stats block under test
+};
+
+FloodingStatsTestCase::FloodingStatsTestCase ()
+  : TestCase ("Per-node counters and snapshots of the flooding applications")
+{
+}
+
+void
+FloodingStatsTestCase::FirstWindow (void)
+{
+  m_stats->NotifySent (0);
+  m_stats->NotifySent (1);
+  m_stats->NotifyReceived (2);
+  m_stats->NotifySeenNode (2);
+  m_stats->NotifyForwarded (2);
+  m_stats->NotifyUpdate (2, Seconds (0.5), false);
+  m_stats->NotifyUpdate (2, Seconds (1.5), true);
+}
+
+void
+FloodingStatsTestCase::SecondWindow (void)
+{
+  m_stats->ResetNode (0);
+  m_stats->NotifySeenNode (0);
+  m_stats->NotifyUpdate (0, Seconds (1), false);
+}
+
+void
+FloodingStatsTestCase::DoRun (void)
+{
+  m_stats = CreateObject<FloodingStats> ();
+  m_stats->SetAttribute ("SnapshotInterval", TimeValue (Seconds (1)));
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_stats->AddNode (i);
+    }
+  m_stats->AddNode (1);
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetNNodes (), 3, "node added twice is counted twice");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetTotals ().pe500, 0.0, "pe500 without updates is not 0");
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetTotals ().meanAoi, 0.0, "mean AoI without updates is not 0");
+  m_stats->Initialize ();
+
+  Simulator::Schedule (Seconds (0.5), &FloodingStatsTestCase::FirstWindow, this);
+  Simulator::Schedule (Seconds (1.5), &FloodingStatsTestCase::SecondWindow, this);
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+
+  const std::vector<FloodingStatsSnapshot> &snapshots = m_stats->GetSnapshots ();
+  NS_TEST_ASSERT_MSG_EQ (snapshots.size (), 2, "wrong number of snapshots");
+
+  const FloodingStatsSnapshot &first = snapshots[0];
+  NS_TEST_ASSERT_MSG_EQ (first.time, Seconds (1), "wrong time of the first snapshot");
+  NS_TEST_ASSERT_MSG_EQ (first.sent, 2, "wrong number of sent packets");
+  NS_TEST_ASSERT_MSG_EQ (first.received, 1, "wrong number of received packets");
+  NS_TEST_ASSERT_MSG_EQ (first.forwarded, 1, "wrong number of forwarded packets");
+  NS_TEST_ASSERT_MSG_EQ_TOL (first.pd, 1.0 / 6, 1e-12, "wrong dissemination rate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (first.pe500, 0.5, 1e-12, "wrong excess probability");
+  NS_TEST_ASSERT_MSG_EQ_TOL (first.meanAoi, 1.0, 1e-12, "wrong mean AoI");
+  NS_TEST_ASSERT_MSG_EQ (first.windowSent, 2, "wrong number of sent packets in the window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (first.windowPd, 1.0 / 4, 1e-12, "wrong dissemination rate in the window");
+  NS_TEST_ASSERT_MSG_EQ (first.windowUpdates, 2, "wrong number of updates in the window");
+
+  // Node 0 was reset, the window only covers the second second
+  const FloodingStatsSnapshot &second = snapshots[1];
+  NS_TEST_ASSERT_MSG_EQ (second.sent, 1, "reset node still counts its packets");
+  NS_TEST_ASSERT_MSG_EQ_TOL (second.pd, 2.0 / 6, 1e-12, "wrong dissemination rate after the reset");
+  NS_TEST_ASSERT_MSG_EQ_TOL (second.pe500, 1.0 / 3, 1e-12, "wrong excess probability after the reset");
+  NS_TEST_ASSERT_MSG_EQ (second.windowSent, 0, "window not cleared by the snapshot");
+  NS_TEST_ASSERT_MSG_EQ_TOL (second.windowPe500, 0.0, 1e-12, "wrong excess probability in the window");
+  NS_TEST_ASSERT_MSG_EQ_TOL (second.windowMeanAoi, 1.0, 1e-12, "wrong mean AoI in the window");
+
+  m_stats->Reset ();
+  NS_TEST_ASSERT_MSG_EQ (m_stats->GetTotals ().received, 0, "counters survived the reset");
+
+  Simulator::Destroy ();
+  m_stats = 0;
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the convergence monitor stops a simulation with stable KPIs
+ * and lets a simulation with fluctuating KPIs run to the end.
+ */
+class FloodingConvergenceMonitorTestCase : public TestCase
+{
+public:
+  FloodingConvergenceMonitorTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run a simulation with one update per second and source.
+   * \param fluctuating if true, the updates alternate between late and in time every second
+   * \return the monitor of the run
+   */
+  Ptr<FloodingConvergenceMonitor> Run (bool fluctuating);
+  /**
+   * Generate the updates of one second.
+   * \param fluctuating alternate between late and in time
+   */
+  void Updates (bool fluctuating);
+
+  Ptr<FloodingStats> m_stats; //!< the stats block of the current run
+  uint32_t m_second;          //!< seconds generated so far
+};
+
+FloodingConvergenceMonitorTestCase::FloodingConvergenceMonitorTestCase ()
+  : TestCase ("Early termination once the flooding KPIs converged")
+{
+}
+
+void
+FloodingConvergenceMonitorTestCase::Updates (bool fluctuating)
+{
+  if (fluctuating)
+    {
+      bool late = m_second % 2;
+      m_stats->NotifyUpdate (0, Seconds (1), late);
+      m_stats->NotifyUpdate (1, Seconds (1), late);
+    }
+  else
+    {
+      m_stats->NotifyUpdate (0, Seconds (1), false);
+      m_stats->NotifyUpdate (1, Seconds (1), true);
+    }
+  // Node 1 receives every packet of node 0
+  m_stats->NotifySent (0);
+  m_stats->NotifyReceived (1);
+  m_second++;
+  Simulator::Schedule (Seconds (1), &FloodingConvergenceMonitorTestCase::Updates, this, fluctuating);
+}
+
+Ptr<FloodingConvergenceMonitor>
+FloodingConvergenceMonitorTestCase::Run (bool fluctuating)
+{
+  m_second = 0;
+  m_stats = CreateObject<FloodingStats> ();
+  m_stats->SetAttribute ("SnapshotInterval", TimeValue (Seconds (1)));
+  m_stats->AddNode (0);
+  m_stats->AddNode (1);
+  m_stats->NotifySeenNode (0);
+  m_stats->Initialize ();
+
+  Ptr<FloodingConvergenceMonitor> monitor = CreateObject<FloodingConvergenceMonitor> ();
+  monitor->SetAttribute ("Threshold", DoubleValue (0.05));
+  monitor->SetAttribute ("Batches", UintegerValue (5));
+  monitor->Monitor (m_stats);
+
+  Simulator::Schedule (Seconds (0.5), &FloodingConvergenceMonitorTestCase::Updates, this, fluctuating);
+  Simulator::Stop (Seconds (30.5));
+  Simulator::Run ();
+  return monitor;
+}
+
+void
+FloodingConvergenceMonitorTestCase::DoRun (void)
+{
+  std::deque<double> values = {1, 2, 3};
+  NS_TEST_ASSERT_MSG_EQ_TOL (FloodingConvergenceMonitor::GetRelativeHalfWidth (values), 4.303 / std::sqrt (3.0) / 2, 1e-9, "wrong confidence interval");
+
+  Ptr<FloodingConvergenceMonitor> monitor = Run (false);
+  NS_TEST_ASSERT_MSG_EQ (monitor->HasConverged (), true, "stable KPIs did not converge");
+  NS_TEST_ASSERT_MSG_EQ (monitor->GetStopReason (), "converged", "wrong stop reason");
+  NS_TEST_ASSERT_MSG_EQ (monitor->GetStopTime (), Seconds (5), "wrong convergence time");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (5), "simulation not stopped at convergence");
+  Simulator::Destroy ();
+
+  monitor = Run (true);
+  NS_TEST_ASSERT_MSG_EQ (monitor->HasConverged (), false, "fluctuating KPIs converged");
+  NS_TEST_ASSERT_MSG_EQ (monitor->GetStopReason (), "simTime", "wrong stop reason");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (30.5), "simulation stopped early");
+  Simulator::Destroy ();
+  m_stats = 0;
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief Flooding stats TestSuite
+ */
+class FloodingStatsTestSuite : public TestSuite
+{
+public:
+  FloodingStatsTestSuite ();
+};
+
+FloodingStatsTestSuite::FloodingStatsTestSuite ()
+  : TestSuite ("flooding-stats", UNIT)
+{
+  AddTestCase (new FloodingStatsTestCase, TestCase::QUICK);
+  AddTestCase (new FloodingConvergenceMonitorTestCase, TestCase::QUICK);
+}
+
+static FloodingStatsTestSuite g_floodingStatsTestSuite; //!< Static variable for test initialization
@@ -27,11 +27,259 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("BuildingList");
 
+/**
+ * \brief uniform grid over the footprints of the buildings, a private
+ * implementation detail of the BuildingList API.
+ *
+ * Every cell lists the buildings whose footprint overlaps it. A line
+ * segment visits the cells under its projection column by column, and
+ * only the buildings listed there are tested for intersection.
+ */
+class BuildingGrid
+{
+public:
+  BuildingGrid ();
+  /**
+   * Index the boundaries of the buildings.
+   * \param buildings the buildings
+   */
+  void Build (const std::vector<Ptr<Building> > &buildings);
+  /**
+   * \param l1 first point of the line segment
+   * \param l2 second point of the line segment
+   * \returns true if the line segment intersects at least one building
+   */
+  bool IsIntersect (const Vector &l1, const Vector &l2) const;
+  /**
+   * \param position a position
+   * \returns the indices of the buildings whose footprint is near the position
+   */
+  const std::vector<uint32_t> &GetBuildingsNear (const Vector &position) const;
+
+private:
+  /**
+   * \param x a coordinate along x
+   * \returns the column of the coordinate, clamped to the grid
+   */
+  uint32_t GetColumn (double x) const;
+  /**
+   * \param y a coordinate along y
+   * \returns the row of the coordinate, clamped to the grid
+   */
+  uint32_t GetRow (double y) const;
+  /**
+   * Test the buildings of a cell not tested yet by the current query.
+   * \param cell the index of the cell
+   * \param l1 first point of the line segment
+   * \param l2 second point of the line segment
+   * \returns true if one of them intersects the line segment
+   */
+  bool IsIntersectInCell (uint32_t cell, const Vector &l1, const Vector &l2) const;
+
+  std::vector<Box> m_bounds;                    //!< Boundaries of the buildings, by index
+  std::vector<std::vector<uint32_t> > m_cells;  //!< Buildings overlapping each cell, row after row
+  std::vector<uint32_t> m_all;                  //!< Every building, used when there is no grid
+  double m_xMin;                                //!< Lower x bound of the grid
+  double m_yMin;                                //!< Lower y bound of the grid
+  double m_xMax;                                //!< Upper x bound of the grid
+  double m_yMax;                                //!< Upper y bound of the grid
+  double m_cellSize;                            //!< Side of the cells
+  uint32_t m_columns;                           //!< Number of columns
+  uint32_t m_rows;                              //!< Number of rows
+  bool m_linear;                                //!< Whether the buildings are scanned linearly
+  mutable std::vector<uint32_t> m_visited;      //!< Query that last tested each building
+  mutable uint32_t m_query;                     //!< Identifier of the current query
+  std::vector<uint32_t> m_none;                 //!< Empty list of buildings
+};
+
+BuildingGrid::BuildingGrid ()
+  : m_xMin (0),
+    m_yMin (0),
+    m_xMax (0),
+    m_yMax (0),
+    m_cellSize (1),
+    m_columns (0),
+    m_rows (0),
+    m_linear (true),
+    m_query (0)
+{
+}
+
+void
+BuildingGrid::Build (const std::vector<Ptr<Building> > &buildings)
+{
+  NS_LOG_FUNCTION (this << buildings.size ());
+  m_bounds.clear ();
+  m_cells.clear ();
+  m_all.clear ();
+  m_visited.assign (buildings.size (), 0);
+  m_query = 0;
+  m_xMin = m_yMin = std::numeric_limits<double>::infinity ();
+  m_xMax = m_yMax = -std::numeric_limits<double>::infinity ();
+  for (uint32_t i = 0; i < buildings.size (); ++i)
+    {
+      Box bounds = buildings[i]->GetBoundaries ();
+      m_bounds.push_back (bounds);
+      m_all.push_back (i);
+      m_xMin = std::min (m_xMin, bounds.xMin);
+      m_yMin = std::min (m_yMin, bounds.yMin);
+      m_xMax = std::max (m_xMax, bounds.xMax);
+      m_yMax = std::max (m_yMax, bounds.yMax);
+    }
+  double width = m_xMax - m_xMin;
+  double height = m_yMax - m_yMin;
+  m_linear = buildings.size () < 2 || !std::isfinite (width) || !std::isfinite (height);
+  if (m_linear)
+    {
+      m_columns = m_rows = 0;
+      return;
+    }
+
+  // About one building per cell, with at most 1024 cells along each axis
+  const double maxCells = 1024;
+  m_cellSize = std::sqrt (width * height / buildings.size ());
+  m_cellSize = std::max ({m_cellSize, width / maxCells, height / maxCells});
+  if (m_cellSize <= 0)
+    {
+      m_cellSize = std::max ({width, height, 1.0});
+    }
+  m_columns = static_cast<uint32_t> (width / m_cellSize) + 1;
+  m_rows = static_cast<uint32_t> (height / m_cellSize) + 1;
+  m_cells.resize (static_cast<std::size_t> (m_columns) * m_rows);
+  // The footprints are padded, so that a point on their border is found in every cell it touches
+  double pad = m_cellSize * 1e-9;
+  for (uint32_t i = 0; i < m_bounds.size (); ++i)
+    {
+      uint32_t rowEnd = GetRow (m_bounds[i].yMax + pad);
+      uint32_t columnEnd = GetColumn (m_bounds[i].xMax + pad);
+      for (uint32_t row = GetRow (m_bounds[i].yMin - pad); row <= rowEnd; ++row)
+        {
+          for (uint32_t column = GetColumn (m_bounds[i].xMin - pad); column <= columnEnd; ++column)
+            {
+              m_cells[row * m_columns + column].push_back (i);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("indexed " << m_bounds.size () << " buildings in " << m_columns << "x" << m_rows
+                           << " cells of " << m_cellSize << " m");
+}
+
+uint32_t
+BuildingGrid::GetColumn (double x) const
+{
+  double column = std::floor ((x - m_xMin) / m_cellSize);
+  return static_cast<uint32_t> (std::min (std::max (column, 0.0), m_columns - 1.0));
+}
+
+uint32_t
+BuildingGrid::GetRow (double y) const
+{
+  double row = std::floor ((y - m_yMin) / m_cellSize);
+  return static_cast<uint32_t> (std::min (std::max (row, 0.0), m_rows - 1.0));
+}
+
+bool
+BuildingGrid::IsIntersectInCell (uint32_t cell, const Vector &l1, const Vector &l2) const
+{
+  for (uint32_t i : m_cells[cell])
+    {
+      if (m_visited[i] != m_query)
+        {
+          m_visited[i] = m_query;
+          if (m_bounds[i].IsIntersect (l1, l2))
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+bool
+BuildingGrid::IsIntersect (const Vector &l1, const Vector &l2) const
+{
+  if (m_linear)
+    {
+      for (const Box &bounds : m_bounds)
+        {
+          if (bounds.IsIntersect (l1, l2))
+            {
+              return true;
+            }
+        }
+      return false;
+    }
+  if (++m_query == 0)
+    {
+      // the identifiers wrapped around
+      std::fill (m_visited.begin (), m_visited.end (), 0);
+      m_query = 1;
+    }
+
+  // The part of the segment over the grid, along x
+  double xLow = std::max (std::min (l1.x, l2.x), m_xMin);
+  double xHigh = std::min (std::max (l1.x, l2.x), m_xMax);
+  if (xLow > xHigh || std::max (l1.y, l2.y) < m_yMin || std::min (l1.y, l2.y) > m_yMax)
+    {
+      return false;
+    }
+  double dx = l2.x - l1.x;
+  double slope = (dx != 0) ? (l2.y - l1.y) / dx : 0;
+  double pad = m_cellSize * 1e-9;
+  uint32_t columnEnd = GetColumn (xHigh + pad);
+  for (uint32_t column = GetColumn (xLow - pad); column <= columnEnd; ++column)
+    {
+      // The rows under the part of the segment within this column
+      double yLow;
+      double yHigh;
+      if (dx == 0)
+        {
+          yLow = std::min (l1.y, l2.y);
+          yHigh = std::max (l1.y, l2.y);
+        }
+      else
+        {
+          double x1 = std::max (xLow, m_xMin + column * m_cellSize);
+          double x2 = std::min (xHigh, m_xMin + (column + 1) * m_cellSize);
+          double y1 = l1.y + (x1 - l1.x) * slope;
+          double y2 = l1.y + (x2 - l1.x) * slope;
+          yLow = std::min (y1, y2);
+          yHigh = std::max (y1, y2);
+        }
+      uint32_t rowEnd = GetRow (yHigh + pad);
+      for (uint32_t row = GetRow (yLow - pad); row <= rowEnd; ++row)
+        {
+          if (IsIntersectInCell (row * m_columns + column, l1, l2))
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+const std::vector<uint32_t> &
+BuildingGrid::GetBuildingsNear (const Vector &position) const
+{
+  if (m_linear)
+    {
+      return m_all;
+    }
+  if (position.x < m_xMin || position.x > m_xMax || position.y < m_yMin || position.y > m_yMax)
+    {
+      return m_none;
+    }
+  return m_cells[GetRow (position.y) * m_columns + GetColumn (position.x)];
+}
+
 /**
  * \brief private implementation detail of the BuildingList API.
  */
@@ -76,6 +324,21 @@ public:
    * \returns the container size
    */
   uint32_t GetNBuildings (void);
+  /**
+   * \param l1 first point of the line segment
+   * \param l2 second point of the line segment
+   * \returns true if the line segment intersects at least one building
+   */
+  bool IsIntersect (const Vector &l1, const Vector &l2);
+  /**
+   * \param position a position
+   * \returns the indices of the buildings whose footprint is near the position
+   */
+  const std::vector<uint32_t> &GetBuildingsNear (const Vector &position);
+  /**
+   * Invalidate the spatial index of every BuildingListPriv.
+   */
+  static void NotifyBoundariesChanged (void);
 
   /**
    * Get the Singleton instance of BuildingListPriv (or create one)
@@ -97,9 +360,19 @@ private:
    * 
    */
   static void Delete (void);
+  /**
+   * \returns the spatial index of the buildings, rebuilt if they changed
+   */
+  const BuildingGrid &GetGrid (void);
+
   std::vector<Ptr<Building> > m_buildings; //!< Container of Building
+  BuildingGrid m_grid; //!< Spatial index of the buildings
+  uint64_t m_gridVersion; //!< Version of the boundaries indexed in m_grid
+  static uint64_t m_boundariesVersion; //!< Version of the boundaries of the buildings
 };
 
+uint64_t BuildingListPriv::m_boundariesVersion = 1;
+
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
 
 TypeId
@@ -143,6 +416,7 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_gridVersion (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -170,6 +444,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  NotifyBoundariesChanged ();
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -190,6 +465,35 @@ BuildingListPriv::GetNBuildings (void)
   return m_buildings.size ();
 }
 
+void
+BuildingListPriv::NotifyBoundariesChanged (void)
+{
+  m_boundariesVersion++;
+}
+
+const BuildingGrid &
+BuildingListPriv::GetGrid (void)
+{
+  if (m_gridVersion != m_boundariesVersion)
+    {
+      m_grid.Build (m_buildings);
+      m_gridVersion = m_boundariesVersion;
+    }
+  return m_grid;
+}
+
+bool
+BuildingListPriv::IsIntersect (const Vector &l1, const Vector &l2)
+{
+  return GetGrid ().IsIntersect (l1, l2);
+}
+
+const std::vector<uint32_t> &
+BuildingListPriv::GetBuildingsNear (const Vector &position)
+{
+  return GetGrid ().GetBuildingsNear (position);
+}
+
 Ptr<Building>
 BuildingListPriv::GetBuilding (uint32_t n)
 {
@@ -233,4 +537,20 @@ BuildingList::GetNBuildings (void)
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
 
+bool
+BuildingList::IsIntersect (const Vector &l1, const Vector &l2)
+{
+  return BuildingListPriv::Get ()->IsIntersect (l1, l2);
+}
+const std::vector<uint32_t> &
+BuildingList::GetBuildingsNear (const Vector &position)
+{
+  return BuildingListPriv::Get ()->GetBuildingsNear (position);
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::NotifyBoundariesChanged ();
+}
+
 } // namespace ns3
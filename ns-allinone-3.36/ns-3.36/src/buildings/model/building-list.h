@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -66,6 +67,30 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param l1 first point of the line segment
+   * \param l2 second point of the line segment
+   * \returns true if the line segment intersects at least one building
+   *
+   * The buildings are looked up in a uniform grid over their footprints,
+   * rebuilt when a building is added or its boundaries change, so that
+   * only the buildings near the segment are tested.
+   */
+  static bool IsIntersect (const Vector &l1, const Vector &l2);
+  /**
+   * \param position a position
+   * \returns the indices of the buildings whose footprint is near the
+   *          position, in increasing order. The other buildings do not
+   *          contain the position.
+   */
+  static const std::vector<uint32_t> &GetBuildingsNear (const Vector &position);
+  /**
+   * Invalidate the spatial index of the buildings.
+   *
+   * This method is called automatically from Building::SetBoundaries so
+   * the user has little reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
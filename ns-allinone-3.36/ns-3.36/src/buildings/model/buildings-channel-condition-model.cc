@@ -117,19 +117,10 @@ BuildingsChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
 bool
 BuildingsChannelConditionModel::IsLineOfSightBlocked (const ns3::Vector &l1, const ns3::Vector &l2) const
 {
-  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
-    {
-      if ((*bit)->IsIntersect (l1, l2))
-        {
-          // The line of sight should be blocked if the line-segment between
-          // l1 and l2 intersects one of the buildings.
-          return true;
-        }
-    }
-
-  // The line of sight should not be blocked if the line-segment between
-  // l1 and l2 did not intersect any building.
-  return false;
+  // The line of sight should be blocked if the line-segment between
+  // l1 and l2 intersects one of the buildings. The BuildingList index
+  // only tests the buildings near the line-segment.
+  return BuildingList::IsIntersect (l1, l2);
 }
 
 int64_t
@@ -25,7 +25,12 @@
 #include "ns3/mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <tuple>
 #include "buildings-propagation-loss-model.h"
 #include <ns3/mobility-building-info.h>
 #include "ns3/enum.h"
@@ -37,28 +42,6 @@ NS_LOG_COMPONENT_DEFINE ("BuildingsPropagationLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingsPropagationLossModel);
 
-BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss ()
-{
-}
-
-BuildingsPropagationLossModel::ShadowingLoss::ShadowingLoss (double shadowingValue, Ptr<MobilityModel> receiver)
-  : m_shadowingValue (shadowingValue), m_receiver (receiver)
-{
-  NS_LOG_INFO (this << " New Shadowing value " << m_shadowingValue);
-}
-
-double
-BuildingsPropagationLossModel::ShadowingLoss::GetLoss () const
-{
-  return (m_shadowingValue);
-}
-
-Ptr<MobilityModel>
-BuildingsPropagationLossModel::ShadowingLoss::GetReceiver () const
-{
-  return m_receiver;
-}
-
 TypeId
 BuildingsPropagationLossModel::GetTypeId (void)
 {
@@ -89,13 +72,36 @@ BuildingsPropagationLossModel::GetTypeId (void)
                    "Additional loss for each internal wall [dB]",
                    DoubleValue (5.0),
                    MakeDoubleAccessor (&BuildingsPropagationLossModel::m_lossInternalWall),
-                   MakeDoubleChecker<double> ());
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxShadowingEntries",
+                   "Maximum number of node pairs whose shadowing is kept, zero for no limit. "
+                   "When the cache is full, a quarter of it is evicted: first the pairs farther "
+                   "apart than ShadowingEvictionDistance, then the least recently used ones. "
+                   "An evicted pair draws a new shadowing value when it is used again.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&BuildingsPropagationLossModel::m_maxShadowingEntries),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ShadowingEvictionDistance",
+                   "Distance [m] beyond which the pairs of nodes are evicted first from a full shadowing cache",
+                   DoubleValue (std::numeric_limits<double>::infinity ()),
+                   MakeDoubleAccessor (&BuildingsPropagationLossModel::m_shadowingEvictionDistance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("ShadowingCorrelationDistance",
+                   "Decorrelation distance [m] of the shadowing. When it is positive, the shadowing "
+                   "of a pair of nodes follows their relative displacement with the exponential "
+                   "autocorrelation of Gudmundson's model. Zero keeps the value of a pair constant.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&BuildingsPropagationLossModel::m_shadowingCorrelationDistance),
+                   MakeDoubleChecker<double> (0.0));
 
 
   return tid;
 }
 
 BuildingsPropagationLossModel::BuildingsPropagationLossModel ()
+  : m_maxShadowingEntries (0),
+    m_shadowingEvictionDistance (std::numeric_limits<double>::infinity ()),
+    m_shadowingCorrelationDistance (0.0)
 {
   m_randVariable = CreateObject<NormalRandomVariable> ();
 }
@@ -145,44 +151,95 @@ BuildingsPropagationLossModel::InternalWallsLoss (Ptr<MobilityBuildingInfo> a, P
 
 
 
+uint32_t
+BuildingsPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  auto it = m_indices.find (PeekPointer (mobility));
+  if (it != m_indices.end ())
+    {
+      return it->second;
+    }
+  uint32_t index = m_mobilityModels.size ();
+  m_indices.insert ({PeekPointer (mobility), index});
+  m_mobilityModels.push_back (mobility);
+  return index;
+}
+
 double
 BuildingsPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
 const
 {
-    Ptr<MobilityBuildingInfo> a1 = a->GetObject <MobilityBuildingInfo> ();
-    Ptr<MobilityBuildingInfo> b1 = b->GetObject <MobilityBuildingInfo> ();
-    NS_ASSERT_MSG ((a1 != 0) && (b1 != 0), "BuildingsPropagationLossModel only works with MobilityBuildingInfo");
-  
-  std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> >::iterator ait = m_shadowingLossMap.find (a);
-  if (ait != m_shadowingLossMap.end ())
+  Ptr<MobilityBuildingInfo> a1 = a->GetObject <MobilityBuildingInfo> ();
+  Ptr<MobilityBuildingInfo> b1 = b->GetObject <MobilityBuildingInfo> ();
+  NS_ASSERT_MSG ((a1 != 0) && (b1 != 0), "BuildingsPropagationLossModel only works with MobilityBuildingInfo");
+
+  uint64_t key = (static_cast<uint64_t> (GetIndex (a)) << 32) | GetIndex (b);
+  Vector distance = b->GetPosition () - a->GetPosition ();
+  double sigma = EvaluateSigma (a1, b1);
+  auto it = m_shadowingCache.find (key);
+  // without correlation, the value of a pair is kept even if its indoor/outdoor condition changes
+  if (it != m_shadowingCache.end ()
+      && (it->second.m_sigma == sigma || m_shadowingCorrelationDistance == 0))
     {
-      std::map<Ptr<MobilityModel>, ShadowingLoss>::iterator bit = ait->second.find (b);
-      if (bit != ait->second.end ())
-        {
-          return (bit->second.GetLoss ());
-        }
-      else
+      ShadowingEntry &entry = it->second;
+      entry.m_lastUse = Simulator::Now ();
+      if (m_shadowingCorrelationDistance > 0)
         {
-          double sigma = EvaluateSigma (a1, b1);
-          // side effect: will create new entry          
-          // sigma is standard deviation, not variance
-          double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
-          ait->second[b] = ShadowingLoss (shadowingValue, b);          
-          return (ait->second[b].GetLoss ());
+          double displacement = CalculateDistance (distance, entry.m_distance);
+          if (displacement > 0)
+            {
+              // sigma is standard deviation, not variance
+              double r = std::exp (-displacement / m_shadowingCorrelationDistance);
+              entry.m_shadowing = r * entry.m_shadowing
+                + std::sqrt (1 - r * r) * m_randVariable->GetValue (0.0, (sigma * sigma));
+              entry.m_distance = distance;
+              NS_LOG_INFO (this << " Updated shadowing value " << entry.m_shadowing);
+            }
         }
+      return entry.m_shadowing;
     }
-  else
+
+  // a new pair, or a correlated pair whose indoor/outdoor condition changed, draws a new value
+  if (it == m_shadowingCache.end () && m_maxShadowingEntries > 0
+      && m_shadowingCache.size () >= m_maxShadowingEntries)
     {
-      double sigma = EvaluateSigma (a1, b1);
-      // side effect: will create new entries in both maps
-      // sigma is standard deviation, not variance
-      double shadowingValue = m_randVariable->GetValue (0.0, (sigma*sigma));
-      m_shadowingLossMap[a][b] = ShadowingLoss (shadowingValue, b);  
-      return (m_shadowingLossMap[a][b].GetLoss ());       
+      EvictShadowing ();
     }
+  ShadowingEntry &entry = m_shadowingCache[key];
+  // sigma is standard deviation, not variance
+  entry.m_shadowing = m_randVariable->GetValue (0.0, (sigma * sigma));
+  entry.m_sigma = sigma;
+  entry.m_distance = distance;
+  entry.m_lastUse = Simulator::Now ();
+  NS_LOG_INFO (this << " New Shadowing value " << entry.m_shadowing);
+  return entry.m_shadowing;
 }
 
+void
+BuildingsPropagationLossModel::EvictShadowing (void) const
+{
+  // Far pairs first, then the least recently used ones; the key makes the order deterministic
+  std::vector<std::tuple<bool, Time, uint64_t> > candidates;
+  candidates.reserve (m_shadowingCache.size ());
+  for (const auto &pair : m_shadowingCache)
+    {
+      bool near = pair.second.m_distance.GetLength () <= m_shadowingEvictionDistance;
+      candidates.emplace_back (near, pair.second.m_lastUse, pair.first);
+    }
+  std::size_t evicted = m_shadowingCache.size () - (m_maxShadowingEntries / 4) * 3;
+  std::nth_element (candidates.begin (), candidates.begin () + (evicted - 1), candidates.end ());
+  for (std::size_t i = 0; i < evicted; i++)
+    {
+      m_shadowingCache.erase (std::get<2> (candidates[i]));
+    }
+  NS_LOG_LOGIC (this << " evicted " << evicted << " shadowing values");
+}
 
+std::size_t
+BuildingsPropagationLossModel::GetShadowingCacheSize (void) const
+{
+  return m_shadowingCache.size ();
+}
 
 double
 BuildingsPropagationLossModel::EvaluateSigma (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b)
@@ -28,6 +28,8 @@
 #include "ns3/random-variable-stream.h"
 #include <ns3/building.h>
 #include <ns3/mobility-building-info.h>
+#include <unordered_map>
+#include <vector>
 
 
 
@@ -75,6 +77,11 @@ public:
   // inherited from PropagationLossModel
   virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+  /**
+   * \returns the number of pairs of nodes in the shadowing cache
+   */
+  std::size_t GetShadowingCacheSize (void) const;
+
 protected:
   /**
    * Calculate the external wall loss
@@ -107,35 +114,38 @@ protected:
   double m_lossInternalWall; //!< loss from internal walls (in dBm)
 
   /**
-   * \ingroup propagation
-   * 
-   * This model allows the computation of shadowing loss
+   * Shadowing of an ordered pair of nodes
    */
-  class ShadowingLoss
+  struct ShadowingEntry
   {
-  public:
-    ShadowingLoss ();
-    /**
-     * Constructor
-     * \param shadowingValue Value for shadowing
-     * \param receiver Receiver position
-     */
-    ShadowingLoss (double shadowingValue, Ptr<MobilityModel> receiver);
-    /**
-     * \returns the loss (in dBm)
-     */
-    double GetLoss () const;
-    /**
-     * \returns the receiver mobility model
-     */
-    Ptr<MobilityModel> GetReceiver (void) const;
-  protected:
-    double m_shadowingValue; //!< Shadowing value
-    Ptr<MobilityModel> m_receiver; //!< The receiver mobility model
+    double m_shadowing; //!< Shadowing value (in dB)
+    double m_sigma;     //!< Standard deviation the value was drawn with (in dB)
+    Vector m_distance;  //!< Position of the receiver relative to the transmitter at the last update
+    Time m_lastUse;     //!< Time of the last lookup
   };
 
-  /// Map of the shadowng loss
-  mutable std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> > m_shadowingLossMap;
+  /**
+   * Return the dense index of a mobility model, assigned the first time the
+   * model is seen.
+   * \param mobility the mobility model
+   * \returns the index of the mobility model
+   */
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+  /**
+   * Evict a quarter of the shadowing cache: first the pairs farther apart
+   * than the eviction distance, then the least recently used ones.
+   */
+  void EvictShadowing (void) const;
+
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_indices; //!< Dense index of every mobility model
+  /// Mobility models by index, kept alive so that their addresses are not reused
+  mutable std::vector<Ptr<MobilityModel> > m_mobilityModels;
+  /// Shadowing of the pairs of nodes, keyed on their indices
+  mutable std::unordered_map<uint64_t, ShadowingEntry> m_shadowingCache;
+  uint32_t m_maxShadowingEntries; //!< Maximum number of pairs in the shadowing cache, zero for no limit
+  double m_shadowingEvictionDistance; //!< Distance (in m) beyond which pairs are evicted first
+  double m_shadowingCorrelationDistance; //!< Decorrelation distance (in m) of the shadowing, zero to disable
+
   /**
    * Calculate the Standard deviation of the normal distribution used to calculate the shadowing
    * \param a Room A data
@@ -25,6 +25,8 @@
 #include "ns3/buildings-module.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include <algorithm>
 
 using namespace ns3;
 
@@ -142,6 +144,143 @@ BuildingsChannelConditionModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * Test case for the spatial index of the BuildingList. It checks that the
+ * buildings intersecting random line segments and containing random positions
+ * are the ones found by testing every building.
+ */
+class BuildingListIndexTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  BuildingListIndexTestCase ();
+
+  /**
+   * Destructor
+   */
+  virtual ~BuildingListIndexTestCase ();
+
+private:
+  /**
+   * Builds the buildings and perform the tests
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Test every building
+   * \param l1 first point of the line segment
+   * \param l2 second point of the line segment
+   * \returns true if the line segment intersects at least one building
+   */
+  bool IsIntersectLinear (const Vector &l1, const Vector &l2) const;
+};
+
+BuildingListIndexTestCase::BuildingListIndexTestCase ()
+  : TestCase ("Test case for the spatial index of the BuildingList")
+{}
+
+BuildingListIndexTestCase::~BuildingListIndexTestCase ()
+{}
+
+bool
+BuildingListIndexTestCase::IsIntersectLinear (const Vector &l1, const Vector &l2) const
+{
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsIntersect (l1, l2))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+BuildingListIndexTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  // Buildings of various sizes on 1 km x 1 km, some of them large
+  std::vector<Ptr<Building> > buildings;
+  for (uint32_t i = 0; i < 300; ++i)
+    {
+      double x = random->GetValue (0.0, 1000.0);
+      double y = random->GetValue (0.0, 1000.0);
+      double size = (i % 50 == 0) ? 200.0 : random->GetValue (5.0, 40.0);
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (x, x + size, y, y + size * 0.5, 0.0, random->GetValue (5.0, 60.0)));
+      buildings.push_back (building);
+    }
+
+  uint32_t blocked = 0;
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      Vector l1 (random->GetValue (-100.0, 1300.0), random->GetValue (-100.0, 1300.0), random->GetValue (0.0, 80.0));
+      Vector l2 (random->GetValue (-100.0, 1300.0), random->GetValue (-100.0, 1300.0), random->GetValue (0.0, 80.0));
+      switch (i % 4)
+        {
+        case 1: // short segments
+          l2 = l1 + Vector (random->GetValue (-20.0, 20.0), random->GetValue (-20.0, 20.0), 0.0);
+          break;
+        case 2: // along y
+          l2.x = l1.x;
+          break;
+        case 3: // along x
+          l2.y = l1.y;
+          break;
+        default:
+          break;
+        }
+      bool expected = IsIntersectLinear (l1, l2);
+      blocked += expected;
+      NS_TEST_ASSERT_MSG_EQ (BuildingList::IsIntersect (l1, l2), expected,
+                             "Wrong intersection between " << l1 << " and " << l2);
+    }
+  NS_TEST_ASSERT_MSG_GT (blocked, 0, "No segment intersects a building");
+  NS_TEST_ASSERT_MSG_LT (blocked, 5000, "Every segment intersects a building");
+
+  // Along the walls of a building and through a corner
+  Box bounds = buildings[7]->GetBoundaries ();
+  Vector corner (bounds.xMin, bounds.yMin, bounds.zMax * 0.5);
+  Vector offsets[] = {Vector (-50.0, 0.0, 0.0), Vector (0.0, -50.0, 0.0), Vector (-50.0, -50.0, 0.0)};
+  for (const Vector &offset : offsets)
+    {
+      Vector l1 = corner + offset;
+      NS_TEST_ASSERT_MSG_EQ (BuildingList::IsIntersect (l1, corner), IsIntersectLinear (l1, corner),
+                             "Wrong intersection between " << l1 << " and " << corner);
+    }
+
+  // Every building containing a position is near it
+  for (uint32_t i = 0; i < 5000; ++i)
+    {
+      Vector position (random->GetValue (-100.0, 1300.0), random->GetValue (-100.0, 1300.0), random->GetValue (0.0, 80.0));
+      const std::vector<uint32_t> &near = BuildingList::GetBuildingsNear (position);
+      for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+        {
+          if ((*bit)->IsInside (position))
+            {
+              NS_TEST_ASSERT_MSG_EQ (std::count (near.begin (), near.end (), (*bit)->GetId ()), 1,
+                                     "Building " << (*bit)->GetId () << " containing " << position << " not found");
+            }
+        }
+    }
+
+  // The index follows the changes of the boundaries
+  Vector l1 (2000.0, 2000.0, 1.5);
+  Vector l2 (2100.0, 2000.0, 1.5);
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::IsIntersect (l1, l2), false, "Unexpected intersection");
+  buildings[0]->SetBoundaries (Box (2040.0, 2060.0, 1990.0, 2010.0, 0.0, 10.0));
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::IsIntersect (l1, l2), true, "Moved building not found");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup building-test
  * \ingroup tests
@@ -157,6 +296,7 @@ BuildingsChannelConditionModelsTestSuite::BuildingsChannelConditionModelsTestSui
   : TestSuite ("buildings-channel-condition-model", UNIT)
 {
   AddTestCase (new BuildingsChannelConditionModelTestCase, TestCase::QUICK);
+  AddTestCase (new BuildingListIndexTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
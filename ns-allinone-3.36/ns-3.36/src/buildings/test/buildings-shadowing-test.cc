@@ -30,6 +30,7 @@
 #include <ns3/mobility-model.h>
 #include <ns3/mobility-building-info.h>
 #include <ns3/constant-position-mobility-model.h>
+#include <ns3/uinteger.h>
 
 #include "buildings-shadowing-test.h"
 
@@ -61,6 +62,9 @@ BuildingsShadowingTestSuite::BuildingsShadowingTestSuite ()
   // Test #3 Indoor -> Outdoor
   AddTestCase (new BuildingsShadowingTestCase (9, 10, 85.0012, 8.6, "Indoor -> Outdoor Shadowing"), TestCase::QUICK);
 
+  // Test #4 Bounded cache and correlated shadowing
+  AddTestCase (new BuildingsShadowingCacheTestCase, TestCase::QUICK);
+
 }
 
 /// Static variable for test initialization
@@ -225,3 +229,116 @@ BuildingsShadowingTestCase::CreateMobilityModel (uint16_t index)
   buildingInfo->MakeConsistent (mm);
   return mm;
 }
+
+
+
+BuildingsShadowingCacheTestCase::BuildingsShadowingCacheTestCase ()
+  : TestCase ("SHADOWING cache and correlation")
+{
+}
+
+BuildingsShadowingCacheTestCase::~BuildingsShadowingCacheTestCase ()
+{
+}
+
+Ptr<MobilityModel>
+BuildingsShadowingCacheTestCase::CreateOutdoorMobilityModel (Vector position)
+{
+  Ptr<MobilityModel> mm = CreateObject<ConstantPositionMobilityModel> ();
+  mm->SetPosition (position);
+  Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+  mm->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+  buildingInfo->MakeConsistent (mm);
+  return mm;
+}
+
+double
+BuildingsShadowingCacheTestCase::GetShadowing (Ptr<BuildingsPropagationLossModel> model, Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  return -model->DoCalcRxPower (0.0, a, b) - model->GetLoss (a, b);
+}
+
+void
+BuildingsShadowingCacheTestCase::DoRun (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // A bounded cache keeps the near pairs and evicts the far ones first
+  Ptr<HybridBuildingsPropagationLossModel> bounded = CreateObject<HybridBuildingsPropagationLossModel> ();
+  bounded->SetAttribute ("MaxShadowingEntries", UintegerValue (100));
+  bounded->SetAttribute ("ShadowingEvictionDistance", DoubleValue (500));
+  Ptr<MobilityModel> tx = CreateOutdoorMobilityModel (Vector (0.0, 0.0, 30));
+  std::vector<Ptr<MobilityModel> > nearRx;
+  std::vector<double> nearShadowing;
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      nearRx.push_back (CreateOutdoorMobilityModel (Vector (10.0 + i, 0.0, 1.5)));
+      nearShadowing.push_back (GetShadowing (bounded, tx, nearRx.back ()));
+    }
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      Ptr<MobilityModel> farRx = CreateOutdoorMobilityModel (Vector (1000.0 + i, 0.0, 1.5));
+      GetShadowing (bounded, tx, farRx);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (bounded->GetShadowingCacheSize (), 100, "Shadowing cache not bounded");
+    }
+  for (uint32_t i = 0; i < nearRx.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (GetShadowing (bounded, tx, nearRx[i]), nearShadowing[i], 1e-9,
+                                 "Near pair evicted before the far ones");
+    }
+
+  // The correlated shadowing is constant for static nodes, and follows the displacement
+  const double sigma = 7.0;
+  const double correlationDistance = 50;
+  Ptr<HybridBuildingsPropagationLossModel> correlated = CreateObject<HybridBuildingsPropagationLossModel> ();
+  correlated->SetAttribute ("ShadowingCorrelationDistance", DoubleValue (correlationDistance));
+  correlated->SetAttribute ("ShadowSigmaOutdoor", DoubleValue (sigma));
+  Ptr<MobilityModel> rx = CreateOutdoorMobilityModel (Vector (200.0, 0.0, 1.5));
+  double first = GetShadowing (correlated, tx, rx);
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetShadowing (correlated, tx, rx), first, 1e-9,
+                             "Shadowing is not constant for static nodes");
+
+  // Steps of 5 m: lag-1 autocorrelation exp(-5/50)
+  int samples = 1000;
+  double previous = first;
+  double sum = 0.0;
+  double sumSquared = 0.0;
+  double sumProducts = 0.0;
+  for (int i = 0; i < samples; i++)
+    {
+      rx->SetPosition (rx->GetPosition () + Vector (5.0 * ((i % 2) ? -1 : 1), 0.0, 0.0));
+      double shadowing = GetShadowing (correlated, tx, rx);
+      sum += shadowing;
+      sumSquared += shadowing * shadowing;
+      sumProducts += shadowing * previous;
+      previous = shadowing;
+    }
+  double mean = sum / samples;
+  double variance = sumSquared / samples - mean * mean;
+  double autocorrelation = (sumProducts / samples - mean * mean) / variance;
+  NS_LOG_INFO ("Correlated shadowing mean " << mean << ", std " << std::sqrt (variance) << ", lag-1 autocorrelation " << autocorrelation);
+  NS_TEST_ASSERT_MSG_EQ_TOL (autocorrelation, std::exp (-5.0 / correlationDistance), 0.05, "Wrong shadowing autocorrelation");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::sqrt (variance), sigma, 1.5, "Wrong shadowing standard deviation");
+
+  // Steps much longer than the correlation distance give independent values
+  sum = 0.0;
+  sumSquared = 0.0;
+  for (int i = 0; i < samples; i++)
+    {
+      rx->SetPosition (rx->GetPosition () + Vector (0.0, 5000.0 * ((i % 2) ? -1 : 1), 0.0));
+      double shadowing = GetShadowing (correlated, tx, rx);
+      sum += shadowing;
+      sumSquared += shadowing * shadowing;
+    }
+  double sampleMean = sum / samples;
+  double sampleVariance = (sumSquared - (sum * sum / samples)) / (samples - 1);
+  double chi2 = (samples - 1) * sampleVariance / (sigma * sigma);
+  const double zchi2_005 = 887.621135217515;  //  0.5% quantile of the chi2 distribution
+  const double zchi2_995 = 1117.89045267865;  // 99.5% quantile of the chi2 distribution
+  const double zn995 = 2.575829303549; // 99.5 quantile of the normal distribution
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::fabs (sampleMean), 0.0, zn995 * sigma / std::sqrt (samples), "Wrong shadowing distribution !");
+  NS_TEST_ASSERT_MSG_GT (chi2, zchi2_005, "sample variance lesser than expected");
+  NS_TEST_ASSERT_MSG_LT (chi2, zchi2_995, "sample variance greater than expected");
+
+  Simulator::Destroy ();
+}
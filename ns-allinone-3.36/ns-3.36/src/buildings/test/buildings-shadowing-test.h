@@ -22,6 +22,7 @@
 #define BUILDINGS_SHADOWING_TEST_H
 
 #include "ns3/test.h"
+#include "ns3/vector.h"
 
 
 
@@ -79,4 +80,38 @@ private:
 
 };
 
+
+/**
+ * \ingroup building-test
+ * \ingroup tests
+ *
+ * Shadowing cache test
+ *
+ * Check that the shadowing cache stays bounded, evicts the far pairs first,
+ * and that the correlated shadowing follows the displacement of the nodes.
+ */
+class BuildingsShadowingCacheTestCase : public TestCase
+{
+public:
+  BuildingsShadowingCacheTestCase ();
+  virtual ~BuildingsShadowingCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Create an outdoor node
+   * \param position Position of the node
+   * \return The MobilityModel of the node
+   */
+  Ptr<MobilityModel> CreateOutdoorMobilityModel (Vector position);
+  /**
+   * Return the shadowing of a pair of nodes
+   * \param model The propagation loss model
+   * \param a The MobilityModel of the transmitter
+   * \param b The MobilityModel of the receiver
+   * \return The shadowing, in dB
+   */
+  double GetShadowing (Ptr<BuildingsPropagationLossModel> model, Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+};
+
 #endif /*BUILDINGS_SHADOWING_TEST_H*/
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dary-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::DaryHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DaryHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (DaryHeapScheduler);
+
+namespace {
+
+/** Number of children of a node. */
+const std::size_t ARITY = 4;
+
+/**
+ * \param a The first key.
+ * \param b The second key.
+ * \returns \c true if \c a < \c b
+ */
+inline bool
+KeyLess (const Scheduler::EventKey &a, const Scheduler::EventKey &b)
+{
+  // Bitwise operators, so that the comparison compiles without branches
+  return (a.m_ts < b.m_ts) | ((a.m_ts == b.m_ts) & (a.m_uid < b.m_uid));
+}
+
+} // unnamed namespace
+
+TypeId
+DaryHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DaryHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<DaryHeapScheduler> ()
+  ;
+  return tid;
+}
+
+DaryHeapScheduler::DaryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DaryHeapScheduler::~DaryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+DaryHeapScheduler::SiftUp (std::size_t index, const Scheduler::EventKey &key, EventImpl *impl)
+{
+  while (index > 0)
+    {
+      std::size_t parent = (index - 1) / ARITY;
+      if (!KeyLess (key, m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[parent];
+      m_impls[index] = m_impls[parent];
+      index = parent;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+std::size_t
+DaryHeapScheduler::SmallestChild (std::size_t first) const
+{
+  std::size_t size = m_keys.size ();
+  if (first + ARITY <= size)
+    {
+      // Tournament between the four children, the two halves are independent
+      std::size_t a = first + KeyLess (m_keys[first + 1], m_keys[first]);
+      std::size_t b = first + 2 + KeyLess (m_keys[first + 3], m_keys[first + 2]);
+      return KeyLess (m_keys[b], m_keys[a]) ? b : a;
+    }
+  std::size_t smallest = first;
+  for (std::size_t child = first + 1; child < size; child++)
+    {
+      if (KeyLess (m_keys[child], m_keys[smallest]))
+        {
+          smallest = child;
+        }
+    }
+  return smallest;
+}
+
+void
+DaryHeapScheduler::SiftDown (std::size_t index, const Scheduler::EventKey &key, EventImpl *impl)
+{
+  std::size_t size = m_keys.size ();
+  while (index * ARITY + 1 < size)
+    {
+      std::size_t smallest = SmallestChild (index * ARITY + 1);
+      if (!KeyLess (m_keys[smallest], key))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[smallest];
+      m_impls[index] = m_impls[smallest];
+      index = smallest;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+DaryHeapScheduler::RemoveAt (std::size_t index)
+{
+  Scheduler::EventKey key = m_keys.back ();
+  EventImpl *impl = m_impls.back ();
+  m_keys.pop_back ();
+  m_impls.pop_back ();
+  if (index == m_keys.size ())
+    {
+      return;
+    }
+  // The last event may belong above or below the removed one
+  if (index > 0 && KeyLess (key, m_keys[(index - 1) / ARITY]))
+    {
+      SiftUp (index, key, impl);
+    }
+  else
+    {
+      SiftDown (index, key, impl);
+    }
+}
+
+void
+DaryHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  m_keys.push_back (ev.key);
+  m_impls.push_back (ev.impl);
+  SiftUp (m_keys.size () - 1, ev.key, ev.impl);
+}
+
+bool
+DaryHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_keys.empty ();
+}
+
+Scheduler::Event
+DaryHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next = { m_impls[0], m_keys[0] };
+  return next;
+}
+
+Scheduler::Event
+DaryHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next = { m_impls[0], m_keys[0] };
+  RemoveAt (0);
+  return next;
+}
+
+void
+DaryHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  uint32_t uid = ev.key.m_uid;
+  for (std::size_t i = 0; i < m_keys.size (); i++)
+    {
+      if (uid == m_keys[i].m_uid)
+        {
+          NS_ASSERT (m_impls[i] == ev.impl);
+          RemoveAt (i);
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
@@ -20,6 +20,7 @@
 #ifndef EVENT_IMPL_H
 #define EVENT_IMPL_H
 
+#include <cstddef>
 #include <stdint.h>
 #include "simple-ref-count.h"
 
@@ -66,6 +67,23 @@ public:
    */
   bool IsCancelled (void);
 
+#ifdef ENABLE_EVENT_POOL
+  /**
+   * Allocate the memory of an event from the EventPool.
+   *
+   * \param size the size of the event
+   * \return the memory of the event
+   */
+  static void *operator new (std::size_t size);
+  /**
+   * Give the memory of an event back to the EventPool.
+   *
+   * \param p the memory of the event
+   * \param size the size of the event
+   */
+  static void operator delete (void *p, std::size_t size);
+#endif /* ENABLE_EVENT_POOL */
+
 protected:
   /**
    * Implementation for Invoke().
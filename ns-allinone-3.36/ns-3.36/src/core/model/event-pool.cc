@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-pool.h"
+#include <atomic>
+#include <new>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventPool implementation.
+ */
+
+namespace ns3 {
+
+namespace {
+
+/** Granularity of the size classes (bytes). */
+const std::size_t GRANULE = 16;
+/** Number of size classes, the largest pooled block is GRANULE * CLASSES bytes. */
+const std::size_t CLASSES = 16;
+
+/** A free block, linked to the next free block of its size class. */
+struct FreeBlock
+{
+  FreeBlock *next; //!< Next free block
+};
+
+/**
+ * Free lists of one thread. The state is trivially destructible, so that
+ * it stays usable by the events freed during the destruction of the
+ * static objects, after the thread has released its blocks.
+ */
+struct PoolState
+{
+  FreeBlock *free[CLASSES]; //!< Free list of each size class
+  EventPoolStats stats;     //!< Counters of the thread
+  bool registered;          //!< Whether the reaper of the thread is constructed
+  bool exited;              //!< Whether the thread released its blocks for good
+};
+
+/** Whether the free lists are used. */
+#ifdef ENABLE_EVENT_POOL
+std::atomic<bool> g_enabled (true);
+#else
+std::atomic<bool> g_enabled (false);
+#endif
+
+/** Largest number of bytes cached by each thread. */
+std::atomic<std::size_t> g_maxCachedBytes (4 << 20);
+
+/** Free lists of the calling thread. */
+thread_local PoolState g_state;
+
+/**
+ * Release the blocks held in the free lists of a thread.
+ * \param state the state to release
+ */
+void
+Release (PoolState &state)
+{
+  for (std::size_t c = 0; c < CLASSES; c++)
+    {
+      while (state.free[c] != 0)
+        {
+          FreeBlock *block = state.free[c];
+          state.free[c] = block->next;
+          ::operator delete (block);
+        }
+    }
+  state.stats.cachedBlocks = 0;
+  state.stats.cachedBytes = 0;
+}
+
+/** Releases the blocks of a thread when it exits. */
+struct PoolReaper
+{
+  ~PoolReaper ()
+  {
+    Release (g_state);
+    g_state.exited = true;
+  }
+};
+
+/** Reaper of the calling thread. */
+thread_local PoolReaper g_reaper;
+
+/**
+ * \return the free lists of the calling thread, or 0 if it already exited
+ */
+PoolState *
+GetState (void)
+{
+  PoolState *state = &g_state;
+  if (!state->registered)
+    {
+      // Odr-use the reaper so that it is constructed and destroyed with the thread
+      static_cast<void> (&g_reaper);
+      state->registered = true;
+    }
+  return state->exited ? 0 : state;
+}
+
+} // unnamed namespace
+
+void *
+EventPool::Allocate (std::size_t size)
+{
+  std::size_t c = (size + GRANULE - 1) / GRANULE - 1;
+  PoolState *state = GetState ();
+  if (state == 0)
+    {
+      return ::operator new (c < CLASSES ? (c + 1) * GRANULE : size);
+    }
+  state->stats.allocations++;
+  if (c < CLASSES && state->free[c] != 0 && g_enabled.load (std::memory_order_relaxed))
+    {
+      FreeBlock *block = state->free[c];
+      state->free[c] = block->next;
+      state->stats.reused++;
+      state->stats.cachedBlocks--;
+      state->stats.cachedBytes -= (c + 1) * GRANULE;
+      return block;
+    }
+  state->stats.systemAllocations++;
+  // Round up, so that the block can be reused by any event of its class
+  return ::operator new (c < CLASSES ? (c + 1) * GRANULE : size);
+}
+
+void
+EventPool::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  std::size_t c = (size + GRANULE - 1) / GRANULE - 1;
+  PoolState *state = GetState ();
+  if (state == 0)
+    {
+      ::operator delete (p);
+      return;
+    }
+  state->stats.deallocations++;
+  if (c >= CLASSES || !g_enabled.load (std::memory_order_relaxed)
+      || state->stats.cachedBytes + (c + 1) * GRANULE > g_maxCachedBytes.load (std::memory_order_relaxed))
+    {
+      ::operator delete (p);
+      return;
+    }
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = state->free[c];
+  state->free[c] = block;
+  state->stats.cachedBlocks++;
+  state->stats.cachedBytes += (c + 1) * GRANULE;
+}
+
+void
+EventPool::SetEnabled (bool enabled)
+{
+  g_enabled.store (enabled);
+}
+
+bool
+EventPool::IsEnabled (void)
+{
+  return g_enabled.load ();
+}
+
+void
+EventPool::SetMaxCachedBytes (std::size_t bytes)
+{
+  g_maxCachedBytes.store (bytes);
+}
+
+std::size_t
+EventPool::GetMaxCachedBytes (void)
+{
+  return g_maxCachedBytes.load ();
+}
+
+EventPoolStats
+EventPool::GetStats (void)
+{
+  PoolState *state = GetState ();
+  return state != 0 ? state->stats : EventPoolStats ();
+}
+
+void
+EventPool::ResetStats (void)
+{
+  PoolState *state = GetState ();
+  if (state != 0)
+    {
+      state->stats.allocations = 0;
+      state->stats.reused = 0;
+      state->stats.systemAllocations = 0;
+      state->stats.deallocations = 0;
+    }
+}
+
+void
+EventPool::Trim (void)
+{
+  PoolState *state = GetState ();
+  if (state != 0)
+    {
+      Release (*state);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef EVENT_POOL_H
+#define EVENT_POOL_H
+
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventPool declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Allocation counters of the EventPool of one thread.
+ */
+struct EventPoolStats
+{
+  uint64_t allocations;       //!< Blocks handed out
+  uint64_t reused;            //!< Blocks handed out from a free list
+  uint64_t systemAllocations; //!< Blocks obtained from operator new
+  uint64_t deallocations;     //!< Blocks given back
+  uint64_t cachedBlocks;      //!< Blocks currently held in the free lists
+  uint64_t cachedBytes;       //!< Bytes currently held in the free lists
+};
+
+/**
+ * \ingroup events
+ * \brief Size-class free lists for the memory of the events.
+ *
+ * Every Simulator::Schedule allocates an EventImpl subclass, which is
+ * freed once the event has run or been removed. When ns-3 is configured
+ * with NS3_EVENT_POOL (--enable-event-pool), EventImpl::operator new and
+ * EventImpl::operator delete route these allocations through this pool: a
+ * freed event is kept in the free list of its size class (a multiple of 16
+ * bytes, up to 256 bytes) and handed out again to the next event of the
+ * same class, so that a simulation in steady state no longer calls the
+ * system allocator for its events. Larger events bypass the pool. Without
+ * NS3_EVENT_POOL, the events use the system allocator and this class is
+ * only used by explicit callers.
+ *
+ * The free lists and the counters belong to the calling thread, so that
+ * the distributed and realtime simulators need no locking.
+ * An event freed by another thread than the one which allocated it simply
+ * joins the free lists of the freeing thread. The blocks cached by a
+ * thread are released when the thread exits, or by Trim(). A thread caches
+ * at most SetMaxCachedBytes() bytes, blocks freed beyond that go back to the
+ * system allocator.
+ *
+ * The free lists are enabled by default only in builds with NS3_EVENT_POOL.
+ * When disabled, Allocate and Deallocate forward to the system allocator;
+ * SetEnabled() turns the free lists on and off.
+ */
+class EventPool
+{
+public:
+  /**
+   * \param size the size of the block
+   * \return a block of at least size bytes
+   */
+  static void *Allocate (std::size_t size);
+  /**
+   * \param p a block returned by Allocate
+   * \param size the size passed to Allocate
+   */
+  static void Deallocate (void *p, std::size_t size);
+
+  /**
+   * Enable or disable the free lists. When disabled, blocks are obtained
+   * from and given back to the system allocator. Blocks may be allocated
+   * and freed on either side of a change.
+   *
+   * \param enabled whether the free lists are used
+   */
+  static void SetEnabled (bool enabled);
+  /**
+   * \return whether the free lists are used
+   */
+  static bool IsEnabled (void);
+  /**
+   * Set the largest number of bytes kept in the free lists of each thread,
+   * 4 MiB by default. Blocks already cached beyond a lowered limit are kept
+   * until they are handed out again or released by Trim().
+   *
+   * \param bytes the largest number of cached bytes per thread
+   */
+  static void SetMaxCachedBytes (std::size_t bytes);
+  /**
+   * \return the largest number of bytes kept in the free lists of each thread
+   */
+  static std::size_t GetMaxCachedBytes (void);
+
+  /**
+   * \return the counters of the calling thread
+   */
+  static EventPoolStats GetStats (void);
+  /**
+   * Reset the allocation counters of the calling thread. The counters of
+   * the cached blocks are kept.
+   */
+  static void ResetStats (void);
+  /**
+   * Release the blocks cached by the calling thread.
+   */
+  static void Trim (void);
+};
+
+} // namespace ns3
+
+#endif /* EVENT_POOL_H */
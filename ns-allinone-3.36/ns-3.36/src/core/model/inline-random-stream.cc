@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "inline-random-stream.h"
+#include "rng-seed-manager.h"
+#include "assert.h"
+
+/**
+ * \file
+ * \ingroup randomvariable
+ * ns3::InlineRandomStream implementation.
+ */
+
+namespace ns3 {
+
+InlineRandomStream::InlineRandomStream ()
+  : m_rng (MakeRng (-1)),
+    m_stream (-1)
+{
+}
+
+InlineRandomStream::InlineRandomStream (int64_t stream)
+  : m_rng (MakeRng (stream)),
+    m_stream (stream)
+{
+}
+
+void
+InlineRandomStream::SetStream (int64_t stream)
+{
+  m_rng = MakeRng (stream);
+  m_stream = stream;
+}
+
+int64_t
+InlineRandomStream::GetStream (void) const
+{
+  return m_stream;
+}
+
+RngStream
+InlineRandomStream::MakeRng (int64_t stream)
+{
+  // Same numbering as RandomVariableStream::SetStream
+  NS_ASSERT (stream >= -1);
+  uint64_t target;
+  if (stream == -1)
+    {
+      // The first 2^63 streams are reserved for automatic stream
+      // number assignment.
+      target = RngSeedManager::GetNextStreamIndex ();
+      NS_ASSERT (target <= ((1ULL) << 63));
+    }
+  else
+    {
+      // The last 2^63 streams are reserved for deterministic stream
+      // number assignment.
+      target = ((1ULL) << 63) + stream;
+    }
+  return RngStream (RngSeedManager::GetSeed (), target, RngSeedManager::GetRun ());
+}
+
+} // namespace ns3
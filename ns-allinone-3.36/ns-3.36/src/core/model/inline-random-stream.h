@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef INLINE_RANDOM_STREAM_H
+#define INLINE_RANDOM_STREAM_H
+
+#include <stdint.h>
+#include "rng-stream.h"
+
+/**
+ * \file
+ * \ingroup randomvariable
+ * ns3::InlineRandomStream declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup randomvariable
+ * \brief A random number stream without the Object overhead.
+ *
+ * RandomVariableStream is an Object: creating one goes through the object
+ * factory and the attribute system, and every draw is a virtual call. This
+ * class holds an RngStream by value and draws from it directly, which
+ * suits models that draw once or twice per packet and want to own their
+ * generators as plain members.
+ *
+ * Streams are numbered like those of RandomVariableStream: the default
+ * constructor takes the next automatically assigned stream, and
+ * SetStream() selects a fixed stream among the ones reserved for
+ * AssignStreams(). With the same stream number, GetUniform (min, max) and
+ * GetInteger (min, max) return the same sequence as a
+ * UniformRandomVariable.
+ */
+class InlineRandomStream
+{
+public:
+  /** Create a stream with the next automatically assigned stream number. */
+  InlineRandomStream ();
+  /**
+   * Create a stream with a fixed stream number.
+   *
+   * \param [in] stream The stream number, or -1 for automatic assignment.
+   */
+  explicit InlineRandomStream (int64_t stream);
+
+  /**
+   * Select the stream to draw from. The sequence restarts.
+   *
+   * \param [in] stream The stream number, or -1 for automatic assignment.
+   */
+  void SetStream (int64_t stream);
+  /**
+   * \returns The stream number, or -1 if it was assigned automatically.
+   */
+  int64_t GetStream (void) const;
+
+  /**
+   * \returns A uniform value in [0, 1).
+   */
+  double GetUniform (void)
+  {
+    return m_rng.RandU01 ();
+  }
+  /**
+   * \param [in] min The lower bound.
+   * \param [in] max The upper bound.
+   * \returns A uniform value in [min, max).
+   */
+  double GetUniform (double min, double max)
+  {
+    return min + m_rng.RandU01 () * (max - min);
+  }
+  /**
+   * \param [in] min The lower bound.
+   * \param [in] max The upper bound.
+   * \returns A uniform integer in [min, max].
+   */
+  uint32_t GetInteger (uint32_t min, uint32_t max)
+  {
+    return static_cast<uint32_t> (GetUniform (min, static_cast<double> (max) + 1.0));
+  }
+  /**
+   * \param [in] probability The probability of success.
+   * \returns Whether a Bernoulli trial succeeded.
+   */
+  bool GetBernoulli (double probability)
+  {
+    return m_rng.RandU01 () < probability;
+  }
+
+private:
+  /**
+   * \param [in] stream The stream number, or -1 for automatic assignment.
+   * \returns The generator of the stream.
+   */
+  static RngStream MakeRng (int64_t stream);
+
+  RngStream m_rng;  //!< The generator
+  int64_t m_stream; //!< The stream number
+};
+
+} // namespace ns3
+
+#endif /* INLINE_RANDOM_STREAM_H */
@@ -102,6 +102,14 @@ class EventImpl;
  *      <td class="markdownTableBodyLeft"> 16 bytes </td>
  * </tr>
  * <tr class="markdownTableBody">
+ *      <td class="markdownTableBodyLeft"> DaryHeapScheduler </td>
+ *      <td class="markdownTableBodyLeft"> 4-ary heap on two `std::vector` </td>
+ *      <td class="markdownTableBodyLeft"> Logarithmic  </td>
+ *      <td class="markdownTableBodyLeft"> Logarithmic </td>
+ *      <td class="markdownTableBodyLeft"> 48 bytes </td>
+ *      <td class="markdownTableBodyLeft"> 0 </td>
+ * </tr>
+ * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> HeapScheduler </td>
  *      <td class="markdownTableBodyLeft"> Heap on `std::vector` </td>
  *      <td class="markdownTableBodyLeft"> Logarithmic  </td>
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/event-pool.h"
+#include "ns3/simulator.h"
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup events
+ * \ingroup event-pool-tests
+ * EventPool test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup event-pool-tests EventPool test suite
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup event-pool-tests
+ * Check that a chain of events reuses the memory of the events that ran,
+ * in builds where the events are allocated from the pool, and the free
+ * lists of the threads and their size limit.
+ */
+class EventPoolTestCase : public TestCase
+{
+  uint32_t m_remaining; //!< Events still to schedule
+
+  /** Schedule the next event of the chain. */
+  void Next (void);
+  /**
+   * Run a chain of events.
+   * \param length the number of events of the chain
+   * \return the counters of the run
+   */
+  EventPoolStats RunChain (uint32_t length);
+
+public:
+  /** Constructor. */
+  EventPoolTestCase ();
+  virtual void DoRun (void);
+};
+
+EventPoolTestCase::EventPoolTestCase ()
+  : TestCase ("EventPool"), m_remaining (0)
+{}
+
+void
+EventPoolTestCase::Next (void)
+{
+  if (--m_remaining > 0)
+    {
+      Simulator::Schedule (Seconds (1), &EventPoolTestCase::Next, this);
+    }
+}
+
+EventPoolStats
+EventPoolTestCase::RunChain (uint32_t length)
+{
+  EventPool::Trim ();
+  EventPool::ResetStats ();
+  m_remaining = length;
+  Simulator::Schedule (Seconds (1), &EventPoolTestCase::Next, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return EventPool::GetStats ();
+}
+
+void
+EventPoolTestCase::DoRun (void)
+{
+  bool enabled = EventPool::IsEnabled ();
+  EventPool::SetEnabled (true);
+#ifdef ENABLE_EVENT_POOL
+  EventPoolStats stats = RunChain (100);
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, 100, "wrong number of events");
+  NS_TEST_EXPECT_MSG_EQ (stats.deallocations, 100, "events not freed");
+  // Each event is allocated while the previous one runs
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (stats.systemAllocations, 2, "events not reused");
+  NS_TEST_EXPECT_MSG_EQ (stats.reused + stats.systemAllocations, 100, "inconsistent counters");
+  NS_TEST_EXPECT_MSG_EQ (stats.cachedBlocks, stats.systemAllocations, "blocks lost");
+
+  EventPool::SetEnabled (false);
+  stats = RunChain (100);
+  EventPool::SetEnabled (true);
+  NS_TEST_EXPECT_MSG_EQ (stats.reused, 0, "disabled pool reused events");
+  NS_TEST_EXPECT_MSG_EQ (stats.systemAllocations, 100, "disabled pool did not use the system allocator");
+  NS_TEST_EXPECT_MSG_EQ (stats.cachedBlocks, 0, "disabled pool cached blocks");
+#endif
+
+  // Another thread has its own free lists and counters
+  EventPoolStats threadStats;
+  std::thread thread ([&threadStats] ()
+    {
+      void *p = EventPool::Allocate (40);
+      EventPool::Deallocate (p, 40);
+      p = EventPool::Allocate (48);
+      EventPool::Deallocate (p, 48);
+      threadStats = EventPool::GetStats ();
+    });
+  thread.join ();
+  NS_TEST_EXPECT_MSG_EQ (threadStats.allocations, 2, "wrong number of blocks in the thread");
+  NS_TEST_EXPECT_MSG_EQ (threadStats.reused, 1, "block of the same size class not reused");
+#ifdef ENABLE_EVENT_POOL
+  NS_TEST_EXPECT_MSG_EQ (EventPool::GetStats ().allocations, 100, "thread changed the counters of the main thread");
+#endif
+  EventPool::Trim ();
+  NS_TEST_EXPECT_MSG_EQ (EventPool::GetStats ().cachedBytes, 0, "blocks not released");
+
+  // Blocks freed beyond the limit go back to the system allocator
+  std::size_t maxCachedBytes = EventPool::GetMaxCachedBytes ();
+  EventPool::SetMaxCachedBytes (64);
+  std::vector<void *> blocks;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      blocks.push_back (EventPool::Allocate (16));
+    }
+  for (void *p : blocks)
+    {
+      EventPool::Deallocate (p, 16);
+    }
+  NS_TEST_EXPECT_MSG_EQ (EventPool::GetStats ().cachedBytes, 64, "free lists exceed their limit");
+  EventPool::SetMaxCachedBytes (maxCachedBytes);
+  EventPool::Trim ();
+  EventPool::SetEnabled (enabled);
+}
+
+/**
+ * \ingroup event-pool-tests
+ * EventPool test suite.
+ */
+class EventPoolTestSuite : public TestSuite
+{
+public:
+  EventPoolTestSuite ()
+    : TestSuite ("event-pool")
+  {
+    AddTestCase (new EventPoolTestCase ());
+  }
+};
+
+/**
+ * \ingroup event-pool-tests
+ * EventPoolTestSuite instance variable.
+ */
+static EventPoolTestSuite g_eventPoolTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
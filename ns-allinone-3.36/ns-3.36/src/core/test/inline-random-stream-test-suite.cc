@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/inline-random-stream.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/integer.h"
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup inline-random-stream-tests
+ * InlineRandomStream test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup inline-random-stream-tests InlineRandomStream test suite
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup inline-random-stream-tests
+ * Check that an InlineRandomStream draws the same sequence as a
+ * UniformRandomVariable on the same stream.
+ */
+class InlineRandomStreamTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  InlineRandomStreamTestCase ();
+  virtual void DoRun (void);
+};
+
+InlineRandomStreamTestCase::InlineRandomStreamTestCase ()
+  : TestCase ("InlineRandomStream")
+{}
+
+void
+InlineRandomStreamTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetAttribute ("Stream", IntegerValue (7));
+  InlineRandomStream stream (7);
+  NS_TEST_EXPECT_MSG_EQ (stream.GetStream (), 7, "wrong stream");
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (stream.GetUniform (-2.0, 3.0), uniform->GetValue (-2.0, 3.0),
+                             "draw " << i << " differs from UniformRandomVariable");
+      NS_TEST_EXPECT_MSG_EQ (stream.GetInteger (1, 6), uniform->GetInteger (1, 6),
+                             "integer draw " << i << " differs from UniformRandomVariable");
+    }
+
+  // Selecting the stream again restarts the sequence
+  stream.SetStream (7);
+  uniform->SetStream (7);
+  NS_TEST_EXPECT_MSG_EQ (stream.GetUniform (), uniform->GetValue (0.0, 1.0), "sequence not restarted");
+
+  // Automatically assigned streams are distinct
+  InlineRandomStream first;
+  InlineRandomStream second;
+  NS_TEST_EXPECT_MSG_EQ (first.GetStream (), -1, "stream not automatic");
+  NS_TEST_EXPECT_MSG_NE (first.GetUniform (), second.GetUniform (), "automatic streams share a sequence");
+
+  uint32_t successes = 0;
+  for (uint32_t i = 0; i < 10000; ++i)
+    {
+      double value = stream.GetUniform (0.5, 1.5);
+      NS_TEST_ASSERT_MSG_EQ ((value >= 0.5 && value < 1.5), true, "value " << value << " out of range");
+      successes += stream.GetBernoulli (0.25) ? 1 : 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (successes / 10000.0, 0.25, 0.02, "wrong Bernoulli probability");
+  NS_TEST_EXPECT_MSG_EQ (stream.GetBernoulli (0.0), false, "success with probability 0");
+  NS_TEST_EXPECT_MSG_EQ (stream.GetBernoulli (1.0), true, "failure with probability 1");
+}
+
+/**
+ * \ingroup inline-random-stream-tests
+ * InlineRandomStream test suite.
+ */
+class InlineRandomStreamTestSuite : public TestSuite
+{
+public:
+  InlineRandomStreamTestSuite ()
+    : TestSuite ("inline-random-stream")
+  {
+    AddTestCase (new InlineRandomStreamTestCase ());
+  }
+};
+
+/**
+ * \ingroup inline-random-stream-tests
+ * InlineRandomStreamTestSuite instance variable.
+ */
+static InlineRandomStreamTestSuite g_inlineRandomStreamTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
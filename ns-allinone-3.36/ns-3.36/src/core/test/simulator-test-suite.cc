@@ -24,6 +24,7 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/dary-heap-scheduler.h"
 
 using namespace ns3;
 
@@ -531,6 +532,101 @@ SimulatorTemplateTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the order of a scheduler against the MapScheduler.
+ *
+ * Bursts of events with equal or nearly equal timestamps are inserted,
+ * removed out of order and taken from the front. Both schedulers must
+ * return the same events in the same order.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param schedulerFactory Factory of the scheduler under test.
+   */
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+
+private:
+  ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the event order of " + schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  std::vector<Scheduler::Event> pending;
+  uint32_t state = 12345;
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  for (uint32_t round = 0; round < 200; round++)
+    {
+      // A burst of receptions a few nanoseconds apart, some at the same time
+      for (uint32_t i = 0; i < 20; i++)
+        {
+          state = state * 1103515245 + 12345;
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_ts = now + 1000 + (state >> 16) % 8;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = i;
+          if ((state >> 8) % 4 == 0)
+            {
+              ev.key.m_ts = now + (state >> 8) % 1000000;
+            }
+          scheduler->Insert (ev);
+          reference->Insert (ev);
+          pending.push_back (ev);
+        }
+      // Cancel a few of the pending events
+      for (uint32_t i = 0; i < 3 && !pending.empty (); i++)
+        {
+          state = state * 1103515245 + 12345;
+          std::size_t k = (state >> 16) % pending.size ();
+          scheduler->Remove (pending[k]);
+          reference->Remove (pending[k]);
+          pending[k] = pending.back ();
+          pending.pop_back ();
+        }
+      for (uint32_t i = 0; i < 15 && !reference->IsEmpty (); i++)
+        {
+          Scheduler::Event expected = reference->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "scheduler lost events");
+          NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expected.key.m_uid, "wrong next event");
+          Scheduler::Event next = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, expected.key.m_uid, "wrong event order");
+          NS_TEST_ASSERT_MSG_EQ (next.key.m_ts, expected.key.m_ts, "wrong timestamp");
+          now = next.key.m_ts;
+          for (std::size_t k = 0; k < pending.size (); k++)
+            {
+              if (pending[k].key.m_uid == next.key.m_uid)
+                {
+                  pending[k] = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid, "wrong event order");
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "scheduler has extra events");
+}
+
+
 /**
  * \ingroup simulator-tests
  *  
@@ -554,6 +650,9 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (DaryHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
   }
 };
 
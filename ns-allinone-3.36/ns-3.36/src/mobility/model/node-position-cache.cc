@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "node-position-cache.h"
+#include "mobility-model.h"
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NodePositionCache");
+
+NS_OBJECT_ENSURE_REGISTERED (NodePositionCache);
+
+TypeId
+NodePositionCache::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NodePositionCache")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<NodePositionCache> ()
+    .AddAttribute ("Extrapolate",
+                   "If true, positions are extrapolated from the velocity sampled at "
+                   "the last course change instead of being sampled at every new time.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NodePositionCache::m_extrapolate),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+NodePositionCache::NodePositionCache ()
+  : m_extrapolate (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+NodePositionCache::~NodePositionCache ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+NodePositionCache::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_mobility.clear ();
+  m_index.clear ();
+  Object::DoDispose ();
+}
+
+Ptr<NodePositionCache>
+NodePositionCache::Get (void)
+{
+  return *DoGet ();
+}
+
+Ptr<NodePositionCache> *
+NodePositionCache::DoGet (void)
+{
+  static Ptr<NodePositionCache> ptr = 0;
+  if (ptr == 0)
+    {
+      ptr = CreateObject<NodePositionCache> ();
+      Simulator::ScheduleDestroy (&NodePositionCache::Delete);
+    }
+  return &ptr;
+}
+
+void
+NodePositionCache::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  (*DoGet ())->Dispose ();
+  (*DoGet ()) = 0;
+}
+
+void
+NodePositionCache::AddNodes (void)
+{
+  uint32_t n = NodeList::GetNNodes ();
+  NS_LOG_FUNCTION (this << m_mobility.size () << n);
+  m_mobility.resize (n);
+  m_x.resize (n, 0);
+  m_y.resize (n, 0);
+  m_z.resize (n, 0);
+  m_time.resize (n, -1);
+  m_sampleX.resize (n, 0);
+  m_sampleY.resize (n, 0);
+  m_sampleZ.resize (n, 0);
+  m_vx.resize (n, 0);
+  m_vy.resize (n, 0);
+  m_vz.resize (n, 0);
+  m_sampleTime.resize (n, -1);
+}
+
+uint32_t
+NodePositionCache::Lookup (uint32_t nodeId)
+{
+  if (nodeId >= m_mobility.size ())
+    {
+      AddNodes ();
+      NS_ASSERT_MSG (nodeId < m_mobility.size (), "Node " << nodeId << " does not exist");
+    }
+  if (m_mobility[nodeId] == 0)
+    {
+      // The mobility model may be aggregated after the node was added
+      Ptr<MobilityModel> mobility = NodeList::GetNode (nodeId)->GetObject<MobilityModel> ();
+      NS_ABORT_MSG_IF (mobility == 0, "Node " << nodeId << " has no mobility model");
+      m_mobility[nodeId] = mobility;
+      m_index[PeekPointer (mobility)] = nodeId;
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&NodePositionCache::CourseChanged, this));
+    }
+  return nodeId;
+}
+
+void
+NodePositionCache::Sample (uint32_t i)
+{
+  Vector position = m_mobility[i]->GetPosition ();
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  m_x[i] = position.x;
+  m_y[i] = position.y;
+  m_z[i] = position.z;
+  m_time[i] = now;
+  if (!m_extrapolate)
+    {
+      // Without extrapolation the velocity is never read from the cache
+      m_sampleTime[i] = -1;
+      return;
+    }
+  Vector velocity = m_mobility[i]->GetVelocity ();
+  m_sampleX[i] = position.x;
+  m_sampleY[i] = position.y;
+  m_sampleZ[i] = position.z;
+  m_vx[i] = velocity.x;
+  m_vy[i] = velocity.y;
+  m_vz[i] = velocity.z;
+  m_sampleTime[i] = now;
+}
+
+void
+NodePositionCache::Advance (uint32_t i)
+{
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  // A node sampled before Extrapolate was set has no velocity yet
+  if (m_time[i] == now && (!m_extrapolate || m_sampleTime[i] >= 0))
+    {
+      return;
+    }
+  if (!m_extrapolate || m_sampleTime[i] < 0)
+    {
+      Sample (i);
+      return;
+    }
+  // Always extrapolate from the sample, so that rounding errors do not add up
+  double dt = Time (now - m_sampleTime[i]).GetSeconds ();
+  m_x[i] = m_sampleX[i] + m_vx[i] * dt;
+  m_y[i] = m_sampleY[i] + m_vy[i] * dt;
+  m_z[i] = m_sampleZ[i] + m_vz[i] * dt;
+  m_time[i] = now;
+}
+
+void
+NodePositionCache::CourseChanged (Ptr<const MobilityModel> model)
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_index.find (PeekPointer (model));
+  if (it != m_index.end ())
+    {
+      Sample (it->second);
+    }
+}
+
+Vector
+NodePositionCache::GetPosition (uint32_t nodeId)
+{
+  uint32_t i = Lookup (nodeId);
+  Advance (i);
+  return Vector (m_x[i], m_y[i], m_z[i]);
+}
+
+Vector
+NodePositionCache::GetVelocity (uint32_t nodeId)
+{
+  uint32_t i = Lookup (nodeId);
+  if (!m_extrapolate)
+    {
+      return m_mobility[i]->GetVelocity ();
+    }
+  Advance (i);
+  return Vector (m_vx[i], m_vy[i], m_vz[i]);
+}
+
+void
+NodePositionCache::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_mobility.size () != NodeList::GetNNodes ())
+    {
+      AddNodes ();
+    }
+  for (uint32_t i = 0; i < m_mobility.size (); i++)
+    {
+      if (m_mobility[i] == 0 && NodeList::GetNode (i)->GetObject<MobilityModel> () == 0)
+        {
+          continue;
+        }
+      Advance (Lookup (i));
+    }
+}
+
+uint32_t
+NodePositionCache::GetN (void) const
+{
+  return m_x.size ();
+}
+
+const double *
+NodePositionCache::GetX (void) const
+{
+  return m_x.data ();
+}
+
+const double *
+NodePositionCache::GetY (void) const
+{
+  return m_y.data ();
+}
+
+const double *
+NodePositionCache::GetZ (void) const
+{
+  return m_z.data ();
+}
+
+} // namespace ns3
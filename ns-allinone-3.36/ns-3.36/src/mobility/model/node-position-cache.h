@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NODE_POSITION_CACHE_H
+#define NODE_POSITION_CACHE_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Positions and velocities of all the nodes of the NodeList
+ *
+ * The cache keeps, for every node, the position (and, when extrapolating,
+ * the velocity) sampled from the MobilityModel aggregated to the node and
+ * the time of the sample, in
+ * contiguous arrays indexed by node id. It lets code that reads the
+ * positions of many nodes (channels, flooding applications) skip the
+ * aggregation lookup and the virtual calls of the mobility model.
+ *
+ * By default, a node is sampled again on the first query at a new
+ * simulation time, so the positions are exactly those returned by
+ * MobilityModel::GetPosition. If the Extrapolate attribute is true, a node
+ * is only sampled again when its mobility model fires CourseChange, and the
+ * position in between is extrapolated from the sampled velocity. This is
+ * exact (up to rounding) for models that move at constant velocity between
+ * two course changes, such as ConstantVelocity, RandomDirection2d,
+ * RandomWalk2d and Waypoint, but not for ConstantAcceleration.
+ *
+ * The cache of the NodeList is returned by Get() and destroyed with the
+ * simulator. Nodes created after the first query are added on demand.
+ */
+class NodePositionCache : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  NodePositionCache ();
+  virtual ~NodePositionCache ();
+
+  /**
+   * \return the cache of all the nodes of the NodeList
+   */
+  static Ptr<NodePositionCache> Get (void);
+
+  /**
+   * \param nodeId the id of the node
+   * \return the position of the node at the current time
+   */
+  Vector GetPosition (uint32_t nodeId);
+  /**
+   * \param nodeId the id of the node
+   * \return the velocity of the node at the current time
+   */
+  Vector GetVelocity (uint32_t nodeId);
+
+  /**
+   * Bring the positions of all the nodes to the current time, so that
+   * they can be read from GetX(), GetY() and GetZ().
+   */
+  void Update (void);
+  /**
+   * \return the number of nodes in the arrays
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \return the x coordinates of all the nodes as of the last Update()
+   */
+  const double *GetX (void) const;
+  /**
+   * \return the y coordinates of all the nodes as of the last Update()
+   */
+  const double *GetY (void) const;
+  /**
+   * \return the z coordinates of all the nodes as of the last Update()
+   */
+  const double *GetZ (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * \return a pointer to the cache of the NodeList
+   */
+  static Ptr<NodePositionCache> *DoGet (void);
+  /**
+   * Delete the cache of the NodeList
+   */
+  static void Delete (void);
+
+  /**
+   * Add the nodes created since the last call.
+   */
+  void AddNodes (void);
+  /**
+   * \param nodeId the id of the node
+   * \return the index of the node, after checking its mobility model
+   */
+  uint32_t Lookup (uint32_t nodeId);
+  /**
+   * Sample the position of a node from its mobility model, and its
+   * velocity if positions are extrapolated.
+   * \param i the index of the node
+   */
+  void Sample (uint32_t i);
+  /**
+   * Bring the position of a node to the current time.
+   * \param i the index of the node
+   */
+  void Advance (uint32_t i);
+  /**
+   * \param model the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> model);
+
+  bool m_extrapolate;                                  //!< Whether positions are extrapolated between course changes
+  std::vector<Ptr<MobilityModel> > m_mobility;         //!< Mobility model of each node
+  std::unordered_map<const MobilityModel *, uint32_t> m_index; //!< Node index of each mobility model
+  std::vector<double> m_x;                             //!< x coordinate of each node at m_time (m)
+  std::vector<double> m_y;                             //!< y coordinate of each node at m_time (m)
+  std::vector<double> m_z;                             //!< z coordinate of each node at m_time (m)
+  std::vector<int64_t> m_time;                         //!< Time step of the coordinates of each node
+  std::vector<double> m_sampleX;                       //!< x coordinate of each node at m_sampleTime (m)
+  std::vector<double> m_sampleY;                       //!< y coordinate of each node at m_sampleTime (m)
+  std::vector<double> m_sampleZ;                       //!< z coordinate of each node at m_sampleTime (m)
+  std::vector<double> m_vx;                            //!< x velocity of each node (m/s)
+  std::vector<double> m_vy;                            //!< y velocity of each node (m/s)
+  std::vector<double> m_vz;                            //!< z velocity of each node (m/s)
+  std::vector<int64_t> m_sampleTime;                   //!< Time step at which each node was sampled
+};
+
+} // namespace ns3
+
+#endif /* NODE_POSITION_CACHE_H */
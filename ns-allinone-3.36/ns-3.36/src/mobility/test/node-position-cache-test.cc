@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-position-cache.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the node position cache against the mobility models
+ *
+ * Two nodes move at constant velocity, the second one changes its velocity
+ * halfway, and a third node has no mobility model. The cached positions
+ * must match the mobility models, exactly when sampling and to within
+ * rounding when extrapolating.
+ */
+class NodePositionCacheTestCase : public TestCase
+{
+public:
+  /**
+   * \param extrapolate whether the cache extrapolates the positions
+   */
+  NodePositionCacheTestCase (bool extrapolate);
+
+private:
+  virtual void DoRun (void);
+  /// Compare the cache with the mobility models
+  void Check (void);
+
+  bool m_extrapolate;                                     //!< whether the cache extrapolates the positions
+  std::vector<Ptr<ConstantVelocityMobilityModel> > m_mobility; //!< mobility models of the moving nodes
+  uint32_t m_checks;                                      //!< number of checks done
+};
+
+NodePositionCacheTestCase::NodePositionCacheTestCase (bool extrapolate)
+  : TestCase (extrapolate ? "Extrapolated node positions" : "Sampled node positions"),
+    m_extrapolate (extrapolate),
+    m_checks (0)
+{
+}
+
+void
+NodePositionCacheTestCase::Check (void)
+{
+  Ptr<NodePositionCache> cache = NodePositionCache::Get ();
+  double tolerance = m_extrapolate ? 1e-9 : 0;
+  for (uint32_t i = 0; i < m_mobility.size (); i++)
+    {
+      uint32_t id = m_mobility[i]->GetObject<Node> ()->GetId ();
+      Vector expected = m_mobility[i]->GetPosition ();
+      Vector position = cache->GetPosition (id);
+      NS_TEST_ASSERT_MSG_EQ_TOL (position.x, expected.x, tolerance, "wrong x of node " << id);
+      NS_TEST_ASSERT_MSG_EQ_TOL (position.y, expected.y, tolerance, "wrong y of node " << id);
+      NS_TEST_ASSERT_MSG_EQ_TOL (position.z, expected.z, tolerance, "wrong z of node " << id);
+      Vector velocity = cache->GetVelocity (id);
+      NS_TEST_ASSERT_MSG_EQ (velocity, m_mobility[i]->GetVelocity (), "wrong velocity of node " << id);
+    }
+
+  cache->Update ();
+  NS_TEST_ASSERT_MSG_EQ (cache->GetN (), 3, "wrong number of nodes");
+  for (uint32_t i = 0; i < m_mobility.size (); i++)
+    {
+      uint32_t id = m_mobility[i]->GetObject<Node> ()->GetId ();
+      NS_TEST_ASSERT_MSG_EQ_TOL (cache->GetX ()[id], m_mobility[i]->GetPosition ().x, tolerance, "wrong x array");
+      NS_TEST_ASSERT_MSG_EQ_TOL (cache->GetY ()[id], m_mobility[i]->GetPosition ().y, tolerance, "wrong y array");
+    }
+  m_checks++;
+}
+
+void
+NodePositionCacheTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+      mobility->SetPosition (Vector (10.0 * i, 0, 1.5));
+      mobility->SetVelocity (Vector (1.3, -0.7 * i, 0));
+      nodes.Get (i)->AggregateObject (mobility);
+      m_mobility.push_back (mobility);
+    }
+  NodePositionCache::Get ()->SetAttribute ("Extrapolate", BooleanValue (m_extrapolate));
+
+  Simulator::Schedule (Seconds (0), &NodePositionCacheTestCase::Check, this);
+  Simulator::Schedule (Seconds (1.25), &NodePositionCacheTestCase::Check, this);
+  Simulator::Schedule (Seconds (2), &ConstantVelocityMobilityModel::SetVelocity, m_mobility[1], Vector (-3, 2, 0.5));
+  Simulator::Schedule (Seconds (2), &NodePositionCacheTestCase::Check, this);
+  Simulator::Schedule (Seconds (3.7), &NodePositionCacheTestCase::Check, this);
+  Simulator::Schedule (Seconds (3.7), &ConstantVelocityMobilityModel::SetPosition, m_mobility[0], Vector (50, 50, 0));
+  Simulator::Schedule (Seconds (3.7), &NodePositionCacheTestCase::Check, this);
+  Simulator::Schedule (Seconds (10.1), &NodePositionCacheTestCase::Check, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_mobility.clear ();
+  NS_TEST_ASSERT_MSG_EQ (m_checks, 6, "not all the checks ran");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Node position cache TestSuite
+ */
+class NodePositionCacheTestSuite : public TestSuite
+{
+public:
+  NodePositionCacheTestSuite ();
+};
+
+NodePositionCacheTestSuite::NodePositionCacheTestSuite ()
+  : TestSuite ("node-position-cache", UNIT)
+{
+  AddTestCase (new NodePositionCacheTestCase (false), TestCase::QUICK);
+  AddTestCase (new NodePositionCacheTestCase (true), TestCase::QUICK);
+}
+
+static NodePositionCacheTestSuite g_nodePositionCacheTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/mpi-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/yans-wifi-remote-channel.h"
+
+#include <mpi.h>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpi
+ *
+ * 802.11p broadcasts over a YansWifiRemoteChannel spanning the ranks.
+ *
+ * Eight nodes on a line, 120 m apart, move at different speeds across
+ * it. The line is cut into one strip per rank, and each node is owned by
+ * the rank of the strip where it starts. Every node broadcasts a frame
+ * every 10 ms in turn, so the frames never overlap, and each frame is
+ * received by the nodes within about 500 m, on either side of a strip
+ * border.
+ *
+ * At the end, the first rank prints how many frames every node received
+ * from every other node. With --serial, the same scenario runs on the
+ * default simulator and a YansWifiChannel, which must give the same
+ * counts as any number of ranks:
+ *
+ *     mpiexec -n 1 wifi-distributed --serial
+ *     mpiexec -n 2 wifi-distributed
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiDistributedExample");
+
+namespace {
+
+const uint32_t g_nNodes = 8;                 //!< Number of nodes
+const double g_spacing = 120;                //!< Distance between the start positions of the nodes (m)
+std::vector<uint64_t> g_received (g_nNodes * g_nNodes, 0); //!< Frames received, per receiver and sender
+std::map<Mac48Address, uint32_t> g_senders;  //!< Node of each device address
+
+/**
+ * Count a frame received by a device.
+ *
+ * \param device the receiving device
+ * \param packet the packet received
+ * \param protocol the protocol of the packet
+ * \param from the address of the sender
+ * \return true
+ */
+bool
+Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  uint32_t receiver = device->GetNode ()->GetId ();
+  uint32_t sender = g_senders.at (Mac48Address::ConvertFrom (from));
+  g_received[receiver * g_nNodes + sender]++;
+  return true;
+}
+
+/**
+ * Broadcast a frame.
+ *
+ * \param device the sending device
+ */
+void
+SendFrame (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (100), device->GetBroadcast (), 0x88b5);
+}
+
+} // unnamed namespace
+
+int
+main (int argc, char *argv[])
+{
+  bool serial = false;
+  bool testing = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("serial", "Run on the default simulator and a YansWifiChannel", serial);
+  cmd.AddValue ("test", "Enable regression test output", testing);
+  cmd.Parse (argc, argv);
+
+  uint32_t systemId = 0;
+  uint32_t systemCount = 1;
+  if (!serial)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::DistributedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+      systemId = MpiInterface::GetSystemId ();
+      systemCount = MpiInterface::GetSize ();
+    }
+
+  // The rank owning a node is the strip of the line where it starts
+  NodeContainer nodes;
+  double stripWidth = g_nNodes * g_spacing / systemCount;
+  for (uint32_t i = 0; i < g_nNodes; i++)
+    {
+      double x = (i + 0.5) * g_spacing;
+      nodes.Add (CreateObject<Node> (std::min (static_cast<uint32_t> (x / stripWidth), systemCount - 1)));
+    }
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211p);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate3MbpsBW10MHz"),
+                                "ControlMode", StringValue ("OfdmRate3MbpsBW10MHz"),
+                                "NonUnicastMode", StringValue ("OfdmRate3MbpsBW10MHz"));
+
+  YansWifiChannelHelper channelHelper;
+  channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  channelHelper.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (5.9e9));
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  if (!serial)
+    {
+      Ptr<YansWifiRemoteChannel> remote = CreateObject<YansWifiRemoteChannel> ();
+      PointerValue loss;
+      PointerValue delay;
+      channel->GetAttribute ("PropagationLossModel", loss);
+      channel->GetAttribute ("PropagationDelayModel", delay);
+      remote->SetAttribute ("PropagationLossModel", loss);
+      remote->SetAttribute ("PropagationDelayModel", delay);
+      channel = remote;
+    }
+
+  YansWifiPhyHelper phy;
+  phy.Set ("ChannelWidth", UintegerValue (10));
+  phy.Set ("TxPowerStart", DoubleValue (20));
+  phy.Set ("TxPowerEnd", DoubleValue (20));
+  phy.Set ("RxSensitivity", DoubleValue (-85));
+  phy.SetChannel (channel);
+
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 0);
+
+  // Every rank moves all nodes, the remote channel checks that they agree
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < g_nNodes; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector ((i + 0.5) * g_spacing, 0, 0));
+      model->SetVelocity (Vector (0, (i % 3) * 10.0, 0));
+    }
+
+  for (uint32_t i = 0; i < g_nNodes; i++)
+    {
+      Ptr<NetDevice> device = devices.Get (i);
+      g_senders[Mac48Address::ConvertFrom (device->GetAddress ())] = i;
+      if (nodes.Get (i)->GetSystemId () != systemId)
+        {
+          continue;
+        }
+      device->SetReceiveCallback (MakeCallback (&Receive));
+      for (uint32_t round = 0; round < 10; round++)
+        {
+          Time start = Seconds (1) + MilliSeconds (10 * (round * g_nNodes + i));
+          Simulator::ScheduleWithContext (nodes.Get (i)->GetId (), start, &SendFrame, device);
+        }
+    }
+
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  std::vector<uint64_t> received (g_received.size ());
+  if (serial)
+    {
+      received = g_received;
+    }
+  else
+    {
+      // Each rank counted the receptions of its own nodes
+      MPI_Reduce (g_received.data (), received.data (), g_received.size (), MPI_UINT64_T,
+                  MPI_SUM, 0, MpiInterface::GetCommunicator ());
+      Ptr<YansWifiRemoteChannel> remote = DynamicCast<YansWifiRemoteChannel> (channel);
+      std::cout << "Rank " << systemId << ": " << remote->GetRemoteSends () << " messages sent, "
+                << remote->GetRemoteReceptions () << " received" << std::endl;
+    }
+
+  if (systemId == 0)
+    {
+      std::string prefix = testing ? "TEST : " : "";
+      uint64_t total = 0;
+      for (uint32_t receiver = 0; receiver < g_nNodes; receiver++)
+        {
+          for (uint32_t sender = 0; sender < g_nNodes; sender++)
+            {
+              uint64_t count = received[receiver * g_nNodes + sender];
+              total += count;
+              if (count > 0)
+                {
+                  std::cout << prefix << "node " << receiver << " received " << std::setw (2)
+                            << count << " frames from node " << sender << std::endl;
+                }
+            }
+        }
+      std::cout << prefix << "total " << total << " frames received" << std::endl;
+    }
+
+  Simulator::Destroy ();
+  if (!serial)
+    {
+      MpiInterface::Disable ();
+    }
+  return 0;
+}
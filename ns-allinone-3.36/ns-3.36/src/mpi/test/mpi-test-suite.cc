@@ -131,6 +131,8 @@ static MpiTestSuite g_mpiEmpty2    ("mpi-example-empty-2",     "simple-distribut
 static MpiTestSuite g_mpiEmpty3    ("mpi-example-empty-3",     "simple-distributed-empty-node", NS_TEST_SOURCEDIR, 3);
 static MpiTestSuite g_mpiSimple2   ("mpi-example-simple-2",    "simple-distributed", NS_TEST_SOURCEDIR, 2);
 static MpiTestSuite g_mpiThird2    ("mpi-example-third-2",     "third-distributed", NS_TEST_SOURCEDIR, 2);
+static MpiTestSuite g_mpiWifiSerial ("mpi-example-wifi-serial", "wifi-distributed", NS_TEST_SOURCEDIR, 1, "--serial");
+static MpiTestSuite g_mpiWifi2     ("mpi-example-wifi-2",      "wifi-distributed", NS_TEST_SOURCEDIR, 2);
 
 /* Tests using NullMessageSimulatorImpl */
 static MpiTestSuite g_mpiSimple2NullMsg ("mpi-example-simple-2-nullmsg",    "simple-distributed", NS_TEST_SOURCEDIR, 2, "--nullmsg");
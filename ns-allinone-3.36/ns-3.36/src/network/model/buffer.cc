@@ -520,6 +520,39 @@ Buffer::RemoveAtEnd (uint32_t end)
   NS_ASSERT (CheckInternalState ());
 }
 
+Buffer::Iterator
+Buffer::BeginPatch (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (CheckInternalState ());
+  NS_ASSERT (size <= GetSize ());
+  if (m_start + size > m_zeroAreaStart)
+    {
+      // The bytes to overwrite reach into the zero area
+      *this = CreateFullCopy ();
+    }
+  if (m_data->m_count > 1)
+    {
+      uint32_t internalSize = GetInternalSize ();
+      struct Buffer::Data *newData = Buffer::Create (internalSize);
+      memcpy (newData->m_data, m_data->m_data + m_start, internalSize);
+      m_data->m_count--;
+      m_data = newData;
+
+      m_zeroAreaStart -= m_start;
+      m_zeroAreaEnd -= m_start;
+      m_end -= m_start;
+      m_start = 0;
+
+      // update dirty area
+      m_data->m_dirtyStart = m_start;
+      m_data->m_dirtyEnd = m_end;
+    }
+  LOG_INTERNAL_STATE ("patch size=" << size << ", ");
+  NS_ASSERT (CheckInternalState ());
+  return Begin ();
+}
+
 Buffer 
 Buffer::CreateFragment (uint32_t start, uint32_t length) const
 {
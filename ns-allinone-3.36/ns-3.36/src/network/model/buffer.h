@@ -546,6 +546,19 @@ private:
    */
   void RemoveAtEnd (uint32_t end);
 
+  /**
+   * \param size number of bytes to overwrite
+   * \return an Iterator which points to the start of this Buffer
+   *
+   * Prepare the first size bytes of the Buffer to be overwritten
+   * in place through the returned Iterator. If the data is shared
+   * with other Buffers, it is copied first so that they keep the
+   * old bytes.
+   * Any call to this method invalidates any Iterator
+   * pointing to this Buffer.
+   */
+  Buffer::Iterator BeginPatch (uint32_t size);
+
   /**
    * \param start offset from start of packet
    * \param length
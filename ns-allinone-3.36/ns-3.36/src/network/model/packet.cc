@@ -304,6 +304,18 @@ Packet::PeekHeader (Header &header, uint32_t size) const
   return deserialized;
 }
 void
+Packet::PatchHeader (const Header &header, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  if (header.GetSerializedSize () != size)
+    {
+      RemoveAtStart (size);
+      AddHeader (header);
+      return;
+    }
+  header.Serialize (m_buffer.BeginPatch (size));
+}
+void
 Packet::AddTrailer (const Trailer &trailer)
 {
   uint32_t size = trailer.GetSerializedSize ();
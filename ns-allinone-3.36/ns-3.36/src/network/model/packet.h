@@ -356,6 +356,21 @@ public:
    * \returns the number of bytes read from the packet.
    */
   uint32_t PeekHeader (Header &header, uint32_t size) const;
+  /**
+   * \brief Overwrite the header at the start of the internal buffer.
+   *
+   * The size bytes at the start of the packet, which hold a header of the
+   * same type as the given one (e.g., as returned by PeekHeader), are
+   * replaced by the serialization of the given header. When the header
+   * still serializes to size bytes, it is written in place without
+   * touching the metadata; the bytes are copied first only if the buffer
+   * is shared with other packets. Otherwise, the old header is removed and
+   * the new one added.
+   *
+   * \param header a reference to the header to write to the packet.
+   * \param size number of bytes of the header to overwrite
+   */
+  void PatchHeader (const Header &header, uint32_t size);
   /**
    * \brief Add trailer to this packet.
    *
@@ -855,6 +855,33 @@ PacketTest::DoRun (void)
     ALargeTestTag a;
     tmp->AddPacketTag (a);
   }
+
+  /* Test PatchHeader */
+  {
+    uint8_t data[6] = {9, 9, 9, 9, 9, 9};
+    Ptr<Packet> tmp = Create<Packet> (data, 6);
+    Ptr<Packet> copy = tmp->Copy ();
+    copy->PatchHeader (ATestHeader<3> (), 3);
+    uint8_t out[8];
+    copy->CopyData (out, 6);
+    NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 6, "in place patch changed the size");
+    NS_TEST_EXPECT_MSG_EQ (int (out[0]) + out[1] + out[2], 9, "header not patched");
+    NS_TEST_EXPECT_MSG_EQ (int (out[3]) + out[4] + out[5], 27, "bytes after the header patched");
+    tmp->CopyData (out, 6);
+    NS_TEST_EXPECT_MSG_EQ (int (out[0]) + out[1] + out[2], 27, "patch of a copy changed the original");
+
+    // A header of another size replaces the old one
+    copy->PatchHeader (ATestHeader<5> (), 3);
+    NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 8, "header of another size not replaced");
+    copy->CopyData (out, 8);
+    NS_TEST_EXPECT_MSG_EQ (int (out[0]) + out[4] + out[5], 19, "new header not added");
+
+    // Bytes in the zero area are made real first
+    tmp = Create<Packet> (4);
+    tmp->PatchHeader (ATestHeader<2> (), 2);
+    tmp->CopyData (out, 4);
+    NS_TEST_EXPECT_MSG_EQ (int (out[0]) + out[1] + out[2] + out[3], 4, "zero area not patched");
+  }
 }
 
 /**
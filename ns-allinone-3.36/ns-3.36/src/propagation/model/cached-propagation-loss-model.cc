@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+#include "ns3/mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The deterministic propagation loss model chain whose RX power is cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("Epsilon",
+                   "The RX power of a link is reused as long as both nodes have moved by "
+                   "at most this distance (m) since it was computed.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_epsilon),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_epsilon (0.0),
+    m_hits (0),
+    m_misses (0)
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  m_model = 0;
+  m_indices.clear ();
+  m_mobilityModels.clear ();
+  m_links.clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_links.clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_links.clear ();
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses (void) const
+{
+  return m_misses;
+}
+
+std::size_t
+CachedPropagationLossModel::GetSize (void) const
+{
+  return m_links.size ();
+}
+
+uint32_t
+CachedPropagationLossModel::GetIndex (Ptr<MobilityModel> mobility) const
+{
+  auto it = m_indices.find (PeekPointer (mobility));
+  if (it != m_indices.end ())
+    {
+      return it->second;
+    }
+  uint32_t index = m_mobilityModels.size ();
+  m_indices.insert ({PeekPointer (mobility), index});
+  m_mobilityModels.push_back (mobility);
+  return index;
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No propagation loss model to cache");
+  uint64_t key = (static_cast<uint64_t> (GetIndex (a)) << 32) | GetIndex (b);
+  Vector txPosition = a->GetPosition ();
+  Vector rxPosition = b->GetPosition ();
+  double epsilon2 = m_epsilon * m_epsilon;
+  auto it = m_links.find (key);
+  if (it != m_links.end ())
+    {
+      const Link &link = it->second;
+      Vector txMove = txPosition - link.m_txPosition;
+      Vector rxMove = rxPosition - link.m_rxPosition;
+      if (txMove.x * txMove.x + txMove.y * txMove.y + txMove.z * txMove.z <= epsilon2
+          && rxMove.x * rxMove.x + rxMove.y * rxMove.y + rxMove.z * rxMove.z <= epsilon2)
+        {
+          m_hits++;
+          if (txPowerDbm == link.m_txPowerDbm)
+            {
+              return link.m_rxPowerDbm;
+            }
+          // the loss does not depend on the TX power
+          return txPowerDbm - (link.m_txPowerDbm - link.m_rxPowerDbm);
+        }
+    }
+  m_misses++;
+  double rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  m_links[key] = Link {txPosition, rxPosition, txPowerDbm, rxPowerDbm};
+  NS_LOG_LOGIC (this << " link " << key << " rxPower=" << rxPowerDbm << "dBm");
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+} // namespace ns3
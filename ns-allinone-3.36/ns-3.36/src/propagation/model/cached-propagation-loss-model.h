@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "propagation-loss-model.h"
+#include "ns3/vector.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the RX power of a propagation loss model chain per link
+ *
+ * The RX power computed by the Model chain for a transmitter and a receiver
+ * is kept together with their positions, and reused as long as both nodes
+ * have moved by at most Epsilon meters since then. With the default Epsilon
+ * of 0, the value is reused only while both nodes stay at the same position,
+ * so the results are those of the Model chain.
+ *
+ * The links are keyed on dense indices of the mobility models, assigned in
+ * order of first use, in an unordered_map. The mobility models are kept
+ * alive by the cache, so that their addresses are not reused.
+ *
+ * The Model chain must be deterministic, and its loss independent of the TX
+ * power: a reused value is applied to the TX power of the new call as the
+ * same loss in dB. Changes to the Model chain are not detected; Clear()
+ * drops the cached values.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  // Delete copy constructor and assignment operator to avoid misuse
+  CachedPropagationLossModel (const CachedPropagationLossModel &) = delete;
+  CachedPropagationLossModel & operator = (const CachedPropagationLossModel &) = delete;
+
+  /**
+   * \param model the propagation loss model chain whose RX power is cached
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the propagation loss model chain whose RX power is cached
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * Drop the cached values, e.g. after a change of the Model chain.
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of calls answered from the cache
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \return the number of calls evaluated by the Model chain
+   */
+  uint64_t GetMisses (void) const;
+  /**
+   * \return the number of links in the cache
+   */
+  std::size_t GetSize (void) const;
+
+protected:
+  void DoDispose (void) override;
+
+private:
+  double DoCalcRxPower (double txPowerDbm,
+                        Ptr<MobilityModel> a,
+                        Ptr<MobilityModel> b) const override;
+
+  int64_t DoAssignStreams (int64_t stream) override;
+
+  /**
+   * \param mobility the mobility model
+   * \return the dense index of the mobility model
+   */
+  uint32_t GetIndex (Ptr<MobilityModel> mobility) const;
+
+  /// The RX power of a link
+  struct Link
+  {
+    Vector m_txPosition; //!< Position of the transmitter when the RX power was computed
+    Vector m_rxPosition; //!< Position of the receiver when the RX power was computed
+    double m_txPowerDbm; //!< TX power the RX power was computed for (dBm)
+    double m_rxPowerDbm; //!< RX power (dBm)
+  };
+
+  Ptr<PropagationLossModel> m_model; //!< Propagation loss model chain whose RX power is cached
+  double m_epsilon; //!< Movement (m) below which the RX power is reused
+
+  mutable std::unordered_map<const MobilityModel *, uint32_t> m_indices; //!< Dense index of every mobility model
+  /// Mobility models by index, kept alive so that their addresses are not reused
+  mutable std::vector<Ptr<MobilityModel> > m_mobilityModels;
+  mutable std::unordered_map<uint64_t, Link> m_links; //!< RX power of the links, keyed on their indices
+  mutable uint64_t m_hits; //!< Calls answered from the cache
+  mutable uint64_t m_misses; //!< Calls evaluated by the Model chain
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fast-propagation-loss.h"
+#include "propagation-loss-model.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FastPropagationLoss");
+
+FastPropagationLoss::FastPropagationLoss ()
+  : m_model (NONE),
+    m_constantDb (0),
+    m_slopeDb (0),
+    m_minDistance2 (0),
+    m_minLossDb (0),
+    m_lambda (0),
+    m_heightAboveZ (0),
+    m_systemLoss (1)
+{
+  std::fill (m_params, m_params + 4, 0.0);
+}
+
+bool
+FastPropagationLoss::Compile (Ptr<PropagationLossModel> loss)
+{
+  Model model = NONE;
+  double params[4] = {0, 0, 0, 0};
+  if (loss == 0 || loss->GetNext () != 0)
+    {
+      // Not supported
+    }
+  else if (Ptr<FriisPropagationLossModel> friis = DynamicCast<FriisPropagationLossModel> (loss))
+    {
+      model = FRIIS;
+      params[0] = friis->GetFrequency ();
+      params[1] = friis->GetSystemLoss ();
+      params[2] = friis->GetMinLoss ();
+    }
+  else if (Ptr<LogDistancePropagationLossModel> logDistance = DynamicCast<LogDistancePropagationLossModel> (loss))
+    {
+      model = LOG_DISTANCE;
+      params[0] = logDistance->GetPathLossExponent ();
+      params[1] = logDistance->GetReferenceDistance ();
+      params[2] = logDistance->GetReferenceLoss ();
+    }
+  else if (Ptr<TwoRayGroundPropagationLossModel> twoRay = DynamicCast<TwoRayGroundPropagationLossModel> (loss))
+    {
+      model = TWO_RAY_GROUND;
+      params[0] = twoRay->GetFrequency ();
+      params[1] = twoRay->GetSystemLoss ();
+      params[2] = twoRay->GetMinDistance ();
+      params[3] = twoRay->GetHeightAboveZ ();
+    }
+  if (model == m_model && std::equal (params, params + 4, m_params))
+    {
+      return m_model != NONE;
+    }
+  NS_LOG_FUNCTION (this << loss);
+  m_model = model;
+  std::copy (params, params + 4, m_params);
+
+  static const double C = 299792458.0; // speed of light in vacuum
+  switch (m_model)
+    {
+    case FRIIS:
+      {
+        // loss = -10 log10 (lambda^2 / (16 pi^2 d^2 L)) = 10 log10 (16 pi^2 L / lambda^2) + 10 log10 (d^2)
+        double lambda = C / params[0];
+        m_constantDb = 10 * std::log10 (16 * M_PI * M_PI * params[1] / (lambda * lambda));
+        m_slopeDb = 10;
+        m_minDistance2 = 0;
+        m_minLossDb = params[2];
+        break;
+      }
+    case LOG_DISTANCE:
+      {
+        // loss = L0 + 10 n log10 (d / d0) = L0 - 5 n log10 (d0^2) + 5 n log10 (d^2)
+        double d0 = params[1];
+        m_slopeDb = 5 * params[0];
+        m_constantDb = params[2] - m_slopeDb * std::log10 (d0 * d0);
+        m_minDistance2 = d0 * d0;
+        m_minLossDb = params[2];
+        break;
+      }
+    case TWO_RAY_GROUND:
+      m_lambda = C / params[0];
+      m_systemLoss = params[1];
+      m_heightAboveZ = params[3];
+      // Friis without the minimum loss below the crossover distance
+      m_constantDb = 10 * std::log10 (16 * M_PI * M_PI * m_systemLoss / (m_lambda * m_lambda));
+      m_slopeDb = 10;
+      m_minDistance2 = params[2] * params[2];
+      m_minLossDb = 0;
+      break;
+    default:
+      break;
+    }
+  return m_model != NONE;
+}
+
+bool
+FastPropagationLoss::IsValid (void) const
+{
+  return m_model != NONE;
+}
+
+bool
+FastPropagationLoss::IsDistanceOnly (void) const
+{
+  return m_model == FRIIS || m_model == LOG_DISTANCE;
+}
+
+double
+FastPropagationLoss::GetMaxDistance (double maxLossDb) const
+{
+  NS_ASSERT_MSG (IsDistanceOnly (), "The compiled model does not only depend on the distance");
+  // Both models apply m_minLossDb at short distances and grow with the slope beyond
+  if (m_minLossDb > maxLossDb)
+    {
+      return 0;
+    }
+  if (m_slopeDb <= 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  // maxLossDb = m_constantDb + m_slopeDb * log10 (d^2)
+  double d2 = std::pow (10.0, (maxLossDb - m_constantDb) / m_slopeDb);
+  return std::sqrt (std::max (d2, m_minDistance2));
+}
+
+void
+FastPropagationLoss::CalcRxPower (double txPowerDbm, const Vector &sender,
+                                  const Vector *receivers, std::size_t n, double *rxPowerDbm) const
+{
+  NS_ASSERT_MSG (m_model != NONE, "No propagation loss model compiled");
+  switch (m_model)
+    {
+    case FRIIS:
+      for (std::size_t i = 0; i < n; i++)
+        {
+          double d2 = CalculateDistanceSquared (sender, receivers[i]);
+          double lossDb = d2 > 0 ? std::max (m_constantDb + m_slopeDb * std::log10 (d2), m_minLossDb) : m_minLossDb;
+          rxPowerDbm[i] = txPowerDbm - lossDb;
+        }
+      break;
+    case LOG_DISTANCE:
+      for (std::size_t i = 0; i < n; i++)
+        {
+          double d2 = CalculateDistanceSquared (sender, receivers[i]);
+          double lossDb = d2 > m_minDistance2 ? m_constantDb + m_slopeDb * std::log10 (d2) : m_minLossDb;
+          rxPowerDbm[i] = txPowerDbm - lossDb;
+        }
+      break;
+    case TWO_RAY_GROUND:
+      for (std::size_t i = 0; i < n; i++)
+        {
+          double d2 = CalculateDistanceSquared (sender, receivers[i]);
+          if (d2 <= m_minDistance2)
+            {
+              rxPowerDbm[i] = txPowerDbm;
+              continue;
+            }
+          double heights = (sender.z + m_heightAboveZ) * (receivers[i].z + m_heightAboveZ);
+          double dCross = 4 * M_PI * heights / m_lambda;
+          if (dCross >= 0 && d2 <= dCross * dCross)
+            {
+              rxPowerDbm[i] = txPowerDbm - (m_constantDb + m_slopeDb * std::log10 (d2));
+            }
+          else
+            {
+              rxPowerDbm[i] = txPowerDbm + 10 * std::log10 (heights * heights / (d2 * d2 * m_systemLoss));
+            }
+        }
+      break;
+    default:
+      break;
+    }
+}
+
+double
+FastPropagationLoss::CalcRxPower (double txPowerDbm, const Vector &sender, const Vector &receiver) const
+{
+  double rxPowerDbm = txPowerDbm;
+  CalcRxPower (txPowerDbm, sender, &receiver, 1, &rxPowerDbm);
+  return rxPowerDbm;
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FAST_PROPAGATION_LOSS_H
+#define FAST_PROPAGATION_LOSS_H
+
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include <cstddef>
+
+namespace ns3 {
+
+class PropagationLossModel;
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Evaluates a deterministic propagation loss model for many receivers at once
+ *
+ * Compile() reads the parameters of a FriisPropagationLossModel,
+ * LogDistancePropagationLossModel or TwoRayGroundPropagationLossModel and
+ * folds them into a few constants, so that the RX power is a closed-form
+ * function of the squared distance: one log10 per receiver, no square root,
+ * no virtual call and no mobility model lookup. CalcRxPower works on plain
+ * position arrays, so callers can gather the positions once and evaluate a
+ * whole batch of receivers.
+ *
+ * The results agree with PropagationLossModel::CalcRxPower to within
+ * 1e-9 dB. The terms are grouped differently, so they are not always
+ * bitwise identical. Chained models and any other loss model are not
+ * supported; Compile() returns false for them.
+ *
+ * For the Friis and LogDistance models, which only depend on the distance
+ * between the nodes, GetMaxDistance inverts the loss in closed form.
+ *
+ * The model parameters are copied by Compile(), so later changes to the
+ * model require compiling it again. Compile() reads the parameters through
+ * their getters and only folds them again when they differ from the ones
+ * compiled last, so callers can cheaply compile before every batch to pick
+ * up attribute changes.
+ */
+class FastPropagationLoss
+{
+public:
+  FastPropagationLoss ();
+
+  /**
+   * \param loss the propagation loss model to evaluate
+   * \return true if the model is supported, false otherwise
+   */
+  bool Compile (Ptr<PropagationLossModel> loss);
+
+  /**
+   * \return true if a supported model has been compiled
+   */
+  bool IsValid (void) const;
+
+  /**
+   * \return true if the compiled model only depends on the distance between
+   *         the nodes, i.e. it is a Friis or LogDistance model
+   */
+  bool IsDistanceOnly (void) const;
+
+  /**
+   * Only valid if IsDistanceOnly () is true.
+   *
+   * \param maxLossDb the largest acceptable loss (dB)
+   * \return the largest distance (m) at which the loss does not exceed
+   *         maxLossDb, 0 if it is exceeded at any distance and infinity if
+   *         it is never exceeded
+   */
+  double GetMaxDistance (double maxLossDb) const;
+
+  /**
+   * \param txPowerDbm the TX power (dBm)
+   * \param sender the position of the sender
+   * \param receivers the positions of the receivers
+   * \param n the number of receivers
+   * \param rxPowerDbm array of n values receiving the RX power (dBm) of each receiver
+   */
+  void CalcRxPower (double txPowerDbm, const Vector &sender,
+                    const Vector *receivers, std::size_t n, double *rxPowerDbm) const;
+
+  /**
+   * \param txPowerDbm the TX power (dBm)
+   * \param sender the position of the sender
+   * \param receiver the position of the receiver
+   * \return the RX power (dBm)
+   */
+  double CalcRxPower (double txPowerDbm, const Vector &sender, const Vector &receiver) const;
+
+private:
+  /// The supported models
+  enum Model
+  {
+    NONE,
+    FRIIS,
+    LOG_DISTANCE,
+    TWO_RAY_GROUND
+  };
+
+  Model m_model;            //!< the compiled model
+  double m_params[4];       //!< the parameters the constants were folded from
+  double m_constantDb;      //!< loss at a squared distance of 1 m^2 (dB)
+  double m_slopeDb;         //!< loss per decade of the squared distance (dB)
+  double m_minDistance2;    //!< squared distance below which m_minLossDb applies (m^2)
+  double m_minLossDb;       //!< loss at short distances (dB)
+  double m_lambda;          //!< wavelength for the two-ray crossover distance (m)
+  double m_heightAboveZ;    //!< antenna height above the node (m)
+  double m_systemLoss;      //!< system loss of the two-ray model (linear)
+};
+
+} // namespace ns3
+
+#endif /* FAST_PROPAGATION_LOSS_H */
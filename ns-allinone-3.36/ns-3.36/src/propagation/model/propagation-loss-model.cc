@@ -343,6 +343,12 @@ TwoRayGroundPropagationLossModel::SetHeightAboveZ (double heightAboveZ)
   m_heightAboveZ = heightAboveZ;
 }
 
+double
+TwoRayGroundPropagationLossModel::GetHeightAboveZ (void) const
+{
+  return m_heightAboveZ;
+}
+
 void
 TwoRayGroundPropagationLossModel::SetFrequency (double frequency)
 {
@@ -503,6 +509,18 @@ LogDistancePropagationLossModel::GetPathLossExponent (void) const
   return m_exponent;
 }
 
+double
+LogDistancePropagationLossModel::GetReferenceDistance (void) const
+{
+  return m_referenceDistance;
+}
+
+double
+LogDistancePropagationLossModel::GetReferenceLoss (void) const
+{
+  return m_referenceLoss;
+}
+
 double
 LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                                 Ptr<MobilityModel> a,
@@ -409,6 +409,10 @@ public:
    * Set the model antenna height above the node's Z coordinate
    */
   void SetHeightAboveZ (double heightAboveZ);
+  /**
+   * \return the model antenna height above the node's Z coordinate
+   */
+  double GetHeightAboveZ (void) const;
 
 private:
   double DoCalcRxPower (double txPowerDbm,
@@ -487,6 +491,14 @@ public:
    * \param referenceLoss reference path loss
    */
   void SetReference (double referenceDistance, double referenceLoss);
+  /**
+   * \returns the reference distance.
+   */
+  double GetReferenceDistance (void) const;
+  /**
+   * \returns the reference path loss.
+   */
+  double GetReferenceLoss (void) const;
 
 private:
   double DoCalcRxPower (double txPowerDbm,
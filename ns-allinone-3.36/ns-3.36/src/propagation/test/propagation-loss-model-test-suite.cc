@@ -22,6 +22,9 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/fast-propagation-loss.h"
+#include "ns3/cached-propagation-loss-model.h"
+#include "ns3/pointer.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -473,6 +476,211 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief FastPropagationLoss Test
+ *
+ * Check that the closed-form evaluation of the Friis, LogDistance and
+ * TwoRayGround models agrees with their CalcRxPower at distances below,
+ * around and above the reference, minimum and crossover distances.
+ */
+class FastPropagationLossTestCase : public TestCase
+{
+public:
+  FastPropagationLossTestCase ();
+  virtual ~FastPropagationLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the fast path against the loss model.
+   * \param lossModel the model to compare
+   */
+  void Check (Ptr<PropagationLossModel> lossModel);
+};
+
+FastPropagationLossTestCase::FastPropagationLossTestCase ()
+  : TestCase ("Check that FastPropagationLoss matches the deterministic propagation loss models")
+{
+}
+
+FastPropagationLossTestCase::~FastPropagationLossTestCase ()
+{
+}
+
+void
+FastPropagationLossTestCase::Check (Ptr<PropagationLossModel> lossModel)
+{
+  FastPropagationLoss fastLoss;
+  NS_TEST_ASSERT_MSG_EQ (fastLoss.Compile (lossModel), true, "Model not supported by the fast path");
+
+  Vector sender (10, 20, 1);
+  std::vector<Vector> receivers;
+  for (double d = 0; d < 3000; d = d * 1.1 + 0.05)
+    {
+      receivers.push_back (Vector (sender.x + d * 0.6, sender.y - d * 0.8, 0));
+      receivers.push_back (Vector (sender.x + d, sender.y, 7.5));
+    }
+  std::vector<double> rxPowers (receivers.size ());
+  double txPowerDbm = 16.0206;
+  fastLoss.CalcRxPower (txPowerDbm, sender, receivers.data (), receivers.size (), rxPowers.data ());
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (sender);
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  for (std::size_t i = 0; i < receivers.size (); i++)
+    {
+      b->SetPosition (receivers[i]);
+      double expected = lossModel->CalcRxPower (txPowerDbm, a, b);
+      NS_TEST_EXPECT_MSG_EQ_TOL (rxPowers[i], expected, 1e-9, "Got unexpected rcv power at " << receivers[i]);
+      NS_TEST_EXPECT_MSG_EQ_TOL (fastLoss.CalcRxPower (txPowerDbm, sender, receivers[i]), expected, 1e-9,
+                                 "Got unexpected rcv power at " << receivers[i]);
+    }
+
+  if (!fastLoss.IsDistanceOnly ())
+    {
+      return;
+    }
+  // The inverted loss is reached at the returned distance and exceeded just beyond
+  for (double maxLossDb : {60.0, 80.0, 100.0})
+    {
+      double distance = fastLoss.GetMaxDistance (maxLossDb);
+      b->SetPosition (Vector (sender.x, sender.y, sender.z + distance));
+      NS_TEST_EXPECT_MSG_EQ_TOL (txPowerDbm - lossModel->CalcRxPower (txPowerDbm, a, b), maxLossDb, 1e-9,
+                                 "Wrong distance " << distance << " for a loss of " << maxLossDb);
+      b->SetPosition (Vector (sender.x, sender.y, sender.z + distance * 1.001));
+      NS_TEST_EXPECT_MSG_GT (txPowerDbm - lossModel->CalcRxPower (txPowerDbm, a, b), maxLossDb,
+                             "Loss not exceeded beyond " << distance);
+    }
+  NS_TEST_EXPECT_MSG_EQ (fastLoss.GetMaxDistance (20), 0, "Loss below the minimum loss reached");
+}
+
+void
+FastPropagationLossTestCase::DoRun (void)
+{
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  friis->SetFrequency (5.18e9);
+  friis->SetSystemLoss (2);
+  friis->SetMinLoss (40);
+  Check (friis);
+
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  logDistance->SetPathLossExponent (2.7);
+  logDistance->SetReference (2, 47.5);
+  Check (logDistance);
+
+  Ptr<TwoRayGroundPropagationLossModel> twoRay = CreateObject<TwoRayGroundPropagationLossModel> ();
+  twoRay->SetFrequency (2.4e9);
+  twoRay->SetHeightAboveZ (1.5);
+  twoRay->SetMinDistance (0.5);
+  Check (twoRay);
+  FastPropagationLoss twoRayLoss;
+  twoRayLoss.Compile (twoRay);
+  NS_TEST_EXPECT_MSG_EQ (twoRayLoss.IsDistanceOnly (), false, "TwoRayGround depends on the antenna heights");
+
+  // Compiling again picks up changed attributes of the same model
+  FastPropagationLoss fastLoss;
+  NS_TEST_ASSERT_MSG_EQ (fastLoss.Compile (logDistance), true, "Model not supported by the fast path");
+  logDistance->SetAttribute ("Exponent", DoubleValue (3.5));
+  NS_TEST_ASSERT_MSG_EQ (fastLoss.Compile (logDistance), true, "Model not supported by the fast path");
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (250, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastLoss.CalcRxPower (16, a->GetPosition (), b->GetPosition ()),
+                             logDistance->CalcRxPower (16, a, b), 1e-9, "Stale exponent after an attribute change");
+
+  // Chained and unsupported models are rejected
+  friis->SetNext (CreateObject<RangePropagationLossModel> ());
+  NS_TEST_EXPECT_MSG_EQ (fastLoss.Compile (friis), false, "Chained model accepted by the fast path");
+  NS_TEST_EXPECT_MSG_EQ (fastLoss.IsValid (), false, "Rejected model left the fast path valid");
+  NS_TEST_EXPECT_MSG_EQ (fastLoss.Compile (CreateObject<RandomPropagationLossModel> ()), false,
+                         "Random model accepted by the fast path");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief CachedPropagationLossModel Test
+ *
+ * Check that a chain of loss models is evaluated again when a node moves by
+ * more than Epsilon, that the cached RX power is reused otherwise, and the
+ * hit and miss counters.
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Check the link budget cache of CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  // A chain of two deterministic models
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  friis->SetFrequency (5.9e9);
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  friis->SetNext (logDistance);
+
+  Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel> ();
+  cached->SetAttribute ("Model", PointerValue (friis));
+  cached->SetAttribute ("Epsilon", DoubleValue (1.0));
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (100, 0, 0));
+  c->SetPosition (Vector (0, 200, 0));
+
+  double rxPower = cached->CalcRxPower (16, a, b);
+  NS_TEST_EXPECT_MSG_EQ (rxPower, friis->CalcRxPower (16, a, b), "Miss differs from the chain");
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, b), rxPower, "Hit differs from the miss");
+  double higherRxPower = cached->CalcRxPower (20, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (higherRxPower, rxPower + 4, 1e-12, "Hit not applied to the TX power");
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, c), friis->CalcRxPower (16, a, c), "Links mixed up");
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, c, a), friis->CalcRxPower (16, c, a), "Links mixed up");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetHits (), 2, "Wrong hit count");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetMisses (), 3, "Wrong miss count");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetSize (), 3, "Wrong link count");
+
+  // Moves of up to Epsilon reuse the RX power of the link
+  b->SetPosition (Vector (100.6, 0.8, 0));
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, b), rxPower, "Move below Epsilon not cached");
+  a->SetPosition (Vector (0, 0, 0.5));
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, b), rxPower, "Move below Epsilon not cached");
+  // Farther, the chain is evaluated again, from the new positions
+  b->SetPosition (Vector (101.1, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, b), friis->CalcRxPower (16, a, b), "Move above Epsilon cached");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetHits (), 4, "Wrong hit count");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetMisses (), 4, "Wrong miss count");
+
+  // Without Epsilon, any move evaluates the chain again
+  cached->SetAttribute ("Epsilon", DoubleValue (0.0));
+  b->SetPosition (Vector (101.1, 1e-6, 0));
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, b), friis->CalcRxPower (16, a, b), "Move cached without Epsilon");
+  NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (16, a, b), friis->CalcRxPower (16, a, b), "Static link not cached");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetHits (), 5, "Wrong hit count");
+  NS_TEST_EXPECT_MSG_EQ (cached->GetMisses (), 5, "Wrong miss count");
+
+  cached->Clear ();
+  NS_TEST_EXPECT_MSG_EQ (cached->GetSize (), 0, "Cache not cleared");
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -484,6 +692,8 @@ RangePropagationLossModelTestCase::DoRun (void)
  *   - LogDistancePropagationLossModel
  *   - MatrixPropagationLossModel
  *   - RangePropagationLossModel
+ *   - FastPropagationLoss
+ *   - CachedPropagationLossModel
  */
 class PropagationLossModelsTestSuite : public TestSuite
 {
@@ -499,6 +709,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new FastPropagationLossTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
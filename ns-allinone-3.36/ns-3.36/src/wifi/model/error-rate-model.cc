@@ -85,6 +85,35 @@ ErrorRateModel::GetChunkSuccessRate (WifiMode mode, const WifiTxVector& txVector
   return 0;
 }
 
+void
+ErrorRateModel::GetChunkSuccessRates (WifiMode mode, const WifiTxVector& txVector, const std::vector<double> &snrs,
+                                      const std::vector<uint64_t> &nbits, std::vector<double> &csrs,
+                                      uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const
+{
+  NS_ASSERT (snrs.size () == nbits.size ());
+  csrs.resize (snrs.size ());
+  if (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS || mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS)
+    {
+      for (std::size_t i = 0; i < snrs.size (); i++)
+        {
+          csrs[i] = GetChunkSuccessRate (mode, txVector, snrs[i], nbits[i], numRxAntennas, field, staId);
+        }
+      return;
+    }
+  DoGetChunkSuccessRates (mode, txVector, snrs, nbits, csrs, numRxAntennas, field, staId);
+}
+
+void
+ErrorRateModel::DoGetChunkSuccessRates (WifiMode mode, const WifiTxVector& txVector, const std::vector<double> &snrs,
+                                        const std::vector<uint64_t> &nbits, std::vector<double> &csrs,
+                                        uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const
+{
+  for (std::size_t i = 0; i < snrs.size (); i++)
+    {
+      csrs[i] = DoGetChunkSuccessRate (mode, txVector, snrs[i], nbits[i], numRxAntennas, field, staId);
+    }
+}
+
 bool
 ErrorRateModel::IsAwgn (void) const
 {
@@ -23,6 +23,7 @@
 
 #include "ns3/object.h"
 #include "wifi-mode.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -85,6 +86,26 @@ public:
   double GetChunkSuccessRate (WifiMode mode, const WifiTxVector& txVector, double snr, uint64_t nbits,
                               uint8_t numRxAntennas = 1, WifiPpduField field = WIFI_PPDU_FIELD_DATA,
                               uint16_t staId = SU_STA_ID) const;
+  /**
+   * This method returns the probabilities that the given chunks of the
+   * same mode will be successfully received by the PHY, e.g. the chunks of
+   * a payload between two changes of the interference. The result is the
+   * same as calling GetChunkSuccessRate for every chunk, but a model can
+   * evaluate the chunks together.
+   *
+   * \param mode the Wi-Fi mode applicable to the chunks
+   * \param txVector TXVECTOR of the overall transmission
+   * \param snrs the SNR of each chunk
+   * \param nbits the number of bits in each chunk
+   * \param csrs the probability of successfully receiving each chunk, resized to the number of chunks
+   * \param numRxAntennas the number of active RX antennas (1 if not provided)
+   * \param field the PPDU field to which the chunks belong to (assumes this is for the payload part if not provided)
+   * \param staId the station ID for MU
+   */
+  void GetChunkSuccessRates (WifiMode mode, const WifiTxVector& txVector, const std::vector<double> &snrs,
+                             const std::vector<uint64_t> &nbits, std::vector<double> &csrs,
+                             uint8_t numRxAntennas = 1, WifiPpduField field = WIFI_PPDU_FIELD_DATA,
+                             uint16_t staId = SU_STA_ID) const;
 
   /**
    * Assign a fixed random variable stream number to the random variables
@@ -113,6 +134,22 @@ private:
    */
   virtual double DoGetChunkSuccessRate (WifiMode mode, const WifiTxVector& txVector, double snr, uint64_t nbits,
                                         uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const = 0;
+  /**
+   * Evaluate several chunks of a non-DSSS mode. The default implementation
+   * calls DoGetChunkSuccessRate for every chunk.
+   *
+   * \param mode the Wi-Fi mode applicable to the chunks
+   * \param txVector TXVECTOR of the overall transmission
+   * \param snrs the SNR of each chunk
+   * \param nbits the number of bits in each chunk
+   * \param csrs the probability of successfully receiving each chunk, already sized
+   * \param numRxAntennas the number of active RX antennas
+   * \param field the PPDU field to which the chunks belong to
+   * \param staId the station ID for MU
+   */
+  virtual void DoGetChunkSuccessRates (WifiMode mode, const WifiTxVector& txVector, const std::vector<double> &snrs,
+                                       const std::vector<uint64_t> &nbits, std::vector<double> &csrs,
+                                       uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const;
 };
 
 } //namespace ns3
@@ -294,7 +294,7 @@ InterferenceHelper::AppendEvent (Ptr<Event> event, bool isStartOfdmaRxing)
         {
           m_firstPowerPerBand.find (band)->second = previousPowerStart;
           // Always leave the first zero power noise event in the list
-          niIt->second.erase (++(niIt->second.begin ()), ++previousPowerPosition);
+          niIt->second.erase (niIt->second.begin () + 1, previousPowerPosition + 1);
         }
       else if (isStartOfdmaRxing)
         {
@@ -303,11 +303,11 @@ InterferenceHelper::AppendEvent (Ptr<Event> event, bool isStartOfdmaRxing)
           //UL MU transmission and the start of UL-OFDMA payload.
           m_firstPowerPerBand.find (band)->second = previousPowerStart;
         }
-      auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event), niIt);
-      auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event), niIt);
-      for (auto i = first; i != last; ++i)
+      std::size_t first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event), niIt);
+      std::size_t last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event), niIt);
+      for (std::size_t i = first; i != last; ++i)
         {
-          i->second.AddPower (it.second);
+          niIt->second[i].second.AddPower (it.second);
         }
     }
 }
@@ -367,22 +367,29 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChangesPerB
   double noiseInterferenceW = firstPower_it->second;
   auto niIt = m_niChangesPerBand.find (band);
   NS_ASSERT (niIt != m_niChangesPerBand.end ());
-  auto it = niIt->second.find (event->GetStartTime ());
-  for (; it != niIt->second.end () && it->first < Simulator::Now (); ++it)
+  const NiChanges &changes = niIt->second;
+  auto start = GetFirstPosition (event->GetStartTime (), changes);
+  if (start != changes.end () && start->first != event->GetStartTime ())
     {
-      noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW (band);
+      start = changes.end ();
     }
-  it = niIt->second.find (event->GetStartTime ());
-  NS_ASSERT (it != niIt->second.end ());
-  for (; it != niIt->second.end () && it->second.GetEvent () != event; ++it);
-  NiChanges ni;
-  ni.emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != niIt->second.end () && it->second.GetEvent () != event)
+  auto it = start;
+  for (; it != changes.end () && it->first < Simulator::Now (); ++it)
     {
-      ni.insert (*it);
+      noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW (band);
     }
-  ni.emplace (event->GetEndTime (), NiChange (0, event));
-  nis->insert ({band, ni});
+  it = start;
+  NS_ASSERT (it != changes.end ());
+  for (; it != changes.end () && it->second.GetEvent () != event; ++it);
+  auto end = it;
+  while (++end != changes.end () && end->second.GetEvent () != event);
+  // The changes are copied in time order, so they are appended
+  NiChanges ni;
+  ni.reserve (end - it + 1);
+  ni.emplace_back (event->GetStartTime (), NiChange (0, event));
+  ni.insert (ni.end (), it + 1, end);
+  ni.emplace_back (event->GetEndTime (), NiChange (0, event));
+  nis->insert ({band, std::move (ni)});
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -408,13 +415,19 @@ InterferenceHelper::CalculatePayloadChunkSuccessRate (double snir, Time duration
       return 1.0;
     }
   WifiMode mode = txVector.GetMode (staId);
-  uint64_t rate = mode.GetDataRate (txVector, staId);
-  uint64_t nbits = static_cast<uint64_t> (rate * duration.GetSeconds ());
-  nbits /= txVector.GetNss (staId); //divide effective number of bits by NSS to achieve same chunk error rate as SISO for AWGN
+  uint64_t nbits = GetPayloadChunkBits (duration, mode.GetDataRate (txVector, staId), txVector.GetNss (staId));
   double csr = m_errorRateModel->GetChunkSuccessRate (mode, txVector, snir, nbits, m_numRxAntennas, WIFI_PPDU_FIELD_DATA, staId);
   return csr;
 }
 
+uint64_t
+InterferenceHelper::GetPayloadChunkBits (Time duration, uint64_t rate, uint8_t nss)
+{
+  uint64_t nbits = static_cast<uint64_t> (rate * duration.GetSeconds ());
+  nbits /= nss; //divide effective number of bits by NSS to achieve same chunk error rate as SISO for AWGN
+  return nbits;
+}
+
 double
 InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, uint16_t channelWidth,
                                          NiChangesPerBand *nis, WifiSpectrumBand band,
@@ -425,33 +438,45 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, uint16_t channe
   const auto& niIt = nis->find (band)->second;
   auto j = niIt.cbegin ();
   Time previous = j->first;
-  WifiMode payloadMode = event->GetTxVector ().GetMode (staId);
+  WifiTxVector txVector = event->GetTxVector ();
+  WifiMode payloadMode = txVector.GetMode (staId);
+  uint64_t rate = payloadMode.GetDataRate (txVector, staId);
+  uint8_t nss = txVector.GetNss (staId);
   Time phyPayloadStart = j->first;
   if (event->GetPpdu ()->GetType () != WIFI_PPDU_TYPE_UL_MU) //j->first corresponds to the start of the UL-OFDMA payload
     {
-      phyPayloadStart = j->first + WifiPhy::CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ());
+      phyPayloadStart = j->first + WifiPhy::CalculatePhyPreambleAndHeaderDuration (txVector);
     }
   Time windowStart = phyPayloadStart + window.first;
   Time windowEnd = phyPayloadStart + window.second;
   double noiseInterferenceW = m_firstPowerPerBand.find (band)->second;
   double powerW = event->GetRxPowerW (band);
+  // The chunks are gathered and evaluated by the error rate model at once
+  m_chunkSnrs.clear ();
+  m_chunkBits.clear ();
   while (++j != niIt.cend ())
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
-      double snr = CalculateSnr (powerW, noiseInterferenceW, channelWidth, event->GetTxVector ().GetNss (staId));
+      Time duration;
       //Case 1: Both previous and current point to the windowed payload
       if (previous >= windowStart)
         {
-          psr *= CalculatePayloadChunkSuccessRate (snr, Min (windowEnd, current) - previous, event->GetTxVector (), staId);
-          NS_LOG_DEBUG ("Both previous and current point to the windowed payload: mode=" << payloadMode << ", psr=" << psr);
+          duration = Min (windowEnd, current) - previous;
+          NS_LOG_DEBUG ("Both previous and current point to the windowed payload: mode=" << payloadMode << ", duration=" << duration);
         }
       //Case 2: previous is before windowed payload and current is in the windowed payload
       else if (current >= windowStart)
         {
-          psr *= CalculatePayloadChunkSuccessRate (snr, Min (windowEnd, current) - windowStart, event->GetTxVector (), staId);
-          NS_LOG_DEBUG ("previous is before windowed payload and current is in the windowed payload: mode=" << payloadMode << ", psr=" << psr);
+          duration = Min (windowEnd, current) - windowStart;
+          NS_LOG_DEBUG ("previous is before windowed payload and current is in the windowed payload: mode=" << payloadMode << ", duration=" << duration);
+        }
+      // A chunk without duration succeeds
+      if (!duration.IsZero ())
+        {
+          m_chunkSnrs.push_back (CalculateSnr (powerW, noiseInterferenceW, channelWidth, nss));
+          m_chunkBits.push_back (GetPayloadChunkBits (duration, rate, nss));
         }
       noiseInterferenceW = j->second.GetPower () - powerW;
       previous = j->first;
@@ -461,6 +486,13 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, uint16_t channe
           break;
         }
     }
+  m_errorRateModel->GetChunkSuccessRates (payloadMode, txVector, m_chunkSnrs, m_chunkBits, m_chunkCsrs,
+                                          m_numRxAntennas, WIFI_PPDU_FIELD_DATA, staId);
+  for (double csr : m_chunkCsrs)
+    {
+      psr *= csr;
+    }
+  NS_LOG_DEBUG ("mode=" << payloadMode << ", chunks=" << m_chunkCsrs.size () << ", psr=" << psr);
   double per = 1 - psr;
   return per;
 }
@@ -472,8 +504,8 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChan
 {
   NS_LOG_FUNCTION (this << band.first << band.second);
   double psr = 1.0; /* Packet Success Rate */
-  auto niIt = nis->find (band)->second;
-  auto j = niIt.begin ();
+  const auto& niIt = nis->find (band)->second;
+  auto j = niIt.cbegin ();
 
   NS_ASSERT (!phyHeaderSections.empty ());
   Time stopLastSection = Seconds (0);
@@ -485,7 +517,7 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChan
   Time previous = j->first;
   double noiseInterferenceW = m_firstPowerPerBand.find (band)->second;
   double powerW = event->GetRxPowerW (band);
-  while (++j != niIt.end ())
+  while (++j != niIt.cend ())
     {
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
@@ -524,7 +556,7 @@ InterferenceHelper::CalculatePhyHeaderPer (Ptr<const Event> event, NiChangesPerB
                                            WifiPpduField header) const
 {
   NS_LOG_FUNCTION (this << band.first << band.second << header);
-  auto niIt = nis->find (band)->second;
+  const auto& niIt = nis->find (band)->second;
   auto phyEntity = WifiPhy::GetStaticPhyEntity (event->GetTxVector ().GetModulationClass ());
 
   PhyEntity::PhyHeaderSections sections;
@@ -612,7 +644,19 @@ InterferenceHelper::EraseEvents (void)
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::GetNextPosition (Time moment, NiChangesPerBand::iterator niIt)
 {
-  return niIt->second.upper_bound (moment);
+  return std::upper_bound (niIt->second.begin (), niIt->second.end (), moment,
+                           [] (const Time& t, const NiChanges::value_type& change) {
+                             return t < change.first;
+                           });
+}
+
+InterferenceHelper::NiChanges::const_iterator
+InterferenceHelper::GetFirstPosition (Time moment, const NiChanges &changes)
+{
+  return std::lower_bound (changes.begin (), changes.end (), moment,
+                           [] (const NiChanges::value_type& change, const Time& t) {
+                             return change.first < t;
+                           });
 }
 
 InterferenceHelper::NiChanges::iterator
@@ -625,10 +669,11 @@ InterferenceHelper::GetPreviousPosition (Time moment, NiChangesPerBand::iterator
   return it;
 }
 
-InterferenceHelper::NiChanges::iterator
+std::size_t
 InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change, NiChangesPerBand::iterator niIt)
 {
-  return niIt->second.insert (GetNextPosition (moment, niIt), std::make_pair (moment, change));
+  auto it = niIt->second.insert (GetNextPosition (moment, niIt), std::make_pair (moment, change));
+  return it - niIt->second.begin ();
 }
 
 void
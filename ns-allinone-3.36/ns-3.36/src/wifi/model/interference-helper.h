@@ -306,6 +306,16 @@ protected:
    * \return the success rate
    */
   double CalculatePayloadChunkSuccessRate (double snir, Time duration, const WifiTxVector& txVector, uint16_t staId = SU_STA_ID) const;
+  /**
+   * Return the number of bits in a payload chunk, as used for its success rate.
+   *
+   * \param duration the duration of the chunk
+   * \param rate the data rate of the payload (bit/s)
+   * \param nss the number of spatial streams of the payload
+   *
+   * \return the number of bits per spatial stream
+   */
+  static uint64_t GetPayloadChunkBits (Time duration, uint64_t rate, uint8_t nss);
 
 private:
   /**
@@ -348,9 +358,11 @@ private:
   };
 
   /**
-   * typedef for a multimap of NiChange
+   * NiChanges of a band, sorted by time. Changes at the same time are kept
+   * in insertion order. A flat vector keeps the few changes of a band
+   * contiguous and reuses its memory from one reception to the next.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::vector<std::pair<Time, NiChange> > NiChanges;
 
   /**
    * Map of NiChanges per band
@@ -427,6 +439,9 @@ private:
   NiChangesPerBand m_niChangesPerBand;                     //!< NI Changes for each band
   std::map <WifiSpectrumBand, double> m_firstPowerPerBand; //!< first power of each band in watts
   bool m_rxing;                                            //!< flag whether it is in receiving state
+  mutable std::vector<double> m_chunkSnrs;                 //!< SNR of the payload chunks, reused by CalculatePayloadPer
+  mutable std::vector<uint64_t> m_chunkBits;               //!< Bits of the payload chunks, reused by CalculatePayloadPer
+  mutable std::vector<double> m_chunkCsrs;                 //!< Success rate of the payload chunks, reused by CalculatePayloadPer
 
   /**
    * Returns an iterator to the first NiChange that is later than moment
@@ -436,6 +451,14 @@ private:
    * \returns an iterator to the list of NiChanges
    */
   NiChanges::iterator GetNextPosition (Time moment, NiChangesPerBand::iterator niIt);
+  /**
+   * Returns an iterator to the first NiChange that is not earlier than moment
+   *
+   * \param moment time to check from
+   * \param changes the NiChanges to search
+   * \returns an iterator to the list of NiChanges
+   */
+  static NiChanges::const_iterator GetFirstPosition (Time moment, const NiChanges &changes);
   /**
    * Returns an iterator to the last NiChange that is before than moment
    *
@@ -447,14 +470,15 @@ private:
 
   /**
    * Add NiChange to the list at the appropriate position and
-   * return the iterator of the new event.
+   * return the index of the new event. Iterators to the list are
+   * invalidated.
    *
    * \param moment time to check from
    * \param change the NiChange to add
    * \param niIt iterator of the band to check
-   * \returns the iterator of the new event
+   * \returns the index of the new event in the list
    */
-  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change, NiChangesPerBand::iterator niIt);
+  std::size_t AddNiChangeEvent (Time moment, NiChange change, NiChangesPerBand::iterator niIt);
 };
 
 } //namespace ns3
@@ -21,7 +21,10 @@
 
 #include <cmath>
 #include <bitset>
+#include <limits>
 #include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "nist-error-rate-model.h"
 #include "wifi-tx-vector.h"
 
@@ -38,11 +41,35 @@ NistErrorRateModel::GetTypeId (void)
     .SetParent<ErrorRateModel> ()
     .SetGroupName ("Wifi")
     .AddConstructor<NistErrorRateModel> ()
+    .AddAttribute ("Tabulated",
+                   "Whether the chunk success rates of the OFDM modes are interpolated "
+                   "from tables of the coded BER instead of being computed analytically.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NistErrorRateModel::m_tabulated),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TableStep",
+                   "The distance between two SNR values of the tables (dB).",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&NistErrorRateModel::m_tableStep),
+                   MakeDoubleChecker<double> (1e-4))
+    .AddAttribute ("TableMinSnr",
+                   "The lowest SNR of the tables (dB). Lower SNR values use the analytical model.",
+                   DoubleValue (-10),
+                   MakeDoubleAccessor (&NistErrorRateModel::m_tableMin),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("TableMaxSnr",
+                   "The highest SNR of the tables (dB). Higher SNR values use the analytical model.",
+                   DoubleValue (50),
+                   MakeDoubleAccessor (&NistErrorRateModel::m_tableMax),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 NistErrorRateModel::NistErrorRateModel ()
+  : m_tablesStep (0),
+    m_tablesMin (0),
+    m_tablesMax (0)
 {
 }
 
@@ -195,6 +222,107 @@ NistErrorRateModel::GetFecQamBer (uint16_t constellationSize, double snr, uint64
   return pms;
 }
 
+double
+NistErrorRateModel::GetCodedBer (uint16_t constellationSize, double snr, uint8_t bValue) const
+{
+  double ber;
+  if (constellationSize == 2)
+    {
+      ber = GetBpskBer (snr);
+    }
+  else if (constellationSize == 4)
+    {
+      ber = GetQpskBer (snr);
+    }
+  else
+    {
+      ber = GetQamBer (constellationSize, snr);
+    }
+  if (ber == 0.0)
+    {
+      return 0.0;
+    }
+  return std::min (CalculatePe (ber, bValue), 1.0);
+}
+
+const std::vector<double> &
+NistErrorRateModel::GetTable (WifiMode mode) const
+{
+  if (m_tablesStep != m_tableStep || m_tablesMin != m_tableMin || m_tablesMax != m_tableMax)
+    {
+      NS_ABORT_MSG_IF (m_tableMax <= m_tableMin, "TableMaxSnr must be above TableMinSnr");
+      m_tables.clear ();
+      m_tablesStep = m_tableStep;
+      m_tablesMin = m_tableMin;
+      m_tablesMax = m_tableMax;
+    }
+  TableKey key (mode.GetConstellationSize (), GetBValue (mode.GetCodeRate ()));
+  auto it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_FUNCTION (this << mode);
+  std::size_t size = static_cast<std::size_t> (std::ceil ((m_tableMax - m_tableMin) / m_tableStep)) + 1;
+  std::vector<double> table (size);
+  for (std::size_t i = 0; i < size; i++)
+    {
+      double pe = GetCodedBer (key.first, std::pow (10.0, (m_tableMin + i * m_tableStep) / 10.0), key.second);
+      // A finite bound keeps the interpolation free of infinities: exp (-700)
+      // makes every chunk succeed. Above 1/2, pe gets clamped at 1 and
+      // ln (-ln (1 - pe)) steepens, which does not interpolate well; these
+      // points are marked with NaN and use the analytical model
+      if (pe <= 0.0)
+        {
+          table[i] = -700;
+        }
+      else if (pe > 0.5)
+        {
+          table[i] = std::numeric_limits<double>::quiet_NaN ();
+        }
+      else
+        {
+          table[i] = std::max (std::log (-std::log1p (-pe)), -700.0);
+        }
+    }
+  return m_tables.insert ({key, std::move (table)}).first->second;
+}
+
+double
+NistErrorRateModel::GetTabulatedChunkSuccessRate (WifiMode mode, const std::vector<double> &table, double snr, uint64_t nbits) const
+{
+  // Written as a negated comparison so that NaN positions also fall back
+  double position = (10.0 * std::log10 (snr) - m_tableMin) / m_tableStep;
+  if (!(position >= 0 && position < table.size () - 1))
+    {
+      return GetAnalyticalChunkSuccessRate (mode, snr, nbits);
+    }
+  std::size_t i = static_cast<std::size_t> (position);
+  double entry = table[i] + (position - i) * (table[i + 1] - table[i]);
+  if (std::isnan (entry))
+    {
+      return GetAnalyticalChunkSuccessRate (mode, snr, nbits);
+    }
+  return std::exp (-static_cast<double> (nbits) * std::exp (entry));
+}
+
+double
+NistErrorRateModel::GetAnalyticalChunkSuccessRate (WifiMode mode, double snr, uint64_t nbits) const
+{
+  if (mode.GetConstellationSize () == 2)
+    {
+      return GetFecBpskBer (snr, nbits, GetBValue (mode.GetCodeRate ()));
+    }
+  else if (mode.GetConstellationSize () == 4)
+    {
+      return GetFecQpskBer (snr, nbits, GetBValue (mode.GetCodeRate ()));
+    }
+  else
+    {
+      return GetFecQamBer (mode.GetConstellationSize (), snr, nbits, GetBValue (mode.GetCodeRate ()));
+    }
+}
+
 uint8_t
 NistErrorRateModel::GetBValue (WifiCodeRate codeRate) const
 {
@@ -222,20 +350,35 @@ NistErrorRateModel::DoGetChunkSuccessRate (WifiMode mode, const WifiTxVector& tx
   NS_LOG_FUNCTION (this << mode << snr << nbits << +numRxAntennas << field << staId);
   if (mode.GetModulationClass () >= WIFI_MOD_CLASS_ERP_OFDM)
     {
-      if (mode.GetConstellationSize () == 2)
-        {
-          return GetFecBpskBer (snr, nbits, GetBValue (mode.GetCodeRate ()));
-        }
-      else if (mode.GetConstellationSize () == 4)
+      if (m_tabulated)
         {
-          return GetFecQpskBer (snr, nbits, GetBValue (mode.GetCodeRate ()));
+          return GetTabulatedChunkSuccessRate (mode, GetTable (mode), snr, nbits);
         }
-      else
+      return GetAnalyticalChunkSuccessRate (mode, snr, nbits);
+    }
+  return 0;
+}
+
+void
+NistErrorRateModel::DoGetChunkSuccessRates (WifiMode mode, const WifiTxVector& txVector, const std::vector<double> &snrs,
+                                            const std::vector<uint64_t> &nbits, std::vector<double> &csrs,
+                                            uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const
+{
+  NS_LOG_FUNCTION (this << mode << snrs.size () << +numRxAntennas << field << staId);
+  if (!m_tabulated || mode.GetModulationClass () < WIFI_MOD_CLASS_ERP_OFDM)
+    {
+      for (std::size_t i = 0; i < snrs.size (); i++)
         {
-          return GetFecQamBer (mode.GetConstellationSize (), snr, nbits, GetBValue (mode.GetCodeRate ()));
+          csrs[i] = DoGetChunkSuccessRate (mode, txVector, snrs[i], nbits[i], numRxAntennas, field, staId);
         }
+      return;
+    }
+  // The mode and its table are looked up once for all the chunks
+  const std::vector<double> &table = GetTable (mode);
+  for (std::size_t i = 0; i < snrs.size (); i++)
+    {
+      csrs[i] = GetTabulatedChunkSuccessRate (mode, table, snrs[i], nbits[i]);
     }
-  return 0;
 }
 
 } //namespace ns3
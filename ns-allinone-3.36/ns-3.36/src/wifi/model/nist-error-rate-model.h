@@ -23,6 +23,8 @@
 
 #include "error-rate-model.h"
 #include "wifi-mode.h"
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -33,6 +35,16 @@ namespace ns3 {
  * the model description and validation can be found in
  * http://www.nsnam.org/~pei/80211ofdm.pdf.  For DSSS modulations (802.11b),
  * the model uses the DsssErrorRateModel.
+ *
+ * With the Tabulated attribute, the coded bit error rate of every OFDM
+ * constellation and code rate is computed once, on a grid of SNR values
+ * spaced TableStep dB apart, the first time the combination is used. A
+ * table entry holds ln (-ln (1 - pe)) for the coded bit error rate pe, which
+ * varies smoothly with the SNR in dB even where pe spans hundreds of orders
+ * of magnitude, and is interpolated linearly between the grid points. The
+ * chunk success rate then follows as exp (-nbits * exp (entry)), without
+ * erfc, pow or the series of CalculatePe. SNR values outside the table, or
+ * low enough for pe to be above 1/2, use the analytical model.
  */
 class NistErrorRateModel : public ErrorRateModel
 {
@@ -49,6 +61,50 @@ public:
 private:
   double DoGetChunkSuccessRate (WifiMode mode, const WifiTxVector& txVector, double snr, uint64_t nbits,
                                 uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const override;
+  void DoGetChunkSuccessRates (WifiMode mode, const WifiTxVector& txVector, const std::vector<double> &snrs,
+                               const std::vector<uint64_t> &nbits, std::vector<double> &csrs,
+                               uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const override;
+  /**
+   * Return the coded BER of an OFDM mode, i.e. the pe of the chunk success
+   * rate (1 - pe)^nbits.
+   *
+   * \param constellationSize the constellation size (M)
+   * \param snr SNR ratio (in linear scale)
+   * \param bValue the bValue such that coding rate = bValue / (bValue + 1)
+   *
+   * \return the coded BER, at most 1
+   */
+  double GetCodedBer (uint16_t constellationSize, double snr, uint8_t bValue) const;
+  /**
+   * Return the table of an OFDM mode, computing it on first use.
+   *
+   * \param mode the Wi-Fi mode
+   *
+   * \return ln (-ln (1 - pe)) at every grid point, NaN where pe is above 1/2
+   */
+  const std::vector<double> & GetTable (WifiMode mode) const;
+  /**
+   * Return the success rate of a chunk from a table, or from the analytical
+   * model if the SNR is out of the table.
+   *
+   * \param mode the Wi-Fi mode of the table
+   * \param table the table of the mode
+   * \param snr SNR ratio (in linear scale)
+   * \param nbits the number of bits in the chunk
+   *
+   * \return the chunk success rate
+   */
+  double GetTabulatedChunkSuccessRate (WifiMode mode, const std::vector<double> &table, double snr, uint64_t nbits) const;
+  /**
+   * Return the success rate of a chunk from the analytical model.
+   *
+   * \param mode the Wi-Fi mode
+   * \param snr SNR ratio (in linear scale)
+   * \param nbits the number of bits in the chunk
+   *
+   * \return the chunk success rate
+   */
+  double GetAnalyticalChunkSuccessRate (WifiMode mode, double snr, uint64_t nbits) const;
   /**
    * Return the bValue such that coding rate = bValue / (bValue + 1).
    *
@@ -121,6 +177,18 @@ private:
    * \return BER of QAM for a given constellation size at the given SNR after applying FEC
    */
   double GetFecQamBer (uint16_t constellationSize, double snr, uint64_t nbits, uint8_t bValue) const;
+
+  bool m_tabulated;    //!< Whether the chunk success rates are computed from tables
+  double m_tableStep;  //!< Distance between two grid points of the tables (dB)
+  double m_tableMin;   //!< SNR of the first grid point of the tables (dB)
+  double m_tableMax;   //!< SNR of the last grid point of the tables (dB)
+
+  /// Key of a table: constellation size and bValue
+  typedef std::pair<uint16_t, uint8_t> TableKey;
+  mutable std::map<TableKey, std::vector<double> > m_tables; //!< Tables computed so far
+  mutable double m_tablesStep;  //!< m_tableStep when m_tables were computed
+  mutable double m_tablesMin;   //!< m_tableMin when m_tables were computed
+  mutable double m_tablesMax;   //!< m_tableMax when m_tables were computed
 };
 
 } //namespace ns3
@@ -702,7 +702,7 @@ public:
    *
    * \param threshold the receive sensitivity threshold in dBm
    */
-  void SetRxSensitivity (double threshold);
+  virtual void SetRxSensitivity (double threshold);
   /**
    * Return the receive sensitivity threshold (dBm).
    *
@@ -784,7 +784,7 @@ public:
    *
    * \param gain the reception gain in dB
    */
-  void SetRxGain (double gain);
+  virtual void SetRxGain (double gain);
   /**
    * Return the reception gain (dB).
    *
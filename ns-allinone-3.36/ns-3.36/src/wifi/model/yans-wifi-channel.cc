@@ -20,17 +20,24 @@
 
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
+#include "ns3/node-position-cache.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "wifi-utils.h"
 #include "wifi-ppdu.h"
 #include "wifi-psdu.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -53,11 +60,83 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SpatialIndexEnabled",
+                   "If true, receptions are only scheduled for the PHYs located within "
+                   "the maximum interference range of the sender. This requires "
+                   "deterministic propagation loss and delay models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_spatialIndexEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxRange",
+                   "The distance (m) beyond which a transmission cannot be sensed by any PHY. "
+                   "If 0, it is derived from the propagation loss model and the lowest "
+                   "RX sensitivity of the PHYs attached to this channel, which is only "
+                   "supported for a single Friis or LogDistance model.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("GridRefreshInterval",
+                   "If 0, the positions of all PHYs are read on every transmission and the "
+                   "culling is exact. Otherwise, the PHYs are kept in a uniform grid that "
+                   "is rebuilt at this interval and queried with a radius padded by "
+                   "MaxNodeSpeed.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&YansWifiChannel::m_gridRefreshInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxNodeSpeed",
+                   "Upper bound on the speed (m/s) of any node attached to this channel, "
+                   "used to pad grid queries when GridRefreshInterval is not 0.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxNodeSpeed),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FastLossEnabled",
+                   "If true and the propagation loss model is a single Friis, LogDistance or "
+                   "TwoRayGround model, the RX powers of a transmission are computed in one "
+                   "batch in closed form (within 1e-9 dB of the loss model). Otherwise, "
+                   "the loss model is called for every receiver.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_fastLossEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("DelayBucket",
+                   "If not 0, the receivers of a transmission whose propagation delays fall "
+                   "in the same bucket of this width are delivered by a single event at the "
+                   "smallest delay of the bucket, sharing one copy of the PPDU. The event "
+                   "runs in the context of the first receiver of the bucket, so batched "
+                   "delivery cannot be used with the distributed simulator.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&YansWifiChannel::m_delayBucket),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("SharedPpduEnabled",
+                   "If true, all the receivers of a transmission share a single copy of "
+                   "the PPDU instead of getting one copy each. Receivers must not modify "
+                   "the PPDU without copying it first.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_sharedPpduEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("PositionCacheEnabled",
+                   "If true, the sender and receiver positions used for culling and by the fast loss "
+                   "path are read from the NodePositionCache instead of the mobility model "
+                   "of each PHY. PHYs whose mobility model is not the one of their node "
+                   "are still read from their mobility model.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_positionCacheEnabled),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_spatialIndexEnabled (false),
+    m_maxRange (0.0),
+    m_maxNodeSpeed (0.0),
+    m_sharedPpduEnabled (false),
+    m_ppduCopies (0),
+    m_rxThresholdDbm (0.0),
+    m_rxThresholdValid (false),
+    m_gridCellSize (0.0),
+    m_gridValid (false),
+    m_fastLossEnabled (false),
+    m_positionCacheEnabled (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -82,44 +161,348 @@ YansWifiChannel::SetPropagationDelayModel (const Ptr<PropagationDelayModel> dela
   m_delay = delay;
 }
 
+void
+YansWifiChannel::NotifyRxThresholdChanged (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rxThresholdValid = false;
+}
+
 void
 YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const
 {
-  NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
+  DoSend (sender, ppdu, txPowerDbm, Time (0));
+}
+
+void
+YansWifiChannel::DoSend (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm,
+                         Time elapsed) const
+{
+  NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm << elapsed);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  std::vector<std::size_t> &candidates = m_candidates;
+  GetCandidateReceivers (sender, txPowerDbm, candidates);
+  bool fastLoss = m_fastLossEnabled && UpdateFastLoss ();
+  Vector senderPos;
+  // With a constant speed, the delay follows from the positions gathered for the fast path
+  Ptr<ConstantSpeedPropagationDelayModel> constantSpeed;
+  if (fastLoss)
+    {
+      senderPos = GetSenderPosition (sender);
+      constantSpeed = DynamicCast<ConstantSpeedPropagationDelayModel> (m_delay);
+      m_rxPositions.resize (candidates.size ());
+      m_rxPowersDbm.resize (candidates.size ());
+      for (std::size_t k = 0; k < candidates.size (); k++)
+        {
+          m_rxPositions[k] = GetPhyPosition (candidates[k]);
+        }
+      m_fastLoss.CalcRxPower (txPowerDbm, senderPos,
+                              m_rxPositions.data (), candidates.size (), m_rxPowersDbm.data ());
+    }
+  // Copy of the PPDU shared by all receivers, detached from the sender's PPDU
+  Ptr<WifiPpdu> shared;
+  if (m_sharedPpduEnabled && !candidates.empty ())
+    {
+      shared = ppdu->Copy ();
+      m_ppduCopies++;
+    }
+  auto copyPpdu = [&] ()
+    {
+      if (shared)
+        {
+          return shared;
+        }
+      m_ppduCopies++;
+      return ppdu->Copy ();
+    };
+
+  // Delays and candidate indices of the receivers of batched deliveries
+  m_rxDelays.clear ();
+  if (m_delayBucket.IsStrictlyPositive ())
+    {
+      m_rxPowersDbm.resize (candidates.size ());
+    }
+  for (std::size_t k = 0; k < candidates.size (); k++)
+    {
+      Ptr<YansWifiPhy> receiver = m_phyList[candidates[k]];
+      Time delay;
+      double rxPowerDbm;
+      if (fastLoss)
+        {
+          double distance = CalculateDistance (senderPos, m_rxPositions[k]);
+          delay = constantSpeed ? Seconds (distance / constantSpeed->GetSpeed ())
+                                : m_delay->GetDelay (senderMobility, receiver->GetMobility ());
+          rxPowerDbm = m_rxPowersDbm[k];
+          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                        "distance=" << distance << "m, delay=" << delay);
+        }
+      else
+        {
+          Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+          delay = m_delay->GetDelay (senderMobility, receiverMobility);
+          rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+        }
+      if (elapsed.IsStrictlyPositive ())
+        {
+          // The signal travelled while the PPDU was on its way to this channel
+          delay = Max (delay - elapsed, Time (0));
+        }
+      if (m_delayBucket.IsStrictlyPositive ())
+        {
+          m_rxPowersDbm[k] = rxPowerDbm;
+          m_rxDelays.push_back (std::make_pair (delay, k));
+          continue;
+        }
+      Ptr<WifiPpdu> copy = copyPpdu ();
+      Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+      uint32_t dstNode;
+      if (dstNetDevice == 0)
+        {
+          dstNode = 0xffffffff;
+        }
+      else
+        {
+          dstNode = dstNetDevice->GetNode ()->GetId ();
+        }
+
+      Simulator::ScheduleWithContext (dstNode,
+                                      delay, &YansWifiChannel::Receive,
+                                      receiver, copy, rxPowerDbm);
+    }
+
+  // The bucket grows with the delay, so sorting by delay and then by index
+  // groups the receivers by bucket, each in order of delay and index
+  std::sort (m_rxDelays.begin (), m_rxDelays.end ());
+  int64_t bucketWidth = m_delayBucket.GetTimeStep ();
+  for (std::size_t first = 0; first < m_rxDelays.size ();)
+    {
+      int64_t bucket = m_rxDelays[first].first.GetTimeStep () / bucketWidth;
+      std::size_t last = first + 1;
+      while (last < m_rxDelays.size () && m_rxDelays[last].first.GetTimeStep () / bucketWidth == bucket)
+        {
+          last++;
+        }
+      RxBatch batch;
+      batch.reserve (last - first);
+      for (std::size_t i = first; i < last; i++)
+        {
+          std::size_t k = m_rxDelays[i].second;
+          batch.push_back (std::make_pair (m_phyList[candidates[k]], m_rxPowersDbm[k]));
+        }
+      Ptr<NetDevice> dstNetDevice = batch.front ().first->GetDevice ();
+      uint32_t dstNode = dstNetDevice == 0 ? 0xffffffff : dstNetDevice->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode,
+                                      m_rxDelays[first].first, &YansWifiChannel::ReceiveBatch,
+                                      std::move (batch), copyPpdu ());
+      first = last;
+    }
+}
+
+uint64_t
+YansWifiChannel::GetPpduCopies (void) const
+{
+  return m_ppduCopies;
+}
+
+void
+YansWifiChannel::GetCandidateReceivers (Ptr<YansWifiPhy> sender, double txPowerDbm,
+                                        std::vector<std::size_t> &candidates) const
+{
+  NS_LOG_FUNCTION (this << sender << txPowerDbm);
+  candidates.clear ();
+  candidates.reserve (m_phyList.size ());
+  double range = m_spatialIndexEnabled ? GetMaxRange (txPowerDbm) : std::numeric_limits<double>::infinity ();
+  if (std::isinf (range))
     {
-      if (sender != (*i))
+      for (std::size_t i = 0; i < m_phyList.size (); i++)
         {
           //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (m_phyList[i] != sender && m_phyList[i]->GetChannelNumber () == sender->GetChannelNumber ())
+            {
+              candidates.push_back (i);
+            }
+        }
+      return;
+    }
+
+  Vector senderPos = GetSenderPosition (sender);
+  double rangeSquared = range * range;
+  if (m_gridRefreshInterval.IsZero ())
+    {
+      // Read every position at the current time, exactly as the loss model would
+      for (std::size_t i = 0; i < m_phyList.size (); i++)
+        {
+          if (m_phyList[i] == sender || m_phyList[i]->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
+          Vector pos = GetPhyPosition (i);
+          if (CalculateDistanceSquared (senderPos, pos) <= rangeSquared)
+            {
+              candidates.push_back (i);
+            }
+        }
+      return;
+    }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<WifiPpdu> copy = ppdu->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+  Time now = Simulator::Now ();
+  if (!m_gridValid || now - m_gridBuildTime >= m_gridRefreshInterval)
+    {
+      BuildGrid (range + m_maxNodeSpeed * m_gridRefreshInterval.GetSeconds ());
+    }
+  // Receivers may have moved away from their grid position since the last rebuild
+  double radius = range + m_maxNodeSpeed * (now - m_gridBuildTime).GetSeconds ();
+  double radiusSquared = radius * radius;
+  int64_t minX = static_cast<int64_t> (std::floor ((senderPos.x - radius) / m_gridCellSize));
+  int64_t maxX = static_cast<int64_t> (std::floor ((senderPos.x + radius) / m_gridCellSize));
+  int64_t minY = static_cast<int64_t> (std::floor ((senderPos.y - radius) / m_gridCellSize));
+  int64_t maxY = static_cast<int64_t> (std::floor ((senderPos.y + radius) / m_gridCellSize));
+  for (int64_t cx = minX; cx <= maxX; cx++)
+    {
+      for (int64_t cy = minY; cy <= maxY; cy++)
+        {
+          auto cell = m_grid.find (MakeCellKey (cx, cy));
+          if (cell == m_grid.end ())
             {
-              dstNode = 0xffffffff;
+              continue;
+            }
+          for (std::size_t i : cell->second)
+            {
+              if (m_phyList[i] == sender || m_phyList[i]->GetChannelNumber () != sender->GetChannelNumber ()
+                  || CalculateDistanceSquared (senderPos, m_gridPositions[i]) > radiusSquared)
+                {
+                  continue;
+                }
+              Vector pos = GetPhyPosition (i);
+              if (CalculateDistanceSquared (senderPos, pos) <= rangeSquared)
+                {
+                  candidates.push_back (i);
+                }
             }
-          else
+        }
+    }
+  std::sort (candidates.begin (), candidates.end ());
+}
+
+double
+YansWifiChannel::GetMaxRange (double txPowerDbm) const
+{
+  if (m_maxRange > 0)
+    {
+      return m_maxRange;
+    }
+  // Compiling picks up changes of the loss model and of its attributes
+  NS_ABORT_MSG_UNLESS (m_fastLoss.Compile (m_loss) && m_fastLoss.IsDistanceOnly (),
+                       "The maximum range can only be derived for a single Friis or LogDistance "
+                       "propagation loss model; set the MaxRange attribute of the channel");
+  if (!m_rxThresholdValid)
+    {
+      // Weakest signal that at least one PHY would still process
+      m_rxThresholdDbm = std::numeric_limits<double>::infinity ();
+      for (const auto &phy : m_phyList)
+        {
+          m_rxThresholdDbm = std::min (m_rxThresholdDbm, phy->GetRxSensitivity () - phy->GetRxGain ());
+        }
+      m_rxThresholdValid = true;
+    }
+  // The closed form agrees with the loss model to within 1e-9 dB, the
+  // margin keeps every receiver the loss model would let through
+  double range = m_fastLoss.GetMaxDistance (txPowerDbm - m_rxThresholdDbm + 1e-6);
+  NS_LOG_DEBUG ("Derived maximum range " << range << "m for txPower=" << txPowerDbm << "dbm");
+  return range;
+}
+
+void
+YansWifiChannel::BuildGrid (double cellSize) const
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  m_gridCellSize = cellSize;
+  m_gridBuildTime = Simulator::Now ();
+  m_grid.clear ();
+  m_gridPositions.resize (m_phyList.size ());
+  for (std::size_t i = 0; i < m_phyList.size (); i++)
+    {
+      m_gridPositions[i] = GetPhyPosition (i);
+      m_grid[GetCellKey (m_gridPositions[i].x, m_gridPositions[i].y)].push_back (i);
+    }
+  m_gridValid = true;
+}
+
+Vector
+YansWifiChannel::GetPhyPosition (std::size_t i) const
+{
+  if (!m_positionCacheEnabled)
+    {
+      return m_phyList[i]->GetMobility ()->GetPosition ();
+    }
+  if (m_phyNodeIds.size () != m_phyList.size ())
+    {
+      // Only PHYs moving with their node can be read from the cache
+      m_phyNodeIds.resize (m_phyList.size ());
+      for (std::size_t j = 0; j < m_phyList.size (); j++)
+        {
+          Ptr<NetDevice> device = m_phyList[j]->GetDevice ();
+          Ptr<Node> node = device ? device->GetNode () : 0;
+          m_phyNodeIds[j] = std::numeric_limits<uint32_t>::max ();
+          if (node && node->GetObject<MobilityModel> () == m_phyList[j]->GetMobility ())
             {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
+              m_phyNodeIds[j] = node->GetId ();
             }
+        }
+    }
+  if (m_phyNodeIds[i] == std::numeric_limits<uint32_t>::max ())
+    {
+      return m_phyList[i]->GetMobility ()->GetPosition ();
+    }
+  return NodePositionCache::Get ()->GetPosition (m_phyNodeIds[i]);
+}
+
+Vector
+YansWifiChannel::GetSenderPosition (Ptr<YansWifiPhy> sender) const
+{
+  if (m_positionCacheEnabled)
+    {
+      // A pointer scan is cheaper than the aggregation lookup needed to check the node
+      auto it = std::find (m_phyList.begin (), m_phyList.end (), sender);
+      if (it != m_phyList.end ())
+        {
+          return GetPhyPosition (it - m_phyList.begin ());
+        }
+    }
+  return sender->GetMobility ()->GetPosition ();
+}
+
+int64_t
+YansWifiChannel::GetCellKey (double x, double y) const
+{
+  return MakeCellKey (static_cast<int64_t> (std::floor (x / m_gridCellSize)),
+                      static_cast<int64_t> (std::floor (y / m_gridCellSize)));
+}
+
+int64_t
+YansWifiChannel::MakeCellKey (int64_t cx, int64_t cy)
+{
+  return static_cast<int64_t> ((static_cast<uint64_t> (cx) << 32) ^ (static_cast<uint64_t> (cy) & 0xffffffff));
+}
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm);
+bool
+YansWifiChannel::UpdateFastLoss (void) const
+{
+  // Compiling is cheap when the parameters did not change, and picks up
+  // attribute changes of the loss model
+  bool supported = m_fastLoss.Compile (m_loss);
+  if (m_fastLossModel != m_loss)
+    {
+      m_fastLossModel = m_loss;
+      if (!supported)
+        {
+          NS_LOG_WARN ("Propagation loss model not supported by the fast path, using CalcRxPower");
         }
     }
+  return supported;
 }
 
 void
@@ -138,6 +521,16 @@ YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<WifiPpdu> ppdu, double rxPow
   phy->StartReceivePreamble (ppdu, rxPowerW, ppdu->GetTxDuration ());
 }
 
+void
+YansWifiChannel::ReceiveBatch (const RxBatch &batch, Ptr<WifiPpdu> ppdu)
+{
+  NS_LOG_FUNCTION (batch.size () << ppdu);
+  for (const auto &receiver : batch)
+    {
+      Receive (receiver.first, ppdu, receiver.second);
+    }
+}
+
 std::size_t
 YansWifiChannel::GetNDevices (void) const
 {
@@ -155,6 +548,8 @@ YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  m_rxThresholdValid = false;
+  m_gridValid = false;
 }
 
 int64_t
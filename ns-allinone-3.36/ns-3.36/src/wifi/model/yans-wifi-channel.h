@@ -22,6 +22,10 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/fast-propagation-loss.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -41,6 +45,44 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * When the SpatialIndexEnabled attribute is set, Send only schedules a
+ * reception for the PHYs located within the maximum interference range of
+ * the sender. Signals from farther away are below the RX sensitivity of every
+ * receiver and would be discarded by Receive anyway, so the outcome is the
+ * same as with the exhaustive loop as long as the propagation loss and delay
+ * models are deterministic and the loss decreases monotonically with the
+ * distance. The range is either given by the MaxRange attribute or, for a
+ * single Friis or LogDistance loss model, derived from the model and the
+ * lowest RX sensitivity of the attached PHYs. The derived range follows
+ * later changes of the model and of the PHYs. Any other loss model, e.g.
+ * TwoRayGround whose loss depends on the antenna heights, requires MaxRange.
+ *
+ * When the FastLossEnabled attribute is set and the propagation loss model
+ * is supported by FastPropagationLoss, the RX power of all receivers of a
+ * transmission is computed in one batch from their positions instead of
+ * calling the loss model for every receiver. With a
+ * ConstantSpeedPropagationDelayModel, the delays are computed from the same
+ * positions, so the mobility models of the receivers are not used at all.
+ * The loss model is compiled again on every transmission whose parameters
+ * changed, e.g. through its attributes.
+ *
+ * When the DelayBucket attribute is not 0, the receivers of a transmission
+ * are grouped by their propagation delay divided by the bucket width. Each
+ * group is delivered by a single event, scheduled at the smallest delay of
+ * the group, that calls Receive for all its PHYs with one shared copy of the
+ * PPDU. Receptions are thus advanced by less than the bucket width. The event
+ * runs in the context of the first PHY of the group, so the other PHYs of the
+ * group start their reception under a foreign node context. This only
+ * matters for logging with the default simulator, but batched delivery must
+ * not be used with simulators that rely on the context to dispatch events,
+ * such as the distributed simulator.
+ *
+ * By default, every receiver gets its own copy of the PPDU. When the
+ * SharedPpduEnabled attribute is set, Send makes a single copy per
+ * transmission that is shared by all receivers. This is safe because the
+ * YANS receive path only reads the PPDU; a receiver that needs to modify it
+ * must Copy() it first. GetPpduCopies reports the number of copies made.
  */
 class YansWifiChannel : public Channel
 {
@@ -62,7 +104,7 @@ public:
    *
    * \param phy the YansWifiPhy to be added to the PHY list
    */
-  void Add (Ptr<YansWifiPhy> phy);
+  virtual void Add (Ptr<YansWifiPhy> phy);
 
   /**
    * \param loss the new propagation loss model.
@@ -73,6 +115,12 @@ public:
    */
   void SetPropagationDelayModel (const Ptr<PropagationDelayModel> delay);
 
+  /**
+   * Called by the attached PHYs when their RX sensitivity or RX gain
+   * changes, so that the maximum range is derived again.
+   */
+  void NotifyRxThresholdChanged (void);
+
   /**
    * \param sender the PHY object from which the packet is originating.
    * \param ppdu the PPDU to send
@@ -83,7 +131,12 @@ public:
    * attempts to deliver the PPDU to all other YansWifiPhy objects
    * on the channel (except for the sender).
    */
-  void Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
+  virtual void Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const;
+
+  /**
+   * \return the number of PPDU copies made by Send since the channel was created
+   */
+  uint64_t GetPpduCopies (void) const;
 
   /**
    * Assign a fixed random variable stream number to the random variables
@@ -96,6 +149,28 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+protected:
+  /**
+   * The range is derived if the MaxRange attribute is 0, which aborts unless
+   * the loss model only depends on the distance.
+   *
+   * \param txPowerDbm the TX power associated to the packet, in dBm
+   * \return the distance beyond which no PHY on this channel can sense the signal
+   */
+  double GetMaxRange (double txPowerDbm) const;
+  /**
+   * Deliver a PPDU whose transmission started \p elapsed ago, e.g. one
+   * forwarded by another rank. The propagation delay to each receiver is
+   * shortened by \p elapsed, and receivers the signal has already reached
+   * start receiving now.
+   *
+   * \param sender the PHY object from which the packet is originating.
+   * \param ppdu the PPDU to send
+   * \param txPowerDbm the TX power associated to the packet, in dBm
+   * \param elapsed the time since the start of the transmission
+   */
+  void DoSend (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm,
+               Time elapsed) const;
 
 private:
   /**
@@ -103,6 +178,59 @@ private:
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
 
+  /**
+   * The PHYs of a batched delivery with their RX power (dBm), in order of
+   * increasing propagation delay.
+   */
+  typedef std::vector<std::pair<Ptr<YansWifiPhy>, double> > RxBatch;
+
+  /**
+   * Get the indices (in m_phyList) of the PHYs that may sense a transmission
+   * of the given sender. The indices are returned in ascending order, so that
+   * receptions are scheduled in the same order as by the exhaustive loop.
+   *
+   * \param sender the PHY object from which the packet is originating
+   * \param txPowerDbm the TX power associated to the packet, in dBm
+   * \param candidates the vector to fill with the PHY indices
+   */
+  void GetCandidateReceivers (Ptr<YansWifiPhy> sender, double txPowerDbm,
+                              std::vector<std::size_t> &candidates) const;
+  /**
+   * Rebuild the uniform grid from the current positions of all PHYs.
+   *
+   * \param cellSize the edge length of a grid cell, in meters
+   */
+  void BuildGrid (double cellSize) const;
+  /**
+   * \param i the index of the PHY in m_phyList
+   * \return the current position of the PHY
+   */
+  Vector GetPhyPosition (std::size_t i) const;
+  /**
+   * \param sender the transmitting PHY
+   * \return the current position of the sender, read like GetPhyPosition
+   */
+  Vector GetSenderPosition (Ptr<YansWifiPhy> sender) const;
+  /**
+   * \param x the x coordinate, in meters
+   * \param y the y coordinate, in meters
+   * \return the key of the grid cell containing the given position
+   */
+  int64_t GetCellKey (double x, double y) const;
+  /**
+   * \param cx the cell index along the x axis
+   * \param cy the cell index along the y axis
+   * \return the key of the grid cell
+   */
+  static int64_t MakeCellKey (int64_t cx, int64_t cy);
+  /**
+   * Compile the propagation loss model for the fast path if it or its
+   * parameters changed.
+   *
+   * \return true if the fast path can be used with the current loss model
+   */
+  bool UpdateFastLoss (void) const;
+
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
@@ -113,10 +241,45 @@ private:
    * \param txPowerDbm the TX power associated to the packet being sent (dBm)
    */
   static void Receive (Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double txPowerDbm);
+  /**
+   * This method is scheduled by Send for each group of receivers when
+   * the DelayBucket attribute is not 0. The PPDU is shared by all the
+   * receivers of the group, which do not modify it.
+   *
+   * \param batch the receivers and their RX power
+   * \param ppdu the PPDU being sent
+   */
+  static void ReceiveBatch (const RxBatch &batch, Ptr<WifiPpdu> ppdu);
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+
+  bool m_spatialIndexEnabled;          //!< Whether receivers out of range are culled
+  double m_maxRange;                   //!< Configured maximum interference range (m), 0 to derive it
+  Time m_gridRefreshInterval;          //!< Interval between two grid rebuilds, 0 for exact culling
+  double m_maxNodeSpeed;               //!< Upper bound on the speed of any node (m/s)
+  Time m_delayBucket;                  //!< Width of the delay buckets of batched delivery, 0 to disable it
+  bool m_sharedPpduEnabled;            //!< Whether all receivers of a transmission share one PPDU copy
+  mutable uint64_t m_ppduCopies;       //!< Number of PPDU copies made by Send
+
+  mutable double m_rxThresholdDbm;                   //!< Weakest RX power (dBm) processed by any PHY
+  mutable bool m_rxThresholdValid;                   //!< Whether m_rxThresholdDbm matches the PHYs
+  mutable std::vector<Vector> m_gridPositions;       //!< Position of each PHY when the grid was built
+  mutable std::unordered_map<int64_t, std::vector<std::size_t> > m_grid; //!< PHY indices per grid cell
+  mutable double m_gridCellSize;                     //!< Edge length of a grid cell (m)
+  mutable Time m_gridBuildTime;                      //!< Time at which the grid was built
+  mutable bool m_gridValid;                          //!< Whether the grid matches the PHY list
+
+  bool m_fastLossEnabled;                            //!< Whether the RX power is computed by m_fastLoss
+  mutable FastPropagationLoss m_fastLoss;            //!< Closed-form evaluator of m_loss
+  mutable Ptr<PropagationLossModel> m_fastLossModel; //!< Loss model m_fastLoss was compiled from
+  mutable std::vector<Vector> m_rxPositions;         //!< Receiver positions of the current transmission
+  mutable std::vector<double> m_rxPowersDbm;         //!< RX powers of the current transmission (dBm)
+  mutable std::vector<std::size_t> m_candidates;     //!< PHY indices of the receivers of the current transmission
+  mutable std::vector<std::pair<Time, std::size_t> > m_rxDelays; //!< Delay and receiver index of each batched delivery
+  bool m_positionCacheEnabled;                       //!< Whether sender and receiver positions are read from the NodePositionCache
+  mutable std::vector<uint32_t> m_phyNodeIds;        //!< Node id of each PHY in the cache, or the maximum uint32_t
 };
 
 } //namespace ns3
@@ -78,6 +78,26 @@ YansWifiPhy::SetChannel (const Ptr<YansWifiChannel> channel)
   m_channel->Add (this);
 }
 
+void
+YansWifiPhy::SetRxSensitivity (double threshold)
+{
+  WifiPhy::SetRxSensitivity (threshold);
+  if (m_channel)
+    {
+      m_channel->NotifyRxThresholdChanged ();
+    }
+}
+
+void
+YansWifiPhy::SetRxGain (double gain)
+{
+  WifiPhy::SetRxGain (gain);
+  if (m_channel)
+    {
+      m_channel->NotifyRxThresholdChanged ();
+    }
+}
+
 void
 YansWifiPhy::StartTx (Ptr<WifiPpdu> ppdu)
 {
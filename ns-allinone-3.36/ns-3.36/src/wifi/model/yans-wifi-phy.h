@@ -61,6 +61,8 @@ public:
   Ptr<Channel> GetChannel (void) const override;
   uint16_t GetGuardBandwidth (uint16_t currentChannelWidth) const override;
   std::tuple<double, double, double> GetTxMaskRejectionParams (void) const override;
+  void SetRxSensitivity (double threshold) override;
+  void SetRxGain (double gain) override;
 
   /**
    * Set the YansWifiChannel this YansWifiPhy is to be connected to.
@@ -0,0 +1,473 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/nstime.h"
+#include "ns3/header.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/mobility-model.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/distributed-simulator-impl.h"
+#include "yans-wifi-remote-channel.h"
+#include "yans-wifi-phy.h"
+#include "wifi-net-device.h"
+#include "wifi-mac-header.h"
+#include "wifi-mac-queue-item.h"
+#include "wifi-ppdu.h"
+#include "wifi-psdu.h"
+#include "phy-entity.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("YansWifiRemoteChannel");
+
+namespace {
+
+/**
+ * \param i the buffer iterator to write to
+ * \param value the double to write in network byte order
+ */
+void
+WriteDouble (Buffer::Iterator &i, double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  i.WriteHtonU64 (bits);
+}
+
+/**
+ * \param i the buffer iterator to read from
+ * \return the double read in network byte order
+ */
+double
+ReadDouble (Buffer::Iterator &i)
+{
+  uint64_t bits = i.ReadNtohU64 ();
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup wifi
+ *
+ * Header of the messages sent by YansWifiRemoteChannel to the other ranks.
+ * It is followed by the MPDUs of the PPDU, each with its MAC header.
+ */
+class YansWifiRemotePpduHeader : public Header
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TypeId GetInstanceTypeId (void) const override;
+  void Print (std::ostream &os) const override;
+  uint32_t GetSerializedSize (void) const override;
+  void Serialize (Buffer::Iterator start) const override;
+  uint32_t Deserialize (Buffer::Iterator start) override;
+
+  uint32_t senderNodeId = 0;          //!< Node of the transmitting PHY
+  uint32_t senderIfIndex = 0;         //!< Interface index of the transmitting PHY
+  double txPowerDbm = 0;              //!< TX power (dBm)
+  Time txStart;                       //!< Start of the transmission
+  Vector senderPosition;              //!< Position of the sender at the start of the transmission
+  Vector senderVelocity;              //!< Velocity of the sender at the start of the transmission
+  Time duration;                      //!< Duration of the PPDU
+  std::string mode;                   //!< Unique name of the TXVECTOR mode
+  uint8_t preamble = 0;               //!< Preamble of the TXVECTOR
+  uint16_t channelWidth = 0;          //!< Channel width of the TXVECTOR (MHz)
+  uint16_t guardInterval = 0;         //!< Guard interval of the TXVECTOR (ns)
+  uint8_t nTx = 0;                    //!< Number of TX antennas of the TXVECTOR
+  uint8_t nss = 0;                    //!< Number of spatial streams of the TXVECTOR
+  uint8_t txPowerLevel = 0;           //!< TX power level of the TXVECTOR
+  bool aggregation = false;           //!< Whether the PSDU is an A-MPDU
+  bool single = false;                //!< Whether the PSDU is an S-MPDU
+  std::vector<uint32_t> mpduSizes;    //!< Size of each MPDU with its MAC header
+};
+
+NS_OBJECT_ENSURE_REGISTERED (YansWifiRemotePpduHeader);
+
+TypeId
+YansWifiRemotePpduHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::YansWifiRemotePpduHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<YansWifiRemotePpduHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+YansWifiRemotePpduHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+YansWifiRemotePpduHeader::Print (std::ostream &os) const
+{
+  os << "sender=" << senderNodeId << "/" << senderIfIndex
+     << " txPower=" << txPowerDbm << "dBm txStart=" << txStart
+     << " position=" << senderPosition << " duration=" << duration
+     << " mode=" << mode << " mpdus=" << mpduSizes.size ();
+}
+
+uint32_t
+YansWifiRemotePpduHeader::GetSerializedSize (void) const
+{
+  return 4 + 4 + 8 + 8 + 6 * 8 + 8 + 1 + mode.size () + 1 + 2 + 2 + 1 + 1 + 1 + 1 + 1
+         + 2 + 4 * mpduSizes.size ();
+}
+
+void
+YansWifiRemotePpduHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (senderNodeId);
+  i.WriteHtonU32 (senderIfIndex);
+  WriteDouble (i, txPowerDbm);
+  i.WriteHtonU64 (static_cast<uint64_t> (txStart.GetTimeStep ()));
+  for (const Vector *v : {&senderPosition, &senderVelocity})
+    {
+      WriteDouble (i, v->x);
+      WriteDouble (i, v->y);
+      WriteDouble (i, v->z);
+    }
+  i.WriteHtonU64 (static_cast<uint64_t> (duration.GetTimeStep ()));
+  i.WriteU8 (static_cast<uint8_t> (mode.size ()));
+  i.Write (reinterpret_cast<const uint8_t *> (mode.data ()), mode.size ());
+  i.WriteU8 (preamble);
+  i.WriteHtonU16 (channelWidth);
+  i.WriteHtonU16 (guardInterval);
+  i.WriteU8 (nTx);
+  i.WriteU8 (nss);
+  i.WriteU8 (txPowerLevel);
+  i.WriteU8 (aggregation ? 1 : 0);
+  i.WriteU8 (single ? 1 : 0);
+  i.WriteHtonU16 (static_cast<uint16_t> (mpduSizes.size ()));
+  for (uint32_t size : mpduSizes)
+    {
+      i.WriteHtonU32 (size);
+    }
+}
+
+uint32_t
+YansWifiRemotePpduHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  senderNodeId = i.ReadNtohU32 ();
+  senderIfIndex = i.ReadNtohU32 ();
+  txPowerDbm = ReadDouble (i);
+  txStart = TimeStep (i.ReadNtohU64 ());
+  for (Vector *v : {&senderPosition, &senderVelocity})
+    {
+      v->x = ReadDouble (i);
+      v->y = ReadDouble (i);
+      v->z = ReadDouble (i);
+    }
+  duration = TimeStep (i.ReadNtohU64 ());
+  mode.resize (i.ReadU8 ());
+  for (auto &c : mode)
+    {
+      c = static_cast<char> (i.ReadU8 ());
+    }
+  preamble = i.ReadU8 ();
+  channelWidth = i.ReadNtohU16 ();
+  guardInterval = i.ReadNtohU16 ();
+  nTx = i.ReadU8 ();
+  nss = i.ReadU8 ();
+  txPowerLevel = i.ReadU8 ();
+  aggregation = i.ReadU8 () != 0;
+  single = i.ReadU8 () != 0;
+  mpduSizes.resize (i.ReadNtohU16 ());
+  for (auto &size : mpduSizes)
+    {
+      size = i.ReadNtohU32 ();
+    }
+  return i.GetDistanceFrom (start);
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (YansWifiRemoteChannel);
+
+TypeId
+YansWifiRemoteChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::YansWifiRemoteChannel")
+    .SetParent<YansWifiChannel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<YansWifiRemoteChannel> ()
+    .AddAttribute ("RemoteLookahead",
+                   "The delay after the start of a transmission at which it is delivered "
+                   "to the other ranks. It bounds the lookahead of the distributed "
+                   "simulator, and must be set before the first PHY is added.",
+                   TimeValue (MicroSeconds (33)),
+                   MakeTimeAccessor (&YansWifiRemoteChannel::m_lookahead),
+                   MakeTimeChecker (NanoSeconds (1)))
+  ;
+  return tid;
+}
+
+YansWifiRemoteChannel::YansWifiRemoteChannel ()
+  : m_partitioned (false),
+    m_remoteSends (0),
+    m_remoteReceptions (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+YansWifiRemoteChannel::~YansWifiRemoteChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+YansWifiRemoteChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_addedPhys.clear ();
+  m_remoteRanks.clear ();
+  YansWifiChannel::DoDispose ();
+}
+
+void
+YansWifiRemoteChannel::Add (Ptr<YansWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  NS_ABORT_MSG_IF (m_partitioned, "PHYs cannot be added to a YansWifiRemoteChannel once the simulation started");
+  if (m_addedPhys.empty ())
+    {
+      if (MpiInterface::IsEnabled ())
+        {
+          Ptr<DistributedSimulatorImpl> impl = DynamicCast<DistributedSimulatorImpl> (Simulator::GetImplementation ());
+          NS_ABORT_MSG_UNLESS (impl, "YansWifiRemoteChannel requires the ns3::DistributedSimulatorImpl");
+          impl->BoundLookAhead (m_lookahead);
+        }
+      // The device of the PHY is not attached to its node yet
+      Simulator::ScheduleNow (&YansWifiRemoteChannel::Partition, this);
+    }
+  m_addedPhys.push_back (phy);
+}
+
+void
+YansWifiRemoteChannel::Partition (void)
+{
+  NS_LOG_FUNCTION (this);
+  bool distributed = MpiInterface::IsEnabled ();
+  uint32_t self = distributed ? MpiInterface::GetSystemId () : 0;
+  for (const auto &phy : m_addedPhys)
+    {
+      Ptr<NetDevice> device = phy->GetDevice ();
+      NS_ASSERT (device != 0);
+      uint32_t rank = device->GetNode ()->GetSystemId ();
+      if (!distributed || rank == self)
+        {
+          YansWifiChannel::Add (phy);
+          if (distributed)
+            {
+              Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+              receiver->SetReceiveCallback (MakeCallback (&YansWifiRemoteChannel::ReceiveRemote, this));
+              device->AggregateObject (receiver);
+            }
+          continue;
+        }
+      // Every rank adds the PHYs in the same order, so the first PHY of a
+      // rank designates the same device on the sending and receiving ranks
+      auto it = std::find_if (m_remoteRanks.begin (), m_remoteRanks.end (),
+                              [rank] (const RemoteRank &remote) { return remote.rank == rank; });
+      if (it == m_remoteRanks.end ())
+        {
+          m_remoteRanks.push_back ({rank, device->GetNode ()->GetId (), device->GetIfIndex (), {}});
+          it = m_remoteRanks.end () - 1;
+        }
+      it->phys.push_back (phy);
+    }
+  NS_LOG_DEBUG ("Rank " << self << ": " << GetNDevices () << " local PHYs, "
+                        << m_remoteRanks.size () << " remote ranks");
+  m_addedPhys.clear ();
+  m_partitioned = true;
+}
+
+bool
+YansWifiRemoteChannel::IsInRange (const RemoteRank &remote, Ptr<YansWifiPhy> sender,
+                                  const Vector &senderPos, double range)
+{
+  double rangeSquared = range * range;
+  for (const auto &phy : remote.phys)
+    {
+      if (phy->GetChannelNumber () == sender->GetChannelNumber ()
+          && (std::isinf (range)
+              || CalculateDistanceSquared (senderPos, phy->GetMobility ()->GetPosition ()) <= rangeSquared))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+YansWifiRemoteChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const
+{
+  NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
+  NS_ASSERT_MSG (m_partitioned, "Transmission before the PHYs were partitioned");
+  YansWifiChannel::Send (sender, ppdu, txPowerDbm);
+  if (m_remoteRanks.empty ())
+    {
+      return;
+    }
+
+  double range = GetMaxRange (txPowerDbm);
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  Vector senderPos = senderMobility->GetPosition ();
+  Ptr<Packet> message;
+  for (const auto &remote : m_remoteRanks)
+    {
+      if (!IsInRange (remote, sender, senderPos, range))
+        {
+          continue;
+        }
+      if (message == 0)
+        {
+          Ptr<const WifiPsdu> psdu = ppdu->GetPsdu ();
+          WifiTxVector txVector = ppdu->GetTxVector ();
+          NS_ABORT_MSG_IF (txVector.IsMu (), "MU PPDUs cannot be forwarded to other ranks");
+          YansWifiRemotePpduHeader header;
+          Ptr<NetDevice> device = sender->GetDevice ();
+          header.senderNodeId = device->GetNode ()->GetId ();
+          header.senderIfIndex = device->GetIfIndex ();
+          header.txPowerDbm = txPowerDbm;
+          header.txStart = Simulator::Now ();
+          header.senderPosition = senderPos;
+          header.senderVelocity = senderMobility->GetVelocity ();
+          header.duration = ppdu->GetTxDuration ();
+          header.mode = txVector.GetMode ().GetUniqueName ();
+          header.preamble = static_cast<uint8_t> (txVector.GetPreambleType ());
+          header.channelWidth = txVector.GetChannelWidth ();
+          header.guardInterval = txVector.GetGuardInterval ();
+          header.nTx = txVector.GetNTx ();
+          header.nss = txVector.GetNss ();
+          header.txPowerLevel = txVector.GetTxPowerLevel ();
+          header.aggregation = txVector.IsAggregation ();
+          header.single = psdu->IsSingle ();
+          message = Create<Packet> ();
+          for (std::size_t i = 0; i < psdu->GetNMpdus (); i++)
+            {
+              Ptr<Packet> mpdu = psdu->GetPayload (i)->Copy ();
+              mpdu->AddHeader (psdu->GetHeader (i));
+              header.mpduSizes.push_back (mpdu->GetSize ());
+              message->AddAtEnd (mpdu);
+            }
+          message->AddHeader (header);
+        }
+      // The message is serialized by SendPacket, so it can be sent again
+      MpiInterface::SendPacket (message, Simulator::Now () + m_lookahead, remote.nodeId, remote.ifIndex);
+      m_remoteSends++;
+    }
+}
+
+void
+YansWifiRemoteChannel::ReceiveRemote (Ptr<Packet> message)
+{
+  NS_LOG_FUNCTION (this << message);
+  m_remoteReceptions++;
+  YansWifiRemotePpduHeader header;
+  message->RemoveHeader (header);
+  NS_LOG_DEBUG ("Remote PPDU: " << header);
+
+  std::vector<Ptr<WifiMacQueueItem> > mpdus;
+  uint32_t offset = 0;
+  for (uint32_t size : header.mpduSizes)
+    {
+      Ptr<Packet> mpdu = message->CreateFragment (offset, size);
+      offset += size;
+      WifiMacHeader macHeader;
+      mpdu->RemoveHeader (macHeader);
+      mpdus.push_back (Create<WifiMacQueueItem> (mpdu, macHeader));
+    }
+  NS_ASSERT (!mpdus.empty ());
+  Ptr<WifiPsdu> psdu = mpdus.size () == 1 ? Create<WifiPsdu> (mpdus.front (), header.single)
+                                          : Create<WifiPsdu> (mpdus);
+
+  WifiTxVector txVector;
+  txVector.SetMode (WifiMode (header.mode));
+  txVector.SetPreambleType (static_cast<WifiPreamble> (header.preamble));
+  txVector.SetChannelWidth (header.channelWidth);
+  txVector.SetGuardInterval (header.guardInterval);
+  txVector.SetNTx (header.nTx);
+  txVector.SetNss (header.nss);
+  txVector.SetTxPowerLevel (header.txPowerLevel);
+  txVector.SetAggregation (header.aggregation);
+
+  // The local copy of the sender has the same configuration as the one
+  // transmitting on the other rank
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (
+    NodeList::GetNode (header.senderNodeId)->GetDevice (header.senderIfIndex));
+  NS_ASSERT (device != 0);
+  Ptr<YansWifiPhy> sender = DynamicCast<YansWifiPhy> (device->GetPhy ());
+  NS_ASSERT (sender != 0);
+
+  // Every rank replays the mobility of all nodes, so the local copy of the
+  // sender is where the sending rank had it, moved on since the start of the
+  // transmission. A change of direction in between moves it at most by the
+  // sum of both speeds.
+  Time elapsed = Simulator::Now () - header.txStart;
+  double dt = elapsed.GetSeconds ();
+  Ptr<MobilityModel> mobility = sender->GetMobility ();
+  Vector velocity = mobility->GetVelocity ();
+  Vector expected (header.senderPosition.x + header.senderVelocity.x * dt,
+                   header.senderPosition.y + header.senderVelocity.y * dt,
+                   header.senderPosition.z + header.senderVelocity.z * dt);
+  double tolerance = (header.senderVelocity.GetLength () + velocity.GetLength ()) * dt + 1e-3;
+  NS_ABORT_MSG_IF (CalculateDistance (expected, mobility->GetPosition ()) > tolerance,
+                   "Node " << header.senderNodeId << " is at " << mobility->GetPosition ()
+                   << " on this rank but was at " << header.senderPosition << " on the sending rank "
+                   << elapsed << " ago; the mobility must be replayed identically on all ranks");
+
+  WifiConstPsduMap psdus;
+  psdus.insert ({SU_STA_ID, psdu});
+  Ptr<WifiPpdu> ppdu = sender->GetPhyEntity (txVector.GetModulationClass ())
+    ->BuildPpdu (psdus, txVector, header.duration);
+  // The signal has travelled for the lookahead already, so the PHYs it
+  // has reached start receiving now instead of one propagation delay later
+  DoSend (sender, ppdu, header.txPowerDbm, elapsed);
+}
+
+uint64_t
+YansWifiRemoteChannel::GetRemoteSends (void) const
+{
+  return m_remoteSends;
+}
+
+uint64_t
+YansWifiRemoteChannel::GetRemoteReceptions (void) const
+{
+  return m_remoteReceptions;
+}
+
+} // namespace ns3
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef YANS_WIFI_REMOTE_CHANNEL_H
+#define YANS_WIFI_REMOTE_CHANNEL_H
+
+#include "yans-wifi-channel.h"
+#include "ns3/nstime.h"
+#include <vector>
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief a YansWifiChannel spanning the ranks of a distributed simulation.
+ * \ingroup wifi
+ *
+ * Every rank builds all the nodes and devices of the scenario, and each node
+ * is owned by the rank given by its system id, e.g. the tile of the area
+ * in which it starts. The channel only delivers transmissions itself to the
+ * PHYs of the nodes owned by the local rank. A transmission that may be
+ * sensed by a PHY owned by another rank, i.e. one within the maximum
+ * interference range of the sender, is forwarded to that rank as one MPI
+ * message holding the MPDUs, the TXVECTOR and the TX power of the PPDU.
+ * The receiving rank rebuilds the PPDU and delivers it to its own PHYs as
+ * if the local copy of the sender had transmitted it.
+ *
+ * The messages are delivered the RemoteLookahead after the start of the
+ * transmission, which bounds the lookahead of the distributed simulator. The
+ * default, a propagation delay over 300 m plus the duration of the 802.11p
+ * (10 MHz OFDM) preamble, lets the ranks advance in windows of about 33 us
+ * while the remote PHYs still detect the preamble. The propagation delay is
+ * not added again on the receiving rank: a remote PHY starts receiving at
+ * the later of the start of the transmission plus its propagation delay
+ * and the arrival of the message. A remote reception thus starts the
+ * lookahead minus the propagation delay later than it would locally; this
+ * is the price of the parallel execution, and it grows with the lookahead.
+ *
+ * The mobility models of the nodes that are not owned by the local rank
+ * are used to decide which ranks to forward to and to compute the RX power
+ * of the remote receptions, so they must follow the same trajectories on
+ * all ranks, e.g. by fixing their random streams. The messages carry the
+ * position and velocity of the sender, and the receiving rank aborts if its
+ * copy of the sender is elsewhere.
+ * Batched delivery (the DelayBucket attribute) cannot be used, as it
+ * runs receptions in foreign node contexts.
+ */
+class YansWifiRemoteChannel : public YansWifiChannel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  YansWifiRemoteChannel ();
+  virtual ~YansWifiRemoteChannel ();
+
+  /**
+   * Adds the given YansWifiPhy to the channel. The PHY is sorted into
+   * the local or the remote PHYs once its device is attached to its node,
+   * at the start of the simulation.
+   *
+   * \param phy the YansWifiPhy to be added
+   */
+  void Add (Ptr<YansWifiPhy> phy) override;
+
+  /**
+   * Deliver the PPDU to the local PHYs and forward it to the ranks owning
+   * a PHY within the maximum interference range of the sender.
+   *
+   * \param sender the PHY object from which the packet is originating.
+   * \param ppdu the PPDU to send
+   * \param txPowerDbm the TX power associated to the packet, in dBm
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const override;
+
+  /**
+   * \return the number of messages sent to other ranks
+   */
+  uint64_t GetRemoteSends (void) const;
+  /**
+   * \return the number of messages received from other ranks
+   */
+  uint64_t GetRemoteReceptions (void) const;
+
+private:
+  /// The PHYs owned by another rank, and the device the messages to it are addressed to
+  struct RemoteRank
+  {
+    uint32_t rank;                        //!< System id of the rank
+    uint32_t nodeId;                      //!< Node of the device receiving the messages
+    uint32_t ifIndex;                     //!< Interface index of the device receiving the messages
+    std::vector<Ptr<YansWifiPhy> > phys;  //!< PHYs owned by the rank
+  };
+
+  void DoDispose (void) override;
+  /**
+   * Sort the added PHYs into local and remote ones, and let the devices
+   * of the local ones receive the messages of the other ranks.
+   */
+  void Partition (void);
+  /**
+   * \param remote the rank to check
+   * \param sender the transmitting PHY
+   * \param senderPos the position of the sender
+   * \param range the maximum interference range of the transmission, in meters
+   * \return true if a PHY of the rank may sense the transmission
+   */
+  static bool IsInRange (const RemoteRank &remote, Ptr<YansWifiPhy> sender,
+                         const Vector &senderPos, double range);
+  /**
+   * Deliver a PPDU forwarded by another rank to the local PHYs.
+   *
+   * \param message the message built by Send
+   */
+  void ReceiveRemote (Ptr<Packet> message);
+
+  std::vector<Ptr<YansWifiPhy> > m_addedPhys; //!< PHYs added but not yet partitioned
+  std::vector<RemoteRank> m_remoteRanks;      //!< Other ranks owning PHYs on this channel
+  bool m_partitioned;                         //!< Whether Partition has run
+  Time m_lookahead;                           //!< Delay of the remote deliveries
+  mutable uint64_t m_remoteSends;             //!< Number of messages sent to other ranks
+  uint64_t m_remoteReceptions;                //!< Number of messages received from other ranks
+};
+
+} // namespace ns3
+
+#endif /* YANS_WIFI_REMOTE_CHANNEL_H */
@@ -21,6 +21,7 @@
 
 #include "ns3/log.h"
 #include "ns3/test.h"
+#include "ns3/boolean.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
@@ -296,6 +297,77 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Nist Tabulated
+ *
+ * Compare the chunk success rates interpolated in the tables of the
+ * NistErrorRateModel with the analytical ones, and the batch evaluation
+ * with the evaluation of every chunk.
+ */
+class WifiErrorRateModelsTestCaseNistTabulated : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseNistTabulated ();
+  virtual ~WifiErrorRateModelsTestCaseNistTabulated ();
+
+private:
+  void DoRun (void) override;
+};
+
+WifiErrorRateModelsTestCaseNistTabulated::WifiErrorRateModelsTestCaseNistTabulated ()
+  : TestCase ("WifiErrorRateModel test case NIST tabulated")
+{
+}
+
+WifiErrorRateModelsTestCaseNistTabulated::~WifiErrorRateModelsTestCaseNistTabulated ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseNistTabulated::DoRun (void)
+{
+  WifiTxVector txVector;
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<NistErrorRateModel> tabulated = CreateObject<NistErrorRateModel> ();
+  tabulated->SetAttribute ("Tabulated", BooleanValue (true));
+
+  const std::vector<std::string> modes {"OfdmRate6Mbps", "OfdmRate9Mbps", "OfdmRate12Mbps", "OfdmRate18Mbps",
+                                        "OfdmRate24Mbps", "OfdmRate36Mbps", "OfdmRate48Mbps", "OfdmRate54Mbps",
+                                        "OfdmRate3MbpsBW10MHz"};
+  const std::vector<uint64_t> sizes {1, 32 * 8, 2000 * 8};
+  for (const auto &name : modes)
+    {
+      WifiMode mode (name);
+      std::vector<double> snrs;
+      std::vector<uint64_t> nbits;
+      std::vector<double> expected;
+      // Include the SNRs outside of the table, which fall back to the analytical values
+      for (double snr = -12.0; snr <= 52.0; snr += 0.037)
+        {
+          for (uint64_t size : sizes)
+            {
+              snrs.push_back (std::pow (10.0, snr / 10.0));
+              nbits.push_back (size);
+              double ps = nist->GetChunkSuccessRate (mode, txVector, snrs.back (), size);
+              double tabulatedPs = tabulated->GetChunkSuccessRate (mode, txVector, snrs.back (), size);
+              NS_TEST_ASSERT_MSG_EQ_TOL (tabulatedPs, ps, 1e-4, "Tabulated " << name << " at " << snr << " dB for " << size << " bits");
+              expected.push_back (tabulatedPs);
+            }
+        }
+      std::vector<double> csrs;
+      tabulated->GetChunkSuccessRates (mode, txVector, snrs, nbits, csrs);
+      NS_TEST_ASSERT_MSG_EQ ((csrs == expected), true, "Batch evaluation differs for " << name);
+      nist->GetChunkSuccessRates (mode, txVector, snrs, nbits, csrs);
+      for (std::size_t i = 0; i < csrs.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (csrs[i], nist->GetChunkSuccessRate (mode, txVector, snrs[i], nbits[i]), "Batch evaluation differs for " << name);
+        }
+    }
+}
+
 class TestInterferenceHelper : public InterferenceHelper
 {
 public:
@@ -1544,6 +1616,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseNistTabulated, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseMimo, TestCase::QUICK);
   AddTestCase (new TableBasedErrorRateTestCase ("DefaultTableBasedHtMcs0-1458bytes", HtPhy::GetHtMcs0 (), 1458), TestCase::QUICK);
   AddTestCase (new TableBasedErrorRateTestCase ("DefaultTableBasedHtMcs0-32bytes", HtPhy::GetHtMcs0 (), 32), TestCase::QUICK);
@@ -52,6 +52,10 @@
 #include "ns3/frame-exchange-manager.h"
 #include "ns3/wifi-default-protection-manager.h"
 #include "ns3/wifi-default-ack-manager.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 
 using namespace ns3;
 
@@ -3139,6 +3143,314 @@ HeRuMcsDataRateTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "Data rate verification for RUs above 52-tone RU (included) failed");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Spatial index of YansWifiChannel
+ *
+ * Broadcast frames are exchanged between moving nodes spread over an area
+ * much larger than the communication range. The receptions observed at the
+ * PHYs must be identical whether or not the channel culls the receivers out
+ * of range, while the culled channel must schedule fewer events. The RX
+ * sensitivity of the PHYs and the loss model change during the run, so the
+ * derived range must follow them.
+ */
+class YansWifiChannelSpatialIndexTest : public TestCase
+{
+public:
+  YansWifiChannelSpatialIndexTest ();
+  void DoRun (void) override;
+
+private:
+  /**
+   * Run the scenario once
+   * \param spatialIndex whether the spatial index of the channel is enabled
+   * \param gridRefresh the grid refresh interval of the channel
+   * \param fastLoss whether the channel uses the closed-form propagation loss
+   * \param positionCache whether the channel reads the positions from the NodePositionCache
+   * \param delayBucket the delay bucket width of batched delivery, 0 to disable it
+   * \param eventCount set to the number of events executed
+   * \return the log of all receptions
+   */
+  std::vector<std::string> RunScenario (bool spatialIndex, Time gridRefresh, bool fastLoss, bool positionCache,
+                                        Time delayBucket, uint64_t &eventCount);
+  /**
+   * Callback invoked when a PHY starts receiving a PPDU
+   * \param context the context
+   * \param p the received packet
+   * \param rxPowersW the received power per channel band in watts
+   */
+  void RxBegin (std::string context, Ptr<const Packet> p, RxPowerWattPerChannelBand rxPowersW);
+  /**
+   * Callback invoked when a PHY successfully receives a PPDU
+   * \param context the context
+   * \param p the received packet
+   */
+  void RxEnd (std::string context, Ptr<const Packet> p);
+
+  std::vector<std::string> m_log; ///< log of the receptions
+};
+
+YansWifiChannelSpatialIndexTest::YansWifiChannelSpatialIndexTest ()
+  : TestCase ("Test the spatial index of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelSpatialIndexTest::RxBegin (std::string context, Ptr<const Packet> p, RxPowerWattPerChannelBand rxPowersW)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << context << " begin " << p->GetSize () << " " << rxPowersW.begin ()->second;
+  m_log.push_back (oss.str ());
+}
+
+void
+YansWifiChannelSpatialIndexTest::RxEnd (std::string context, Ptr<const Packet> p)
+{
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << context << " end " << p->GetSize ();
+  m_log.push_back (oss.str ());
+}
+
+std::vector<std::string>
+YansWifiChannelSpatialIndexTest::RunScenario (bool spatialIndex, Time gridRefresh, bool fastLoss, bool positionCache,
+                                              Time delayBucket, uint64_t &eventCount)
+{
+  m_log.clear ();
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  const uint32_t numNodes = 20;
+
+  NodeContainer nodes;
+  nodes.Create (numNodes);
+
+  YansWifiChannelHelper channelHelper;
+  channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  channelHelper.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (5.9e9));
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("SpatialIndexEnabled", BooleanValue (spatialIndex));
+  channel->SetAttribute ("GridRefreshInterval", TimeValue (gridRefresh));
+  channel->SetAttribute ("MaxNodeSpeed", DoubleValue (30));
+  channel->SetAttribute ("FastLossEnabled", BooleanValue (fastLoss));
+  channel->SetAttribute ("PositionCacheEnabled", BooleanValue (positionCache));
+  channel->SetAttribute ("DelayBucket", TimeValue (delayBucket));
+
+  YansWifiPhyHelper phy;
+  phy.Set ("RxSensitivity", DoubleValue (-75));
+  phy.Set ("ChannelWidth", UintegerValue (10));
+  phy.SetChannel (channel);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211p);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate3MbpsBW10MHz"),
+                                "ControlMode", StringValue ("OfdmRate3MbpsBW10MHz"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 100);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < numNodes; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector ((i * 733) % 2000, (i * 1291) % 2000, 0));
+      model->SetVelocity (Vector ((i % 5) * 6.0 - 12.0, (i % 3) * 10.0 - 10.0, 0));
+    }
+
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxBegin",
+                   MakeCallback (&YansWifiChannelSpatialIndexTest::RxBegin, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd",
+                   MakeCallback (&YansWifiChannelSpatialIndexTest::RxEnd, this));
+
+  for (uint32_t round = 0; round < 5; round++)
+    {
+      for (uint32_t i = 0; i < numNodes; i++)
+        {
+          Ptr<NetDevice> device = devices.Get (i);
+          Simulator::Schedule (Seconds (0.5 * round + 0.01 * i), [device] ()
+            {
+              device->Send (Create<Packet> (100), device->GetBroadcast (), 1);
+            });
+        }
+    }
+
+  // Change the inputs of the derived range once it has been used
+  Simulator::Schedule (Seconds (1.2), [] ()
+    {
+      Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/RxSensitivity", DoubleValue (-82));
+    });
+  Simulator::Schedule (Seconds (1.7), [channel] ()
+    {
+      Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+      loss->SetPathLossExponent (1.8);
+      channel->SetAttribute ("PropagationLossModel", PointerValue (loss));
+    });
+
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+  eventCount = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  return m_log;
+}
+
+void
+YansWifiChannelSpatialIndexTest::DoRun (void)
+{
+  uint64_t exhaustiveEvents;
+  uint64_t exactEvents;
+  uint64_t gridEvents;
+  uint64_t fastLossEvents;
+  uint64_t cachedEvents;
+  uint64_t batchedEvents;
+  std::vector<std::string> exhaustive = RunScenario (false, Seconds (0), false, false, Seconds (0), exhaustiveEvents);
+  std::vector<std::string> exact = RunScenario (true, Seconds (0), false, false, Seconds (0), exactEvents);
+  std::vector<std::string> grid = RunScenario (true, Seconds (1), false, false, Seconds (0), gridEvents);
+  std::vector<std::string> fastLoss = RunScenario (true, Seconds (1), true, false, Seconds (0), fastLossEvents);
+  std::vector<std::string> cached = RunScenario (true, Seconds (1), true, true, Seconds (0), cachedEvents);
+  std::vector<std::string> batched = RunScenario (false, Seconds (0), false, false, MicroSeconds (10), batchedEvents);
+
+  NS_TEST_ASSERT_MSG_GT (exhaustive.size (), 0, "No reception took place");
+  NS_TEST_EXPECT_MSG_EQ ((exact == exhaustive), true, "Exact culling changed the receptions");
+  NS_TEST_EXPECT_MSG_EQ ((grid == exhaustive), true, "Grid culling changed the receptions");
+  NS_TEST_EXPECT_MSG_EQ ((fastLoss == exhaustive), true, "Closed-form propagation loss changed the receptions");
+  NS_TEST_EXPECT_MSG_EQ ((cached == fastLoss), true, "Position cache changed the receptions");
+  NS_TEST_EXPECT_MSG_LT (exactEvents, exhaustiveEvents, "Exact culling did not reduce the number of events");
+  NS_TEST_EXPECT_MSG_EQ (gridEvents, exactEvents, "Grid culling did not schedule the same events");
+  NS_TEST_EXPECT_MSG_EQ (fastLossEvents, gridEvents, "Closed-form propagation loss changed the events");
+  NS_TEST_EXPECT_MSG_EQ (cachedEvents, fastLossEvents, "Position cache changed the events");
+
+  // Batched delivery advances the receptions by less than the bucket width
+  // but must not change which receptions take place
+  NS_TEST_EXPECT_MSG_LT (batchedEvents, exhaustiveEvents, "Batched delivery did not reduce the number of events");
+  NS_TEST_ASSERT_MSG_EQ (batched.size (), exhaustive.size (), "Batched delivery changed the number of receptions");
+  for (std::size_t i = 0; i < batched.size (); i++)
+    {
+      batched[i] = batched[i].substr (batched[i].find (' '));
+      exhaustive[i] = exhaustive[i].substr (exhaustive[i].find (' '));
+    }
+  std::sort (batched.begin (), batched.end ());
+  std::sort (exhaustive.begin (), exhaustive.end ());
+  NS_TEST_EXPECT_MSG_EQ ((batched == exhaustive), true, "Batched delivery changed the receptions");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Shared PPDU delivery of YansWifiChannel
+ *
+ * In a broadcast storm of 100 nodes, every node broadcasts one frame. With
+ * shared PPDUs, the channel must make one PPDU copy per transmission instead
+ * of one per receiver, without changing the receptions.
+ */
+class YansWifiChannelSharedPpduTest : public TestCase
+{
+public:
+  YansWifiChannelSharedPpduTest ();
+  void DoRun (void) override;
+
+private:
+  /**
+   * Run the broadcast storm once
+   * \param sharedPpdu whether the receivers share one PPDU copy
+   * \param ppduCopies set to the number of PPDU copies made by the channel
+   * \return the number of frames received successfully
+   */
+  uint32_t RunStorm (bool sharedPpdu, uint64_t &ppduCopies);
+  /**
+   * Callback invoked when a PHY successfully receives a PPDU
+   * \param p the received packet
+   */
+  void RxEnd (Ptr<const Packet> p);
+
+  uint32_t m_received; ///< number of frames received successfully
+};
+
+YansWifiChannelSharedPpduTest::YansWifiChannelSharedPpduTest ()
+  : TestCase ("Test the shared PPDU delivery of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelSharedPpduTest::RxEnd (Ptr<const Packet> p)
+{
+  m_received++;
+}
+
+uint32_t
+YansWifiChannelSharedPpduTest::RunStorm (bool sharedPpdu, uint64_t &ppduCopies)
+{
+  m_received = 0;
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  const uint32_t numNodes = 100;
+
+  NodeContainer nodes;
+  nodes.Create (numNodes);
+
+  YansWifiChannelHelper channelHelper;
+  channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  channelHelper.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (5.9e9));
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("SharedPpduEnabled", BooleanValue (sharedPpdu));
+
+  YansWifiPhyHelper phy;
+  phy.Set ("ChannelWidth", UintegerValue (10));
+  phy.SetChannel (channel);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211p);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate3MbpsBW10MHz"),
+                                "ControlMode", StringValue ("OfdmRate3MbpsBW10MHz"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 100);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (5),
+                                 "DeltaY", DoubleValue (5),
+                                 "GridWidth", UintegerValue (10));
+  mobility.Install (nodes);
+
+  for (uint32_t i = 0; i < numNodes; i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (i));
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&YansWifiChannelSharedPpduTest::RxEnd, this));
+      Simulator::Schedule (MilliSeconds (5 * i), [device] ()
+        {
+          device->Send (Create<Packet> (100), device->GetBroadcast (), 1);
+        });
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  ppduCopies = channel->GetPpduCopies ();
+  Simulator::Destroy ();
+  return m_received;
+}
+
+void
+YansWifiChannelSharedPpduTest::DoRun (void)
+{
+  uint64_t copies;
+  uint64_t sharedCopies;
+  uint32_t received = RunStorm (false, copies);
+  uint32_t sharedReceived = RunStorm (true, sharedCopies);
+
+  NS_TEST_ASSERT_MSG_GT (received, 0, "No reception took place");
+  NS_TEST_EXPECT_MSG_EQ (sharedReceived, received, "Shared PPDUs changed the receptions");
+  NS_TEST_EXPECT_MSG_EQ (sharedCopies, 100, "Expected one PPDU copy per transmission");
+  NS_TEST_EXPECT_MSG_EQ (copies, 100 * 99, "Expected one PPDU copy per receiver");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -3171,6 +3483,8 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new IdealRateManagerChannelWidthTest, TestCase::QUICK);
   AddTestCase (new IdealRateManagerMimoTest, TestCase::QUICK);
   AddTestCase (new HeRuMcsDataRateTestCase, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSpatialIndexTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSharedPpduTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
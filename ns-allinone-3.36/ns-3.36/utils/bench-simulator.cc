@@ -204,6 +204,7 @@ int main (int argc, char *argv[])
 {
 
   bool schedCal           = false;
+  bool schedDary          = false;
   bool schedHeap          = false;
   bool schedList          = false;
   bool schedMap           = true;
@@ -226,6 +227,7 @@ int main (int argc, char *argv[])
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("calrev", "reverse ordering in the CalendarScheduler", calRev);
+  cmd.AddValue ("dary",  "use DaryHeapScheduler",         schedDary);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
@@ -246,6 +248,10 @@ int main (int argc, char *argv[])
       factory.SetTypeId ("ns3::CalendarScheduler");
       factory.Set ("Reverse", BooleanValue (calRev));
     }
+  if (schedDary)
+    {
+      factory.SetTypeId ("ns3::DaryHeapScheduler");
+    }
   if (schedHeap)
     {
       factory.SetTypeId ("ns3::HeapScheduler");